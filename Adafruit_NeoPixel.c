@@ -38,9 +38,16 @@ Adafruit_NeoPixel *Adafruit_NeoPixel____init___n_p_t(uint16_t n, uint8_t p, neoP
 {
   Adafruit_NeoPixel *this = calloc(1, sizeof(Adafruit_NeoPixel));
   this->begun = false;
+  this->external = false;
   this->brightness = 0;
+  this->unscale = 0;
   this->pixels = NULL;
   this->endTime = 0;
+  this->windowBytes = 0;
+  this->windowGap = 0;
+  this->showCount = 0;
+  this->showRestarts = 0;
+  this->snapBuf = this->snapMap = NULL;
   Adafruit_NeoPixel__updateType_t(this, t);
   Adafruit_NeoPixel__updateLength_n(this, n);
   Adafruit_NeoPixel__setPin_p(this, p);
@@ -60,24 +67,32 @@ Adafruit_NeoPixel *Adafruit_NeoPixel____init__()
   this->is800KHz = true;
 #endif
   this->begun = false;
+  this->external = false;
   this->numLEDs = 0;
   this->numBytes = 0;
   this->pin = -1;
   this->brightness = 0;
+  this->unscale = 0;
   this->pixels = NULL;
   this->rOffset = 1;
   this->gOffset = 0;
   this->bOffset = 2;
   this->wOffset = 1;
   this->endTime = 0;
+  this->windowBytes = 0;
+  this->windowGap = 0;
+  this->showCount = 0;
+  this->showRestarts = 0;
+  this->snapBuf = this->snapMap = NULL;
   this->showing = false;
   return this;
 }
 
 void Adafruit_NeoPixel____del__(Adafruit_NeoPixel *this)
 {
-  if (this->pixels)
+  if (this->pixels && !this->external)
     free(this->pixels);
+  Adafruit_NeoPixel__freeSnapshot(this);
   if (this->pin >= 0)
     pinMode(this->pin, INPUT);
 }
@@ -94,8 +109,10 @@ void Adafruit_NeoPixel__begin(Adafruit_NeoPixel *this)
 
 void Adafruit_NeoPixel__updateLength_n(Adafruit_NeoPixel *this, uint16_t n)
 {
-  if (this->pixels)
+  if (this->pixels && !this->external)
     free(this->pixels); // Free existing data (if any)
+  this->external = false;
+  Adafruit_NeoPixel__freeSnapshot(this); // Wrong size now
 
   // Allocate new data -- note: ALL PIXELS ARE CLEARED
   this->numBytes = n * ((this->wOffset == this->rOffset) ? 3 : 4);
@@ -134,6 +151,128 @@ void Adafruit_NeoPixel__updateType_t(Adafruit_NeoPixel *this, neoPixelType t)
 
 // void Adafruit_NeoPixel__show(Adafruit_NeoPixel *this);
 
+// Allow interrupts to be serviced every 'bytes' bytes during show(),
+// provided the data line doesn't idle for more than 'maxGapMicros'.
+// See notes in Adafruit_NeoPixel.cpp.
+void Adafruit_NeoPixel__setInterruptWindow_b_g(Adafruit_NeoPixel *this, uint16_t bytes, uint8_t maxGapMicros)
+{
+  this->windowBytes = bytes;
+  this->windowGap = maxGapMicros;
+}
+
+uint32_t Adafruit_NeoPixel__getShowCount(Adafruit_NeoPixel *this)
+{
+  return this->showCount;
+}
+
+uint32_t Adafruit_NeoPixel__getShowRestarts(Adafruit_NeoPixel *this)
+{
+  return this->showRestarts;
+}
+
+void Adafruit_NeoPixel__resetShowStats(Adafruit_NeoPixel *this)
+{
+  this->showCount = this->showRestarts = 0;
+}
+
+// Use caller-owned memory as the pixel buffer.  See notes in
+// Adafruit_NeoPixel.cpp.
+void Adafruit_NeoPixel__setExternalBuffer_b(Adafruit_NeoPixel *this, uint8_t *buf)
+{
+  if (!buf)
+  {
+    if (this->external)
+    {
+      this->pixels = NULL;
+      Adafruit_NeoPixel__updateLength_n(this, this->numLEDs);
+    }
+    return;
+  }
+  if (this->pixels && !this->external)
+    free(this->pixels);
+  this->pixels = buf;
+  this->external = true;
+  Adafruit_NeoPixel__setDirty_f_n(this, 0, 0);
+}
+
+// Snapshot blocks covering 'count' pixels from 'first' ('count' of 0 =
+// to end of strip) have been written.
+void Adafruit_NeoPixel__setDirty_f_n(Adafruit_NeoPixel *this, uint16_t first, uint16_t count)
+{
+  if (!this->snapMap || (first >= this->numLEDs))
+    return;
+  if (!count || (count > (this->numLEDs - first)))
+    count = this->numLEDs - first;
+  uint16_t b = first >> NEO_SNAPSHOT_SHIFT,
+           last = (uint16_t)(first + count - 1) >> NEO_SNAPSHOT_SHIFT;
+  for (; b <= last; b++)
+    this->snapMap[b >> 3] |= 1 << (b & 7);
+}
+
+// Copy flagged blocks from 'src' to 'dst' and clear the flags.  See
+// notes in Adafruit_NeoPixel.cpp.
+static void copyBlocks(Adafruit_NeoPixel *this, uint8_t *dst, const uint8_t *src)
+{
+  uint16_t blockBytes = ((this->wOffset == this->rOffset) ? 3 : 4) << NEO_SNAPSHOT_SHIFT,
+           blocks = (this->numLEDs + (1 << NEO_SNAPSHOT_SHIFT) - 1) >> NEO_SNAPSHOT_SHIFT,
+           b = 0;
+
+  while (b < blocks)
+  {
+    if (!(this->snapMap[b >> 3] & (1 << (b & 7))))
+    {
+      b++;
+      continue;
+    }
+    uint16_t start = b;
+    while ((b < blocks) && (this->snapMap[b >> 3] & (1 << (b & 7))))
+      b++;
+    uint32_t from = (uint32_t)start * blockBytes,
+             to = (uint32_t)b * blockBytes;
+    if (to > this->numBytes)
+      to = this->numBytes;
+    memcpy(&dst[from], &src[from], to - from);
+  }
+  memset(this->snapMap, 0, (blocks + 7) >> 3);
+}
+
+// Save the pixel buffer for restore().  See notes in
+// Adafruit_NeoPixel.cpp.
+bool Adafruit_NeoPixel__snapshot(Adafruit_NeoPixel *this)
+{
+  if (!this->pixels)
+    return false;
+  if (!this->snapBuf)
+  {
+    uint16_t mapBytes = (((this->numLEDs + (1 << NEO_SNAPSHOT_SHIFT) - 1) >> NEO_SNAPSHOT_SHIFT) + 7) >> 3;
+    this->snapBuf = (uint8_t *)malloc(this->numBytes);
+    this->snapMap = (uint8_t *)malloc(mapBytes);
+    if (!this->snapBuf || !this->snapMap)
+    {
+      Adafruit_NeoPixel__freeSnapshot(this);
+      return false;
+    }
+    memcpy(this->snapBuf, this->pixels, this->numBytes);
+    memset(this->snapMap, 0, mapBytes);
+    return true;
+  }
+  copyBlocks(this, this->snapBuf, this->pixels);
+  return true;
+}
+
+void Adafruit_NeoPixel__restore(Adafruit_NeoPixel *this)
+{
+  if (this->snapBuf && this->pixels)
+    copyBlocks(this, this->pixels, this->snapBuf);
+}
+
+void Adafruit_NeoPixel__freeSnapshot(Adafruit_NeoPixel *this)
+{
+  free(this->snapBuf);
+  free(this->snapMap);
+  this->snapBuf = this->snapMap = NULL;
+}
+
 // Set the output pin number
 void Adafruit_NeoPixel__setPin_p(Adafruit_NeoPixel *this, uint8_t p)
 {
@@ -177,6 +316,7 @@ void Adafruit_NeoPixel__setPixelColor_n_r_g_b(Adafruit_NeoPixel *this,
     p[this->rOffset] = r; // R,G,B always stored
     p[this->gOffset] = g;
     p[this->bOffset] = b;
+    Adafruit_NeoPixel__setDirty_f_n(this, n, 1);
   }
 }
 
@@ -206,6 +346,7 @@ void Adafruit_NeoPixel__setPixelColor_n_r_g_b_w(Adafruit_NeoPixel *this,
     p[this->rOffset] = r; // Store R,G,B
     p[this->gOffset] = g;
     p[this->bOffset] = b;
+    Adafruit_NeoPixel__setDirty_f_n(this, n, 1);
   }
 }
 
@@ -237,6 +378,7 @@ void Adafruit_NeoPixel__setPixelColor_n_c(Adafruit_NeoPixel *this, uint16_t n, u
     p[this->rOffset] = r;
     p[this->gOffset] = g;
     p[this->bOffset] = b;
+    Adafruit_NeoPixel__setDirty_f_n(this, n, 1);
   }
 }
 
@@ -254,6 +396,118 @@ uint32_t Adafruit_NeoPixel____static__Color_r_g_b_w(uint8_t r, uint8_t g, uint8_
   return ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
+// Hue wheel for ColorHSV() and fillRainbow(): for each sixth of the
+// circle, a 2-bit code per channel (R in bits 5,4, G 3,2, B 1,0)
+// selecting a constant 0 or 255, or a ramp rising or falling across the
+// sector.  A table lookup in place of a branch per sector.
+#define HUE_ZERO 0
+#define HUE_FULL 1
+#define HUE_RISE 2
+#define HUE_FALL 3
+static const uint8_t _NeoPixelHueSectors[6] = {
+    (HUE_FULL << 4) | (HUE_RISE << 2) | HUE_ZERO, // Red to yellow
+    (HUE_FALL << 4) | (HUE_FULL << 2) | HUE_ZERO, // Yellow to green
+    (HUE_ZERO << 4) | (HUE_FULL << 2) | HUE_RISE, // Green to cyan
+    (HUE_ZERO << 4) | (HUE_FALL << 2) | HUE_FULL, // Cyan to blue
+    (HUE_RISE << 4) | (HUE_ZERO << 2) | HUE_FULL, // Blue to magenta
+    (HUE_FULL << 4) | (HUE_ZERO << 2) | HUE_FALL  // Magenta to red
+};
+
+// 8-bit gamma-correction table (gamma 2.6) for gamma8() and gamma32().
+static const uint8_t _NeoPixelGammaTable[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,
+    3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 5, 6, 6, 6, 6, 7,
+    7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 10, 11, 11, 11, 12, 12,
+    13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19, 20,
+    20, 21, 21, 22, 22, 23, 24, 24, 25, 25, 26, 27, 27, 28, 29, 29,
+    30, 31, 31, 32, 33, 34, 34, 35, 36, 37, 38, 38, 39, 40, 41, 42,
+    42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+    58, 59, 60, 61, 62, 63, 64, 65, 66, 68, 69, 70, 71, 72, 73, 75,
+    76, 77, 78, 80, 81, 82, 84, 85, 86, 88, 89, 90, 92, 93, 94, 96,
+    97, 99, 100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120,
+    122, 124, 125, 127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148,
+    150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180,
+    182, 184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+    218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255
+};
+
+// Integer-only HSV to RGB conversion into rgb[0..2].  'hue' spans the
+// full color wheel in 0-65535 (wrapping back to red), so hue steps can
+// simply be added and allowed to overflow.
+static void hsvToRGB(uint16_t hue, uint8_t sat, uint8_t val, uint8_t *rgb)
+{
+  uint32_t h6 = (uint32_t)hue * 6; // Bits 18-16 = sector, 15-8 = fraction
+  uint8_t code = _NeoPixelHueSectors[h6 >> 16],
+          ramp[4], i;
+  ramp[HUE_ZERO] = 0;
+  ramp[HUE_FULL] = 255;
+  ramp[HUE_RISE] = h6 >> 8;
+  ramp[HUE_FALL] = 255 - ramp[HUE_RISE];
+
+  // Saturation blends toward white, then value scales toward black.
+  // Adding 1 permits >>8 in place of /255 with an exact result at 255.
+  uint16_t s1 = sat + 1, v1 = val + 1;
+  uint8_t s2 = 255 - sat;
+  for (i = 0; i < 3; i++)
+  {
+    uint8_t c = ramp[(code >> (4 - i * 2)) & 3];
+    rgb[i] = ((((c * s1) >> 8) + s2) * v1) >> 8;
+  }
+}
+
+// Convert hue, saturation and value into a packed 32-bit RGB color.
+// See notes in Adafruit_NeoPixel.cpp.
+uint32_t Adafruit_NeoPixel____static__ColorHSV_h_s_v(uint16_t hue, uint8_t sat, uint8_t val)
+{
+  uint8_t rgb[3];
+  hsvToRGB(hue, sat, val, rgb);
+  return ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
+}
+
+uint8_t Adafruit_NeoPixel____static__gamma8_x(uint8_t x)
+{
+  return _NeoPixelGammaTable[x];
+}
+
+uint32_t Adafruit_NeoPixel____static__gamma32_x(uint32_t x)
+{
+  uint8_t *y = (uint8_t *)&x;
+  for (uint8_t i = 0; i < 4; i++)
+    y[i] = _NeoPixelGammaTable[y[i]];
+  return x;
+}
+
+void Adafruit_NeoPixel__fillRainbow_f_n_h_d_s_v_g(Adafruit_NeoPixel *this, uint16_t first, uint16_t count, uint16_t hue, uint16_t hueStep,
+                                                  uint8_t sat, uint8_t val, bool gammify)
+{
+  if (first >= this->numLEDs)
+    return;
+  if (!count || (count > (this->numLEDs - first)))
+    count = this->numLEDs - first;
+  Adafruit_NeoPixel__setDirty_f_n(this, first, count);
+
+  uint8_t bpp = (this->wOffset == this->rOffset) ? 3 : 4,
+          *p = &(this->pixels[first * bpp]), rgb[3], i;
+  for (; count--; hue += hueStep, p += bpp)
+  {
+    hsvToRGB(hue, sat, val, rgb);
+    for (i = 0; i < 3; i++)
+    {
+      if (gammify)
+        rgb[i] = _NeoPixelGammaTable[rgb[i]];
+      if (this->brightness) // See notes in setBrightness()
+        rgb[i] = (rgb[i] * this->brightness) >> 8;
+    }
+    if (bpp == 4)
+      p[this->wOffset] = 0;
+    p[this->rOffset] = rgb[0];
+    p[this->gOffset] = rgb[1];
+    p[this->bOffset] = rgb[2];
+  }
+}
+
 // Query color from previously-set pixel (returns packed 32-bit RGB value)
 uint32_t Adafruit_NeoPixel__getPixelColor_n(Adafruit_NeoPixel *this, uint16_t n)
 {
@@ -272,9 +526,10 @@ uint32_t Adafruit_NeoPixel__getPixelColor_n(Adafruit_NeoPixel *this, uint16_t n)
       // value used when setting the pixel color, but there will always be
       // some error -- those bits are simply gone.  Issue is most
       // pronounced at low brightness levels.
-      return (((uint32_t)(p[this->rOffset] << 8) / this->brightness) << 16) |
-             (((uint32_t)(p[this->gOffset] << 8) / this->brightness) << 8) |
-             ((uint32_t)(p[this->bOffset] << 8) / this->brightness);
+      uint32_t m = this->unscale; // (v << 8) / brightness as a multiply
+      return (((p[this->rOffset] * m) >> 16) << 16) |
+             (((p[this->gOffset] * m) >> 16) << 8) |
+             ((p[this->bOffset] * m) >> 16);
     }
     else
     {
@@ -289,10 +544,11 @@ uint32_t Adafruit_NeoPixel__getPixelColor_n(Adafruit_NeoPixel *this, uint16_t n)
     p = &(this->pixels[n * 4]);
     if (this->brightness)
     { // Return scaled color
-      return (((uint32_t)(p[this->wOffset] << 8) / this->brightness) << 24) |
-             (((uint32_t)(p[this->rOffset] << 8) / this->brightness) << 16) |
-             (((uint32_t)(p[this->gOffset] << 8) / this->brightness) << 8) |
-             ((uint32_t)(p[this->bOffset] << 8) / this->brightness);
+      uint32_t m = this->unscale;
+      return (((p[this->wOffset] * m) >> 16) << 24) |
+             (((p[this->rOffset] * m) >> 16) << 16) |
+             (((p[this->gOffset] * m) >> 16) << 8) |
+             ((p[this->bOffset] * m) >> 16);
     }
     else
     { // Return raw color
@@ -357,6 +613,11 @@ void Adafruit_NeoPixel__setBrightness(Adafruit_NeoPixel *this, uint8_t b)
       *ptr++ = (c * scale) >> 8;
     }
     this->brightness = newBrightness;
+    // For getPixelColor(), as in the C++ version
+    this->unscale = newBrightness ? (0xFFFFFFul / newBrightness + 1) : 0;
+    // Snapshot bytes were scaled to the old brightness, as in the C++ version
+    Adafruit_NeoPixel__freeSnapshot(this);
+    Adafruit_NeoPixel__setDirty_f_n(this, 0, 0);
   }
 }
 
@@ -369,6 +630,42 @@ uint8_t Adafruit_NeoPixel__getBrightness(Adafruit_NeoPixel *this)
 void Adafruit_NeoPixel__clear(Adafruit_NeoPixel *this)
 {
   memset(this->pixels, 0, this->numBytes);
+  Adafruit_NeoPixel__setDirty_f_n(this, 0, 0);
+}
+
+// Fill 'count' pixels starting at 'first' with one packed color ('count'
+// of 0 fills to the end of the strip).  See notes in Adafruit_NeoPixel.cpp.
+void Adafruit_NeoPixel__fill_c_f_n(Adafruit_NeoPixel *this, uint32_t c, uint16_t first, uint16_t count)
+{
+  if (first >= this->numLEDs)
+    return;
+  if (!count || (count > (this->numLEDs - first)))
+    count = this->numLEDs - first;
+  Adafruit_NeoPixel__setDirty_f_n(this, first, count);
+
+  uint8_t pix[4], *p, bpp = (this->wOffset == this->rOffset) ? 3 : 4,
+                      r = (uint8_t)(c >> 16),
+                      g = (uint8_t)(c >> 8),
+                      b = (uint8_t)c,
+                      w = (uint8_t)(c >> 24);
+  if (this->brightness)
+  { // See notes in setBrightness()
+    r = (r * this->brightness) >> 8;
+    g = (g * this->brightness) >> 8;
+    b = (b * this->brightness) >> 8;
+    w = (w * this->brightness) >> 8;
+  }
+  pix[this->wOffset] = w; // Overwritten by R if RGB-type strip
+  pix[this->rOffset] = r;
+  pix[this->gOffset] = g;
+  pix[this->bOffset] = b;
+
+  p = &(this->pixels[first * bpp]);
+  while (count--)
+  {
+    memcpy(p, pix, bpp);
+    p += bpp;
+  }
 }
 
 int8_t Adafruit_NeoPixel__getPin(Adafruit_NeoPixel *this)
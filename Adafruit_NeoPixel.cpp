@@ -32,15 +32,59 @@
   -------------------------------------------------------------------------*/
 
 #include "Adafruit_NeoPixel.h"
+#include "NeoPixelMath.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+
+// Color correction state (see setColorCorrection()), allocated only
+// while correction is in use
+struct neoCorrection
+{
+  int16_t matrix[16];   // 4x4, rows = output R,G,B,W; 8 fractional bits
+  uint8_t white[4];     // White point: output gain per channel (255 = 1)
+  uint8_t *frame;       // Corrected copy of the pixel buffer
+  uint16_t frameBytes;  // Size of 'frame'
+  uint8_t *(*apply)(Adafruit_NeoPixel &strip); // Fill 'frame', return it
+};
 
 // Constructor when length, pin and type are known at compile-time:
-Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, uint8_t p, neoPixelType t) : begun(false), brightness(0), pixels(NULL), endTime(0)
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, uint8_t p, neoPixelType t) : begun(false), dirty(true), external(false),
+#ifdef NEO_16BIT
+                                                                               wide(false),
+#endif
+                                                                               brightness(0), pixels(NULL), endTime(0),
+                                                                               windowBytes(0), windowGap(0), showCount(0), showRestarts(0), output(NULL),
+                                                                               snapBuf(NULL), snapMap(NULL), whiteMode(NEO_WHITE_OFF), correction(NULL), unscale(0)
 {
   updateType(t);
   updateLength(n);
   setPin(p);
 }
 
+// Constructor taking a pixel format descriptor, e.g. NEO_FORMAT_RGBWW.
+// An unsupported format falls back to NEO_GRB.
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, uint8_t p, const neoPixelFormat &f) : begun(false), dirty(true), external(false),
+#ifdef NEO_16BIT
+                                                                                         wide(false),
+#endif
+                                                                                         brightness(0), pixels(NULL), endTime(0),
+                                                                                         windowBytes(0), windowGap(0), showCount(0), showRestarts(0), output(NULL),
+                                                                                         snapBuf(NULL), snapMap(NULL), whiteMode(NEO_WHITE_OFF), correction(NULL), unscale(0)
+{
+  if (!updateFormat(f))
+    updateType(NEO_GRB + NEO_KHZ800);
+  updateLength(n);
+  setPin(p);
+}
+
 // via Michael Vogt/neophob: empty constructor is used when strand length
 // isn't known at compile-time; situations where program config might be
 // read from internal flash memory or an SD card, or arrive via serial
@@ -50,15 +94,23 @@ Adafruit_NeoPixel::Adafruit_NeoPixel() :
 #ifdef NEO_KHZ400
                                          is800KHz(true),
 #endif
-                                         begun(false), numLEDs(0), numBytes(0), pin(-1), brightness(0), pixels(NULL),
-                                         rOffset(1), gOffset(0), bOffset(2), wOffset(1), endTime(0)
+                                         begun(false), dirty(true), external(false),
+#ifdef NEO_16BIT
+                                         wide(false),
+#endif
+                                         numLEDs(0), numBytes(0), pin(-1), brightness(0), pixels(NULL),
+                                         rOffset(1), gOffset(0), bOffset(2), wOffset(1), w2Offset(1), endTime(0),
+                                         windowBytes(0), windowGap(0), showCount(0), showRestarts(0), output(NULL),
+                                         snapBuf(NULL), snapMap(NULL), whiteMode(NEO_WHITE_OFF), correction(NULL), unscale(0)
 {
 }
 
 Adafruit_NeoPixel::~Adafruit_NeoPixel()
 {
-  if (pixels)
+  if (pixels && !external)
     free(pixels);
+  freeSnapshot();
+  updateCorrection(NULL, NULL);
   if (pin >= 0)
     pinMode(pin, INPUT);
 }
@@ -70,20 +122,25 @@ void Adafruit_NeoPixel::begin(void)
     pinMode(pin, OUTPUT);
     digitalWrite(pin, LOW);
   }
+  if (output)
+    output->begin();
   begun = true;
 }
 
 void Adafruit_NeoPixel::updateLength(uint16_t n)
 {
-  if (pixels)
+  if (pixels && !external)
     free(pixels); // Free existing data (if any)
+  external = false;
+  freeSnapshot(); // Wrong size now
 
   // Allocate new data -- note: ALL PIXELS ARE CLEARED
-  numBytes = n * ((wOffset == rOffset) ? 3 : 4);
+  numBytes = n * pixelBytes();
   if ((pixels = (uint8_t *)malloc(numBytes)))
   {
     memset(pixels, 0, numBytes);
     numLEDs = n;
+    dirty = true;
   }
   else
   {
@@ -93,30 +150,82 @@ void Adafruit_NeoPixel::updateLength(uint16_t n)
 
 void Adafruit_NeoPixel::updateType(neoPixelType t)
 {
-  boolean oldThreeBytesPerPixel = (wOffset == rOffset); // false if RGBW
+  uint8_t oldBytesPerPixel = pixelBytes();
 
   wOffset = (t >> 6) & 0b11; // See notes in header file
   rOffset = (t >> 4) & 0b11; // regarding R/G/B/W offsets
   gOffset = (t >> 2) & 0b11;
   bOffset = t & 0b11;
+  w2Offset = rOffset; // No second white in packed types
 #ifdef NEO_KHZ400
-  is800KHz = (t < 256); // 400 KHz flag is 1<<8
+  is800KHz = !(t & NEO_KHZ400);
+#endif
+#ifdef NEO_16BIT
+  wide = (t & NEO_16BIT) != 0;
 #endif
 
   // If bytes-per-pixel has changed (and pixel data was previously
   // allocated), re-allocate to new size.  Will clear any data.
   if (pixels)
   {
-    boolean newThreeBytesPerPixel = (wOffset == rOffset);
-    if (newThreeBytesPerPixel != oldThreeBytesPerPixel)
+    if (pixelBytes() != oldBytesPerPixel)
       updateLength(numLEDs);
   }
 }
 
+// Set color order, channel count, depth and speed from a descriptor.
+// Returns false (and changes nothing) if the format isn't supported
+// here: it must have 3-5 distinct channel offsets, and 16-bit depth
+// and 400 KHz need NEO_16BIT and NEO_KHZ400 support.
+bool Adafruit_NeoPixel::updateFormat(const neoPixelFormat &f)
+{
+  uint8_t o[5] = {f.r, f.g, f.b, f.w, f.w2}, used = 0, i;
+
+  if ((f.channels < 3) || (f.channels > 5))
+    return false;
+  for (i = 0; i < f.channels; i++)
+  { // Each channel present needs its own slot
+    if ((o[i] >= f.channels) || (used & (1 << o[i])))
+      return false;
+    used |= 1 << o[i];
+  }
+#ifdef NEO_16BIT
+  if ((f.depth != 8) && (f.depth != 16))
+    return false;
+#else
+  if (f.depth != 8)
+    return false;
+#endif
+#ifdef NEO_KHZ400
+  if ((f.kHz != 800) && (f.kHz != 400))
+    return false;
+#else
+  if (f.kHz != 800)
+    return false;
+#endif
+
+  uint8_t oldBytesPerPixel = pixelBytes();
+  rOffset = f.r;
+  gOffset = f.g;
+  bOffset = f.b;
+  wOffset = (f.channels >= 4) ? f.w : f.r;
+  w2Offset = (f.channels == 5) ? f.w2 : f.r;
+#ifdef NEO_KHZ400
+  is800KHz = (f.kHz == 800);
+#endif
+#ifdef NEO_16BIT
+  wide = (f.depth == 16);
+#endif
+  if (pixels && (pixelBytes() != oldBytesPerPixel))
+    updateLength(numLEDs);
+  return true;
+}
+
 #ifdef ESP8266
 // ESP8266 show() is external to enforce ICACHE_RAM_ATTR execution
-extern "C" void ICACHE_RAM_ATTR espShow(
-    uint8_t pin, uint8_t *pixels, uint32_t numBytes, uint8_t type);
+extern "C" uint8_t ICACHE_RAM_ATTR espShow(
+    uint8_t pin, uint8_t *pixels, uint32_t numBytes, uint8_t type,
+    uint16_t windowBytes, uint8_t windowGap);
 #endif // ESP8266
 
 void Adafruit_NeoPixel::show(void)
@@ -125,6 +234,28 @@ void Adafruit_NeoPixel::show(void)
   if (!pixels)
     return;
 
+  // With color correction, the corrected copy is sent in place of the
+  // drawing buffer (swapped back at the end).  Done before the latch
+  // wait so the two overlap.
+  uint8_t *drawn = pixels;
+  if (correction)
+    pixels = correction->apply(*this);
+
+  if (output)
+  { // Alternative output handles its own timing
+    output->write(pixels, numBytes);
+    pixels = drawn;
+    endTime = micros();
+    showCount++;
+    dirty = false;
+    return;
+  }
+  if (pin < 0)
+  { // No pin set (e.g. a NeoPixelSegments canvas) -- nothing to issue
+    pixels = drawn;
+    return;
+  }
+
   // Data latch = 50+ microsecond pause in the output stream.  Rather than
   // put a delay at the end of the function, the ending time is noted and
   // the function will simply hold off (if needed) on issuing the
@@ -1589,7 +1720,7 @@ void Adafruit_NeoPixel::show(void)
 
 // END AVR ----------------------------------------------------------------
 
-#elif defined(__arm__)
+#elif defined(__arm__) && !defined(__linux__) // Linux hosts: use setOutput()
 
 // ARM MCUs -- Teensy 3.0, 3.1, LC, Arduino Due ---------------------------
 
@@ -1600,12 +1731,16 @@ void Adafruit_NeoPixel::show(void)
 #define CYCLES_400_T0H (F_CPU / 2000000)
 #define CYCLES_400_T1H (F_CPU / 833333)
 #define CYCLES_400 (F_CPU / 400000)
+#define CYCLES_LATCH (F_CPU / 20000) // 50us
 
   uint8_t *p = pixels,
           *end = p + numBytes, pix, mask;
   volatile uint8_t *set = portSetRegister(pin),
                    *clr = portClearRegister(pin);
-  uint32_t cyc;
+  uint32_t cyc, time0, time1, period, limit;
+  uint16_t window = windowBytes, // Bytes between interrupt windows (0=off)
+      chunk = window;            // Bytes left until next window
+  uint8_t tries = 0;
 
   ARM_DEMCR |= ARM_DEMCR_TRCENA;
   ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
@@ -1614,62 +1749,66 @@ void Adafruit_NeoPixel::show(void)
   if (is800KHz)
   {
 #endif
-    cyc = ARM_DWT_CYCCNT + CYCLES_800;
-    while (p < end)
-    {
-      pix = *p++;
-      for (mask = 0x80; mask; mask >>= 1)
-      {
-        while (ARM_DWT_CYCCNT - cyc < CYCLES_800)
-          ;
-        cyc = ARM_DWT_CYCCNT;
-        *set = 1;
-        if (pix & mask)
-        {
-          while (ARM_DWT_CYCCNT - cyc < CYCLES_800_T1H)
-            ;
-        }
-        else
-        {
-          while (ARM_DWT_CYCCNT - cyc < CYCLES_800_T0H)
-            ;
-        }
-        *clr = 1;
-      }
-    }
-    while (ARM_DWT_CYCCNT - cyc < CYCLES_800)
-      ;
+    time0 = CYCLES_800_T0H;
+    time1 = CYCLES_800_T1H;
+    period = CYCLES_800;
 #ifdef NEO_KHZ400
   }
   else
   { // 400 kHz bitstream
-    cyc = ARM_DWT_CYCCNT + CYCLES_400;
-    while (p < end)
+    time0 = CYCLES_400_T0H;
+    time1 = CYCLES_400_T1H;
+    period = CYCLES_400;
+  }
+#endif
+  // Longest tolerable low time between bytes before the strip may latch
+  limit = period + windowGap * (F_CPU / 1000000);
+
+  cyc = ARM_DWT_CYCCNT + period;
+  while (p < end)
+  {
+    pix = *p++;
+    for (mask = 0x80; mask; mask >>= 1)
     {
-      pix = *p++;
-      for (mask = 0x80; mask; mask >>= 1)
+      while (ARM_DWT_CYCCNT - cyc < period)
+        ;
+      cyc = ARM_DWT_CYCCNT;
+      *set = 1;
+      if (pix & mask)
       {
-        while (ARM_DWT_CYCCNT - cyc < CYCLES_400)
+        while (ARM_DWT_CYCCNT - cyc < time1)
           ;
-        cyc = ARM_DWT_CYCCNT;
-        *set = 1;
-        if (pix & mask)
-        {
-          while (ARM_DWT_CYCCNT - cyc < CYCLES_400_T1H)
-            ;
-        }
-        else
-        {
-          while (ARM_DWT_CYCCNT - cyc < CYCLES_400_T0H)
-            ;
-        }
-        *clr = 1;
       }
+      else
+      {
+        while (ARM_DWT_CYCCNT - cyc < time0)
+          ;
+      }
+      *clr = 1;
+    }
+    if (chunk && !--chunk && (p < end))
+    { // Interrupt window: let pending ISRs run while the line idles low
+      while (ARM_DWT_CYCCNT - cyc < period)
+        ;
+      interrupts();
+      noInterrupts();
+      if (ARM_DWT_CYCCNT - cyc > limit)
+      { // An ISR overran the gap; strip has (or may have) latched a
+        // partial frame.  Finish the latch and resend from the top.
+        interrupts();
+        while (ARM_DWT_CYCCNT - cyc < CYCLES_LATCH)
+          ;
+        noInterrupts();
+        p = pixels;
+        showRestarts++;
+        if (++tries >= NEO_MAX_RESTARTS)
+          window = 0; // Give up on windows for rest of frame
+      }
+      chunk = window;
     }
-    while (ARM_DWT_CYCCNT - cyc < CYCLES_400)
-      ;
   }
-#endif // NEO_KHZ400
+  while (ARM_DWT_CYCCNT - cyc < period)
+    ;
 
 #elif defined(__MKL26Z64__) // Teensy-LC
 
@@ -2015,10 +2154,12 @@ void Adafruit_NeoPixel::show(void)
 #define TIME_400_1 ((int)(1.20 * SCALE + 0.5) - (5 * INST))
 #define PERIOD_400 ((int)(2.50 * SCALE + 0.5) - (5 * INST))
 
-  int pinMask, time0, time1, period, t;
+  int pinMask, time0, time1, period, t, limit;
   Pio *port;
   volatile WoReg *portSet, *portClear, *timeValue, *timeReset;
-  uint8_t *p, *end, pix, mask;
+  uint8_t *p, *end, pix, mask, tries = 0;
+  uint16_t window = windowBytes, // Bytes between interrupt windows (0=off)
+      chunk = window;            // Bytes left until next window
 
   pmc_set_writeprotect(false);
   pmc_enable_periph_clk((uint32_t)TC3_IRQn);
@@ -2053,6 +2194,8 @@ void Adafruit_NeoPixel::show(void)
     period = PERIOD_400;
   }
 #endif
+  // Timer ticks since last bit start before the strip may latch
+  limit = period + windowGap * (int)(SCALE);
 
   for (t = time0;; t = time0)
   {
@@ -2069,6 +2212,25 @@ void Adafruit_NeoPixel::show(void)
     { // This 'inside-out' loop logic utilizes
       if (p >= end)
         break; // idle time to minimize inter-byte delays.
+      if (chunk && !--chunk)
+      { // Interrupt window (see notes in Teensy 3.x code above)
+        while (*timeValue < period)
+          ;
+        interrupts();
+        noInterrupts();
+        if ((int)*timeValue > limit)
+        {
+          interrupts();
+          while (*timeValue < 50 * (SCALE))
+            ;
+          noInterrupts();
+          p = pixels;
+          showRestarts++;
+          if (++tries >= NEO_MAX_RESTARTS)
+            window = 0;
+        }
+        chunk = window;
+      }
       pix = *p++;
       mask = 0x80;
     }
@@ -2086,7 +2248,8 @@ void Adafruit_NeoPixel::show(void)
   // ESP8266 ----------------------------------------------------------------
 
   // ESP8266 show() is external to enforce ICACHE_RAM_ATTR execution
-  espShow(pin, pixels, numBytes, is800KHz);
+  showRestarts += espShow(pin, pixels, numBytes, is800KHz,
+                          windowBytes, windowGap);
 
 #elif defined(__ARDUINO_ARC__)
 
@@ -2204,7 +2367,154 @@ void Adafruit_NeoPixel::show(void)
   // END ARCHITECTURE SELECT ------------------------------------------------
 
   interrupts();
+  pixels = drawn;
   endTime = micros(); // Save EOD time for latch on next call
+  showCount++;
+  dirty = false;
+}
+
+// Allow interrupts to be serviced every 'bytes' bytes during show(),
+// provided the data line doesn't idle for more than 'maxGapMicros'
+// (WS2812B parts may latch after as little as ~6 uS low).  A frame
+// that overruns is restarted; getShowRestarts() counts these.  Pass 0
+// for 'bytes' to restore the default of one uninterrupted frame.
+// Only effective on Teensy 3.x, Due and ESP8266; ignored elsewhere.
+void Adafruit_NeoPixel::setInterruptWindow(uint16_t bytes, uint8_t maxGapMicros)
+{
+  windowBytes = bytes;
+  windowGap = maxGapMicros;
+}
+
+void Adafruit_NeoPixel::resetShowStats(void)
+{
+  showCount = showRestarts = 0;
+}
+
+// Use caller-owned memory of numBytes bytes as the pixel buffer in
+// place of the strip's own, e.g. to show frames from a memory-mapped
+// file without copying.  Data is in device color order with brightness
+// already applied, as getPixels() would hold.  The strip reads and (if
+// drawn on) writes it in place, but never frees it.  Pass NULL to go
+// back to an internal buffer, which is cleared.  updateLength() (or
+// updateType() changing bytes per pixel) also reverts to one.
+void Adafruit_NeoPixel::setExternalBuffer(uint8_t *buf)
+{
+  if (!buf)
+  {
+    if (external)
+    {
+      pixels = NULL;
+      updateLength(numLEDs);
+    }
+    return;
+  }
+  if (pixels && !external)
+    free(pixels);
+  pixels = buf;
+  external = true;
+  setDirty(); // Restore (if snapshot held) must copy everything
+}
+
+// Save the pixel buffer so it can be drawn over and later put back
+// with restore(), e.g. for a notification overlay.  The first call
+// copies the whole buffer (and allocates a second one plus 1 bit per
+// NEO_SNAPSHOT_SHIFT block of pixels to track writes); after that,
+// snapshot() and restore() copy only the blocks written since the
+// previous either.  Writes that bypass setPixelColor(), fill() etc.
+// must call setDirty() for the range written.  Returns false if
+// there isn't RAM for the copy.
+bool Adafruit_NeoPixel::snapshot(void)
+{
+  if (!pixels)
+    return false;
+  if (!snapBuf)
+  {
+    uint16_t mapBytes = (((numLEDs + (1 << NEO_SNAPSHOT_SHIFT) - 1) >> NEO_SNAPSHOT_SHIFT) + 7) >> 3;
+    snapBuf = (uint8_t *)malloc(numBytes);
+    snapMap = (uint8_t *)malloc(mapBytes);
+    if (!snapBuf || !snapMap)
+    {
+      freeSnapshot();
+      return false;
+    }
+    memcpy(snapBuf, pixels, numBytes);
+    memset(snapMap, 0, mapBytes);
+    return true;
+  }
+  copyBlocks(snapBuf, pixels);
+  return true;
+}
+
+// Put back pixels changed since the last snapshot().  The snapshot is
+// kept, so an overlay can be drawn and restored repeatedly, until
+// setBrightness() changes the brightness or updateLength() the length;
+// either drops it, so take a new one afterward.
+void Adafruit_NeoPixel::restore(void)
+{
+  if (snapBuf && pixels)
+    copyBlocks(pixels, snapBuf);
+}
+
+void Adafruit_NeoPixel::freeSnapshot(void)
+{
+  free(snapBuf);
+  free(snapMap);
+  snapBuf = snapMap = NULL;
+}
+
+// Flag the snapshot blocks covering 'count' pixels from 'first' ('count'
+// of 0 = to end of strip) as written.
+void Adafruit_NeoPixel::markSnapshot(uint16_t first, uint16_t count)
+{
+  if (first >= numLEDs)
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+  uint16_t b = first >> NEO_SNAPSHOT_SHIFT,
+           last = (uint16_t)(first + count - 1) >> NEO_SNAPSHOT_SHIFT;
+  for (; (b <= last) && (b & 7); b++) // Up to a byte boundary...
+    snapMap[b >> 3] |= 1 << (b & 7);
+  for (; (b + 7) <= last; b += 8) // ...whole bytes...
+    snapMap[b >> 3] = 0xFF;
+  for (; b <= last; b++) // ...and the remainder
+    snapMap[b >> 3] |= 1 << (b & 7);
+}
+
+// Copy the flagged blocks from 'src' to 'dst' (each numBytes long),
+// merging consecutive blocks into one memcpy(), and clear the flags:
+// the two buffers then match.
+void Adafruit_NeoPixel::copyBlocks(uint8_t *dst, const uint8_t *src)
+{
+  uint16_t blockBytes = pixelBytes() << NEO_SNAPSHOT_SHIFT,
+           blocks = (numLEDs + (1 << NEO_SNAPSHOT_SHIFT) - 1) >> NEO_SNAPSHOT_SHIFT,
+           b = 0;
+  bool copied = false;
+
+  while (b < blocks)
+  {
+    if (!(b & 7) && !snapMap[b >> 3])
+    {
+      b += 8; // 8 clean blocks at once
+      continue;
+    }
+    if (!(snapMap[b >> 3] & (1 << (b & 7))))
+    {
+      b++;
+      continue;
+    }
+    uint16_t start = b;
+    while ((b < blocks) && (snapMap[b >> 3] & (1 << (b & 7))))
+      b++;
+    uint32_t from = (uint32_t)start * blockBytes,
+             to = (uint32_t)b * blockBytes;
+    if (to > numBytes)
+      to = numBytes; // Last block may be partial
+    memcpy(&dst[from], &src[from], to - from);
+    copied = true;
+  }
+  memset(snapMap, 0, (blocks + 7) >> 3);
+  if (copied && (dst == pixels))
+    dirty = true;
 }
 
 // Set the output pin number
@@ -2231,25 +2541,38 @@ void Adafruit_NeoPixel::setPixelColor(
 
   if (n < numLEDs)
   {
+#ifdef NEO_16BIT
+    if (wide)
+    {
+      setPixelColor16(n, r * 257, g * 257, b * 257);
+      return;
+    }
+#endif
+    uint8_t *p, w = 0;
+    if ((wOffset != rOffset) && whiteMode)
+      w = splitWhite(r, g, b); // Before brightness, as with setPixels()
     if (brightness)
     { // See notes in setBrightness()
       r = (r * brightness) >> 8;
       g = (g * brightness) >> 8;
       b = (b * brightness) >> 8;
+      w = (w * brightness) >> 8;
     }
-    uint8_t *p;
     if (wOffset == rOffset)
     {                     // Is an RGB-type strip
       p = &pixels[n * 3]; // 3 bytes per pixel
     }
     else
-    {                     // Is a WRGB-type strip
-      p = &pixels[n * 4]; // 4 bytes per pixel
-      p[wOffset] = 0;     // But only R,G,B passed -- set W to 0
+    {                                // Is a WRGB-type strip
+      p = &pixels[n * pixelBytes()]; // 4 bytes per pixel (5 if RGBWW)
+      p[w2Offset] = 0;               // Overwritten by R if no 2nd white
+      p[wOffset] = w;                // Only R,G,B passed -- W is 0 unless extracted
     }
     p[rOffset] = r; // R,G,B always stored
     p[gOffset] = g;
     p[bOffset] = b;
+    dirty = true;
+    markPixel(n);
   }
 }
 
@@ -2259,6 +2582,13 @@ void Adafruit_NeoPixel::setPixelColor(
 
   if (n < numLEDs)
   {
+#ifdef NEO_16BIT
+    if (wide)
+    {
+      setPixelColor16(n, r * 257, g * 257, b * 257, w * 257);
+      return;
+    }
+#endif
     if (brightness)
     { // See notes in setBrightness()
       r = (r * brightness) >> 8;
@@ -2272,46 +2602,164 @@ void Adafruit_NeoPixel::setPixelColor(
       p = &pixels[n * 3]; // 3 bytes per pixel (ignore W)
     }
     else
-    {                     // Is a WRGB-type strip
-      p = &pixels[n * 4]; // 4 bytes per pixel
-      p[wOffset] = w;     // Store W
+    {                                // Is a WRGB-type strip
+      p = &pixels[n * pixelBytes()]; // 4 bytes per pixel (5 if RGBWW)
+      p[w2Offset] = 0;               // Overwritten by R if no 2nd white
+      p[wOffset] = w;                // Store W
     }
     p[rOffset] = r; // Store R,G,B
     p[gOffset] = g;
     p[bOffset] = b;
+    dirty = true;
+    markPixel(n);
   }
 }
 
-// Set pixel color from 'packed' 32-bit RGB color:
-void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c)
+// Set all five channels of an RGBWW-type pixel.  On other strips 'w2'
+// is ignored (and 'w' too if there's no white).
+void Adafruit_NeoPixel::setPixelColor(
+    uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint8_t w2)
 {
+  if (w2Offset == rOffset)
+  {
+    setPixelColor(n, r, g, b, w);
+    return;
+  }
   if (n < numLEDs)
   {
-    uint8_t *p,
-        r = (uint8_t)(c >> 16),
-        g = (uint8_t)(c >> 8),
-        b = (uint8_t)c;
+#ifdef NEO_16BIT
+    if (wide)
+    {
+      setPixelColor16(n, r * 257, g * 257, b * 257, w * 257, w2 * 257);
+      return;
+    }
+#endif
     if (brightness)
     { // See notes in setBrightness()
       r = (r * brightness) >> 8;
       g = (g * brightness) >> 8;
       b = (b * brightness) >> 8;
+      w = (w * brightness) >> 8;
+      w2 = (w2 * brightness) >> 8;
+    }
+    uint8_t *p = &pixels[n * 5];
+    p[rOffset] = r;
+    p[gOffset] = g;
+    p[bOffset] = b;
+    p[wOffset] = w;
+    p[w2Offset] = w2;
+    dirty = true;
+    markPixel(n);
+  }
+}
+
+// Set pixel color from 'packed' 32-bit RGB color:
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c)
+{
+#ifdef NEO_16BIT
+  if (wide)
+  { // Brightness applies to the widened values
+    setPixelColor16(n, (uint8_t)(c >> 16) * 257, (uint8_t)(c >> 8) * 257,
+                    (uint8_t)c * 257, (uint8_t)(c >> 24) * 257);
+    return;
+  }
+#endif
+  setPixelColor(n, scaleColor(c), true);
+}
+
+// Set pixel color from a packed color that's already had brightness
+// applied (by scaleColor()) if 'scaled' is true: a color computed once
+// and drawn to many pixels skips the per-channel multiplies.  On a
+// NEO_16BIT strip it's widened without scaling again.
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c, bool scaled)
+{
+  if (!scaled)
+  {
+    setPixelColor(n, c);
+    return;
+  }
+  if (n < numLEDs)
+  {
+    uint8_t *p, o[4] = {bOffset, gOffset, rOffset, wOffset}, i;
+#ifdef NEO_16BIT
+    if (wide)
+    { // x * 257 is x in both bytes
+      p = &pixels[n * pixelBytes()];
+      if (wOffset != rOffset)
+        p[w2Offset * 2] = p[w2Offset * 2 + 1] = 0;
+      for (i = 0; i < ((wOffset != rOffset) ? 4 : 3); i++, c >>= 8)
+        p[o[i] * 2] = p[o[i] * 2 + 1] = c;
+      dirty = true;
+      markPixel(n);
+      return;
     }
+#endif
     if (wOffset == rOffset)
     {
       p = &pixels[n * 3];
+      i = 3;
     }
     else
     {
-      p = &pixels[n * 4];
-      uint8_t w = (uint8_t)(c >> 24);
-      p[wOffset] = brightness ? ((w * brightness) >> 8) : w;
+      p = &pixels[n * pixelBytes()];
+      p[w2Offset] = 0;
+      i = 4;
     }
-    p[rOffset] = r;
-    p[gOffset] = g;
-    p[bOffset] = b;
+    for (uint8_t *q = o; i--; c >>= 8)
+      p[*q++] = c;
+    dirty = true;
+    markPixel(n);
+  }
+}
+
+// Apply the strip's brightness to a packed color, all four channels at
+// once, as setPixelColor() would.  Pass the result to
+// setPixelColor(n, c, true).
+uint32_t Adafruit_NeoPixel::scaleColor(uint32_t c) const
+{
+  return brightness ? NeoPixelMath::mul8x4(c, brightness) : c;
+}
+
+#ifdef NEO_16BIT
+// Set pixel color from 16-bit R,G,B and optional W (0-65535) on a
+// NEO_16BIT strip.  Stored most significant byte first, straight in
+// the order show() sends.  On an 8-bit strip the low bytes are dropped.
+void Adafruit_NeoPixel::setPixelColor16(
+    uint16_t n, uint16_t r, uint16_t g, uint16_t b, uint16_t w, uint16_t w2)
+{
+  if (n >= numLEDs)
+    return;
+  if (!wide)
+  {
+    setPixelColor(n, r >> 8, g >> 8, b >> 8, w >> 8, w2 >> 8);
+    return;
+  }
+  if (brightness)
+  { // See notes in setBrightness()
+    r = ((uint32_t)r * brightness) >> 8;
+    g = ((uint32_t)g * brightness) >> 8;
+    b = ((uint32_t)b * brightness) >> 8;
+    w = ((uint32_t)w * brightness) >> 8;
+    w2 = ((uint32_t)w2 * brightness) >> 8;
+  }
+  uint8_t *p = &pixels[n * pixelBytes()];
+  if (wOffset != rOffset)
+  { // Second white first, so red overwrites it if there's none
+    p[w2Offset * 2] = w2 >> 8;
+    p[w2Offset * 2 + 1] = w2;
+    p[wOffset * 2] = w >> 8;
+    p[wOffset * 2 + 1] = w;
   }
+  p[rOffset * 2] = r >> 8;
+  p[rOffset * 2 + 1] = r;
+  p[gOffset * 2] = g >> 8;
+  p[gOffset * 2 + 1] = g;
+  p[bOffset * 2] = b >> 8;
+  p[bOffset * 2 + 1] = b;
+  dirty = true;
+  markPixel(n);
 }
+#endif
 
 // Convert separate R,G,B into packed 32-bit RGB color.
 // Packed format is always RGB, regardless of LED strand color order.
@@ -2327,6 +2775,155 @@ uint32_t Adafruit_NeoPixel::Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
   return ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
+// Hue wheel for ColorHSV() and fillRainbow(): for each sixth of the
+// circle, a 2-bit code per channel (R in bits 5,4, G 3,2, B 1,0)
+// selecting a constant 0 or 255, or a ramp rising or falling across the
+// sector.  A table lookup in place of a branch per sector.
+#define HUE_ZERO 0
+#define HUE_FULL 1
+#define HUE_RISE 2
+#define HUE_FALL 3
+static const uint8_t PROGMEM _NeoPixelHueSectors[6] = {
+    (HUE_FULL << 4) | (HUE_RISE << 2) | HUE_ZERO, // Red to yellow
+    (HUE_FALL << 4) | (HUE_FULL << 2) | HUE_ZERO, // Yellow to green
+    (HUE_ZERO << 4) | (HUE_FULL << 2) | HUE_RISE, // Green to cyan
+    (HUE_ZERO << 4) | (HUE_FALL << 2) | HUE_FULL, // Cyan to blue
+    (HUE_RISE << 4) | (HUE_ZERO << 2) | HUE_FULL, // Blue to magenta
+    (HUE_FULL << 4) | (HUE_ZERO << 2) | HUE_FALL  // Magenta to red
+};
+
+// 8-bit gamma-correction table (gamma 2.6) for gamma8() and gamma32().
+static const uint8_t PROGMEM _NeoPixelGammaTable[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,
+    3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 5, 6, 6, 6, 6, 7,
+    7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 10, 11, 11, 11, 12, 12,
+    13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19, 20,
+    20, 21, 21, 22, 22, 23, 24, 24, 25, 25, 26, 27, 27, 28, 29, 29,
+    30, 31, 31, 32, 33, 34, 34, 35, 36, 37, 38, 38, 39, 40, 41, 42,
+    42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+    58, 59, 60, 61, 62, 63, 64, 65, 66, 68, 69, 70, 71, 72, 73, 75,
+    76, 77, 78, 80, 81, 82, 84, 85, 86, 88, 89, 90, 92, 93, 94, 96,
+    97, 99, 100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120,
+    122, 124, 125, 127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148,
+    150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180,
+    182, 184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+    218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255
+};
+
+// Integer-only HSV to RGB conversion into rgb[0..2].  'hue' spans the
+// full color wheel in 0-65535 (wrapping back to red), so hue steps can
+// simply be added and allowed to overflow.
+static void hsvToRGB(uint16_t hue, uint8_t sat, uint8_t val, uint8_t *rgb)
+{
+  uint32_t h6 = (uint32_t)hue * 6; // Bits 18-16 = sector, 15-8 = fraction
+  uint8_t code = pgm_read_byte(&_NeoPixelHueSectors[h6 >> 16]),
+          ramp[4], i;
+  ramp[HUE_ZERO] = 0;
+  ramp[HUE_FULL] = 255;
+  ramp[HUE_RISE] = h6 >> 8;
+  ramp[HUE_FALL] = 255 - ramp[HUE_RISE];
+
+  // Saturation blends toward white, then value scales toward black.
+  // Adding 1 permits >>8 in place of /255 with an exact result at 255.
+  uint16_t s1 = sat + 1, v1 = val + 1;
+  uint8_t s2 = 255 - sat;
+  for (i = 0; i < 3; i++)
+  {
+    uint8_t c = ramp[(code >> (4 - i * 2)) & 3];
+    rgb[i] = ((((c * s1) >> 8) + s2) * v1) >> 8;
+  }
+}
+
+// Convert hue, saturation and value into a packed 32-bit RGB color
+// that can be passed to setPixelColor() or other RGB-compatible
+// functions.  'hue' is 0-65535 around the color wheel starting from
+// red; saturation and value are 0-255.
+uint32_t Adafruit_NeoPixel::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val)
+{
+  uint8_t rgb[3];
+  hsvToRGB(hue, sat, val, rgb);
+  return ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
+}
+
+// Gamma-correct a single 0-255 channel value, for perceptually linear
+// fades.  Apply before brightness (i.e. to the color passed to
+// setPixelColor()), not to data already in the pixel buffer.
+uint8_t Adafruit_NeoPixel::gamma8(uint8_t x)
+{
+  return pgm_read_byte(&_NeoPixelGammaTable[x]);
+}
+
+// Gamma-correct each byte of a packed 32-bit (W)RGB color.
+uint32_t Adafruit_NeoPixel::gamma32(uint32_t x)
+{
+  uint8_t *y = (uint8_t *)&x;
+  for (uint8_t i = 0; i < 4; i++)
+    y[i] = gamma8(y[i]);
+  return x;
+}
+
+// Fill 'count' pixels starting at 'first' ('count' of 0 fills to end of
+// strip) with a rainbow: pixel 'first' gets 'hue', and each following
+// pixel's hue advances by 'hueStep' (65536 = one full wheel, so e.g.
+// 65536 / count gives one complete rainbow).  Results match
+// setPixelColor(i, ColorHSV(...)) (with gamma32() if 'gammify'), but
+// are written straight to the buffer in device order.
+void Adafruit_NeoPixel::fillRainbow(uint16_t first, uint16_t count, uint16_t hue, uint16_t hueStep,
+                                    uint8_t sat, uint8_t val, bool gammify)
+{
+  if (first >= numLEDs)
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+  setDirty(first, count);
+
+  uint8_t bpp = pixelBytes(),
+          *p = &pixels[first * bpp], rgb[3], i;
+#ifdef NEO_16BIT
+  if (wide)
+  {
+    for (; count--; hue += hueStep, first++)
+    {
+      hsvToRGB(hue, sat, val, rgb);
+      if (gammify)
+      {
+        for (i = 0; i < 3; i++)
+          rgb[i] = gamma8(rgb[i]);
+      }
+      setPixelColor16(first, rgb[0] * 257, rgb[1] * 257, rgb[2] * 257);
+    }
+    return;
+  }
+#endif
+  for (; count--; hue += hueStep, p += bpp)
+  {
+    hsvToRGB(hue, sat, val, rgb);
+    if (gammify)
+    {
+      for (i = 0; i < 3; i++)
+        rgb[i] = gamma8(rgb[i]);
+    }
+    // White extraction after gamma, brightness last
+    uint8_t w = ((wOffset != rOffset) && whiteMode) ? splitWhite(rgb[0], rgb[1], rgb[2]) : 0;
+    if (brightness)
+    { // See notes in setBrightness()
+      for (i = 0; i < 3; i++)
+        rgb[i] = (rgb[i] * brightness) >> 8;
+      w = (w * brightness) >> 8;
+    }
+    if (bpp >= 4)
+    {
+      p[w2Offset] = 0; // Overwritten by R if no second white
+      p[wOffset] = w;
+    }
+    p[rOffset] = rgb[0];
+    p[gOffset] = rgb[1];
+    p[bOffset] = rgb[2];
+  }
+}
+
 // Query color from previously-set pixel (returns packed 32-bit RGB value)
 uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
 {
@@ -2335,6 +2932,23 @@ uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
 
   uint8_t *p;
 
+#ifdef NEO_16BIT
+  if (wide)
+  { // Most significant bytes, scaled back as below for 8-bit strips
+    uint8_t bpp = pixelBytes(), o[4] = {bOffset, gOffset, rOffset, wOffset}, i;
+    uint32_t c = 0;
+    p = &pixels[n * bpp];
+    for (i = 0; i < ((bpp >= 8) ? 4 : 3); i++)
+    {
+      uint32_t v = ((uint16_t)p[o[i] * 2] << 8) | p[o[i] * 2 + 1];
+      if (brightness)
+        v = (v << 8) / brightness;
+      c |= (v >> 8) << (i * 8);
+    }
+    return c;
+  }
+#endif
+
   if (wOffset == rOffset)
   { // Is RGB-type device
     p = &pixels[n * 3];
@@ -2345,9 +2959,9 @@ uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
       // value used when setting the pixel color, but there will always be
       // some error -- those bits are simply gone.  Issue is most
       // pronounced at low brightness levels.
-      return (((uint32_t)(p[rOffset] << 8) / brightness) << 16) |
-             (((uint32_t)(p[gOffset] << 8) / brightness) << 8) |
-             ((uint32_t)(p[bOffset] << 8) / brightness);
+      return (unscaled(p[rOffset]) << 16) |
+             (unscaled(p[gOffset]) << 8) |
+             unscaled(p[bOffset]);
     }
     else
     {
@@ -2358,14 +2972,14 @@ uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
     }
   }
   else
-  { // Is RGBW-type device
-    p = &pixels[n * 4];
+  { // Is RGBW-type device (second white, if any, isn't returned)
+    p = &pixels[n * pixelBytes()];
     if (brightness)
     { // Return scaled color
-      return (((uint32_t)(p[wOffset] << 8) / brightness) << 24) |
-             (((uint32_t)(p[rOffset] << 8) / brightness) << 16) |
-             (((uint32_t)(p[gOffset] << 8) / brightness) << 8) |
-             ((uint32_t)(p[bOffset] << 8) / brightness);
+      return (unscaled(p[wOffset]) << 24) |
+             (unscaled(p[rOffset]) << 16) |
+             (unscaled(p[gOffset]) << 8) |
+             unscaled(p[bOffset]);
     }
     else
     { // Return raw color
@@ -2377,6 +2991,57 @@ uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
   }
 }
 
+// Read 'count' packed colors ('count' of 0 = to end of strip) starting
+// at pixel 'first' into 'out', the same values getPixelColor() returns,
+// with the strip type and brightness tests done once for the run.
+void Adafruit_NeoPixel::getPixels(uint16_t first, uint16_t count, uint32_t *out) const
+{
+  if (first >= numLEDs)
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+
+#ifdef NEO_16BIT
+  if (wide)
+  {
+    while (count--)
+      *out++ = getPixelColor(first++);
+    return;
+  }
+#endif
+
+  uint8_t bpp = pixelBytes(), *p = &pixels[first * bpp];
+  if (bpp == 3)
+  { // Is RGB-type device
+    if (brightness)
+    {
+      for (; count--; p += 3)
+        *out++ = (unscaled(p[rOffset]) << 16) | (unscaled(p[gOffset]) << 8) |
+                 unscaled(p[bOffset]);
+    }
+    else
+    {
+      for (; count--; p += 3)
+        *out++ = ((uint32_t)p[rOffset] << 16) | ((uint32_t)p[gOffset] << 8) | p[bOffset];
+    }
+  }
+  else
+  { // Is RGBW-type device (second white, if any, isn't returned)
+    if (brightness)
+    {
+      for (; count--; p += bpp)
+        *out++ = (unscaled(p[wOffset]) << 24) | (unscaled(p[rOffset]) << 16) |
+                 (unscaled(p[gOffset]) << 8) | unscaled(p[bOffset]);
+    }
+    else
+    {
+      for (; count--; p += bpp)
+        *out++ = ((uint32_t)p[wOffset] << 24) | ((uint32_t)p[rOffset] << 16) |
+                 ((uint32_t)p[gOffset] << 8) | p[bOffset];
+    }
+  }
+}
+
 // Returns pointer to pixels[] array.  Pixel data is stored in device-
 // native format and is not translated here.  Application will need to be
 // aware of specific pixel data format and handle colors appropriately.
@@ -2424,12 +3089,36 @@ void Adafruit_NeoPixel::setBrightness(uint8_t b)
       scale = 65535 / oldBrightness;
     else
       scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+#ifdef NEO_16BIT
+    if (wide)
+    { // Scale each 16-bit (MSB first) value as a whole
+      for (uint16_t i = 0; i < numBytes; i += 2, ptr += 2)
+      {
+        uint32_t v = ((((uint16_t)ptr[0] << 8) | ptr[1]) * (uint32_t)scale) >> 8;
+        if (v > 65535)
+          v = 65535;
+        ptr[0] = v >> 8;
+        ptr[1] = v;
+      }
+    }
+    else
+#endif
     for (uint16_t i = 0; i < numBytes; i++)
     {
       c = *ptr;
       *ptr++ = (c * scale) >> 8;
     }
     brightness = newBrightness;
+    // getPixelColor() scales back with a multiply and shift by this in
+    // place of dividing each channel: (v * unscale) >> 16 is exactly
+    // (v << 8) / brightness for every 8-bit v and brightness (the
+    // rounding error, under v / 65536, never reaches the next integer)
+    unscale = newBrightness ? (0xFFFFFFul / newBrightness + 1) : 0;
+    // A snapshot holds bytes scaled to the old brightness; restoring
+    // them would undo this.  Rescaling it would lose precision the
+    // restore is meant to keep, so it's dropped (as by updateLength()).
+    freeSnapshot();
+    setDirty();
   }
 }
 
@@ -2442,4 +3131,565 @@ uint8_t Adafruit_NeoPixel::getBrightness(void) const
 void Adafruit_NeoPixel::clear()
 {
   memset(pixels, 0, numBytes);
+  setDirty();
+}
+
+// Fill 'count' pixels starting at 'first' with one packed color ('count'
+// of 0 fills to the end of the strip).  The color is brightness-scaled
+// and put in device order once, then replicated -- much quicker than
+// calling setPixelColor() for each pixel.
+void Adafruit_NeoPixel::fill(uint32_t c, uint16_t first, uint16_t count)
+{
+  if (first >= numLEDs)
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+  setDirty(first, count);
+
+#ifdef NEO_16BIT
+  if (wide)
+  { // Set the first pixel, then replicate it
+    uint8_t bpp = pixelBytes(), *p0 = &pixels[first * bpp];
+    setPixelColor16(first, (uint8_t)(c >> 16) * 257, (uint8_t)(c >> 8) * 257,
+                    (uint8_t)c * 257, (uint8_t)(c >> 24) * 257);
+    for (uint8_t *p = p0 + bpp; --count; p += bpp)
+      memcpy(p, p0, bpp);
+    return;
+  }
+#endif
+
+  c = scaleColor(c);
+  uint8_t pix[5], *p, bpp = pixelBytes(),
+      r = (uint8_t)(c >> 16),
+      g = (uint8_t)(c >> 8),
+      b = (uint8_t)c,
+      w = (uint8_t)(c >> 24);
+  pix[w2Offset] = 0; // Second white, if any, is turned off
+  pix[wOffset] = w;  // Overwritten by R if RGB-type strip
+  pix[rOffset] = r;
+  pix[gOffset] = g;
+  pix[bOffset] = b;
+
+
+  if (wOffset == rOffset)
+  { // Is an RGB-type strip
+    p = &pixels[first * 3];
+    if ((r == g) && (g == b))
+    {
+      memset(p, r, count * 3);
+    }
+    else
+    {
+      while (count--)
+      {
+        *p++ = pix[0];
+        *p++ = pix[1];
+        *p++ = pix[2];
+      }
+    }
+  }
+  else if (bpp == 5)
+  { // Is an RGBWW-type strip
+    for (p = &pixels[first * 5]; count--; p += 5)
+      memcpy(p, pix, 5);
+  }
+  else
+  { // Is a WRGB-type strip
+    p = &pixels[first * 4];
+    if ((r == g) && (g == b) && (b == w))
+    {
+      memset(p, r, count * 4);
+    }
+    else
+    {
+      while (count--)
+      {
+        *p++ = pix[0];
+        *p++ = pix[1];
+        *p++ = pix[2];
+        *p++ = pix[3];
+      }
+    }
+  }
+}
+
+// BULK SWIZZLE KERNELS ---------------------------------------------------
+
+// Each kernel copies pixels stored R,G,B (sb = 3) or R,G,B,W (sb = 4)
+// from 'src' into device order at 'dst' (db = 3 or 4 bytes/pixel),
+// where o[] holds the device offsets of R, G, B and W, scaling by 'b'
+// (stored brightness; 0 = none).  A white channel missing from the
+// source is set to 0, and one missing from the device is dropped.
+// Vector kernels return the number of pixels handled, and may store
+// past the last one they count (but never past the last pixel); the
+// scalar loop finishes the rest.
+
+#if defined(__SSSE3__) || (defined(__aarch64__) && defined(__ARM_NEON))
+
+// Byte shuffle control for one 16-byte vector: 5 pixels if both sides
+// are 3 bytes, else 4.  0x80 = zero that byte.
+static uint8_t swizzleMask(uint8_t *m, uint8_t sb, uint8_t db, const uint8_t *o)
+{
+  uint8_t per = ((sb == 4) || (db == 4)) ? 4 : 5, i;
+  memset(m, 0x80, 16);
+  for (i = 0; i < per; i++)
+  {
+    if (db == 4)
+      m[i * 4 + o[3]] = (sb == 4) ? (i * 4 + 3) : 0x80;
+    m[i * db + o[0]] = i * sb;
+    m[i * db + o[1]] = i * sb + 1;
+    m[i * db + o[2]] = i * sb + 2;
+  }
+  return per;
+}
+
+#endif
+
+#if defined(__SSSE3__)
+
+static uint16_t swizzleSSSE3(uint8_t *dst, const uint8_t *src, uint16_t n,
+                             uint8_t sb, uint8_t db, const uint8_t *o, uint8_t b)
+{
+  uint8_t m[16], per = swizzleMask(m, sb, db, o);
+  const __m128i mask = _mm_loadu_si128((const __m128i *)m),
+                zero = _mm_setzero_si128(),
+                vb = _mm_set1_epi16(b);
+  uint16_t i;
+
+  // 6+ pixels left means 16 bytes can be read and written at 3+/pixel
+  for (i = 0; (n - i) >= 6; i += per, src += per * sb, dst += per * db)
+  {
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), mask);
+    if (b)
+    { // See notes in setBrightness()
+      __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), vb), 8),
+              hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), vb), 8);
+      x = _mm_packus_epi16(lo, hi);
+    }
+    _mm_storeu_si128((__m128i *)dst, x);
+  }
+  return i;
+}
+
+// RGB source into an RGBW device with NEO_WHITE_ACCURATE or _BOOST and
+// a neutral (0xFFFFFF) white: 4 pixels at a time are first spread to
+// R,G,B,0 words, where the white part is the min of the low 3 bytes.
+static uint16_t swizzleWhiteSSSE3(uint8_t *dst, const uint8_t *src, uint16_t n,
+                                  const uint8_t *o, uint8_t b, bool accurate)
+{
+  uint8_t m[16], i;
+  for (i = 0; i < 4; i++)
+  {
+    m[i * 4 + o[0]] = i * 4;
+    m[i * 4 + o[1]] = i * 4 + 1;
+    m[i * 4 + o[2]] = i * 4 + 2;
+    m[i * 4 + o[3]] = i * 4 + 3;
+  }
+  const __m128i spread = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128,
+                                       6, 7, 8, -128, 9, 10, 11, -128),
+                bcast = _mm_setr_epi8(0, 0, 0, -128, 4, 4, 4, -128,
+                                      8, 8, 8, -128, 12, 12, 12, -128),
+                order = _mm_loadu_si128((const __m128i *)m),
+                low = _mm_set1_epi32(0xFF),
+                zero = _mm_setzero_si128(),
+                vb = _mm_set1_epi16(b);
+  uint16_t j;
+
+  for (j = 0; (n - j) >= 6; j += 4, src += 12, dst += 16)
+  {
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), spread),
+            w = _mm_and_si128(_mm_min_epu8(_mm_min_epu8(x, _mm_srli_epi32(x, 8)),
+                                           _mm_srli_epi32(x, 16)),
+                              low);
+    if (accurate)
+      x = _mm_subs_epu8(x, _mm_shuffle_epi8(w, bcast));
+    x = _mm_shuffle_epi8(_mm_or_si128(x, _mm_slli_epi32(w, 24)), order);
+    if (b)
+    { // See notes in setBrightness()
+      __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), vb), 8),
+              hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), vb), 8);
+      x = _mm_packus_epi16(lo, hi);
+    }
+    _mm_storeu_si128((__m128i *)dst, x);
+  }
+  return j;
+}
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+
+static uint16_t swizzleNEON(uint8_t *dst, const uint8_t *src, uint16_t n,
+                            uint8_t sb, uint8_t db, const uint8_t *o, uint8_t b)
+{
+  uint8_t m[16], per = swizzleMask(m, sb, db, o);
+  const uint8x16_t mask = vld1q_u8(m);
+  const uint8x8_t vb = vdup_n_u8(b);
+  uint16_t i;
+
+  for (i = 0; (n - i) >= 6; i += per, src += per * sb, dst += per * db)
+  { // Out-of-range (0x80) table indices give 0, as with pshufb
+    uint8x16_t x = vqtbl1q_u8(vld1q_u8(src), mask);
+    if (b)
+      x = vcombine_u8(vshrn_n_u16(vmull_u8(vget_low_u8(x), vb), 8),
+                      vshrn_n_u16(vmull_u8(vget_high_u8(x), vb), 8));
+    vst1q_u8(dst, x);
+  }
+  return i;
+}
+
+#elif !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+// One pixel per 32-bit word: channels are moved to their device byte
+// with shifts, then scaled two at a time.  Each word load and store
+// may overrun a 3-byte pixel by one byte, so the last pixel is left
+// to the scalar loop.  Not used on AVR, where 32-bit math is slower.
+static uint16_t swizzleSWAR(uint8_t *dst, const uint8_t *src, uint16_t n,
+                            uint8_t sb, uint8_t db, const uint8_t *o, uint8_t b)
+{
+  uint8_t rs = o[0] * 8, gs = o[1] * 8, bs = o[2] * 8, ws = o[3] * 8;
+  uint32_t wm = ((sb == 4) && (db == 4)) ? 0xFF : 0, x, d;
+  uint16_t i;
+
+  for (i = 0; (i + 1) < n; i++, src += sb, dst += db)
+  {
+    memcpy(&x, src, 4); // memcpy() so unaligned buffers are OK
+    d = ((x & 0xFF) << rs) | (((x >> 8) & 0xFF) << gs) |
+        (((x >> 16) & 0xFF) << bs) | (((x >> 24) & wm) << ws);
+    if (b)
+      d = ((((d & 0x00FF00FF) * b) >> 8) & 0x00FF00FF) |
+          (((d >> 8) & 0x00FF00FF) * b & 0xFF00FF00);
+    memcpy(dst, &d, 4);
+  }
+  return i;
+}
+
+#endif
+
+// END BULK SWIZZLE KERNELS -----------------------------------------------
+
+// Copy 'count' pixels from an array of R,G,B ('srcBytes' = 3) or R,G,B,W
+// ('srcBytes' = 4) bytes into the strip starting at pixel 'first'
+// ('count' of 0 = to end of strip), reordering to the device's color
+// order and applying brightness on the way -- much quicker than calling
+// setPixelColor() for each pixel.  'src' mustn't overlap the strip's
+// buffer.  Pixels without a white channel get W = 0.
+void Adafruit_NeoPixel::setPixels(uint16_t first, uint16_t count, const uint8_t *src, uint8_t srcBytes)
+{
+  if ((first >= numLEDs) || ((srcBytes != 3) && (srcBytes != 4)))
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+
+  uint8_t db = pixelBytes();
+  if (db > 4)
+  { // 16-bit or five-channel pixels, one at a time
+    for (; count--; first++, src += srcBytes)
+      setPixelColor(first, src[0], src[1], src[2], (srcBytes == 4) ? src[3] : 0);
+    return;
+  }
+  setDirty(first, count);
+
+  uint8_t o[4] = {rOffset, gOffset, bOffset, wOffset},
+          *dst = &pixels[first * db], r, g, b, w,
+          s = brightness,
+          extract = ((srcBytes == 3) && (db == 4)) ? whiteMode : NEO_WHITE_OFF;
+  uint16_t i;
+#if defined(__SSSE3__)
+  if (!extract)
+    i = swizzleSSSE3(dst, src, count, srcBytes, db, o, s);
+  else if ((white[0] & white[1] & white[2]) == 255)
+    i = swizzleWhiteSSSE3(dst, src, count, o, s, extract == NEO_WHITE_ACCURATE);
+  else
+    i = 0;
+#else
+  if (extract)
+    i = 0; // White extraction is scalar only
+#if defined(__aarch64__) && defined(__ARM_NEON)
+  else
+    i = swizzleNEON(dst, src, count, srcBytes, db, o, s);
+#elif !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  else
+    i = swizzleSWAR(dst, src, count, srcBytes, db, o, s);
+#else
+  else
+    i = 0;
+#endif
+#endif
+  src += i * srcBytes;
+  dst += i * db;
+  for (; i < count; i++, src += srcBytes, dst += db) // Remainder, or everything on AVR
+  {
+    r = src[0];
+    g = src[1];
+    b = src[2];
+    if (srcBytes == 4)
+      w = src[3];
+    else
+      w = extract ? splitWhite(r, g, b) : 0;
+    if (s)
+    { // See notes in setBrightness()
+      r = (r * s) >> 8;
+      g = (g * s) >> 8;
+      b = (b * s) >> 8;
+      w = (w * s) >> 8;
+    }
+    dst[wOffset] = w; // Overwritten by R if RGB-type strip
+    dst[rOffset] = r;
+    dst[gOffset] = g;
+    dst[bOffset] = b;
+  }
+}
+
+// Set how RGB content drives the W channel of RGBW strips: mode is
+// NEO_WHITE_OFF, NEO_WHITE_ACCURATE or NEO_WHITE_BOOST, and whiteColor
+// the packed RGB color of the white LED at full (scale only matters as
+// a ratio; 0xFFFFFF = neutral).  Applies to later drawing; use
+// extractWhite() for pixels already set.  8-bit 4-channel strips only.
+void Adafruit_NeoPixel::setWhiteExtraction(uint8_t mode, uint32_t whiteColor)
+{
+  whiteMode = (mode <= NEO_WHITE_BOOST) ? mode : NEO_WHITE_OFF;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    uint8_t c = (uint8_t)(whiteColor >> (16 - i * 8));
+    white[i] = c ? c : 1; // White LED without some channel: near enough
+    whiteScale[i] = (255 * 256 + white[i] / 2) / white[i];
+  }
+}
+
+static inline uint8_t subWhite(uint8_t c, uint8_t w, uint8_t white)
+{
+  uint16_t t = w * white + 128;
+  t = (t + (t >> 8)) >> 8;
+  return (t < c) ? (c - t) : 0;
+}
+
+// Take the white part out of R,G,B (unless NEO_WHITE_BOOST) and return
+// it as a W value: the most of the white LED's color that fits.
+uint8_t Adafruit_NeoPixel::splitWhite(uint8_t &r, uint8_t &g, uint8_t &b) const
+{
+  uint8_t w;
+  if ((white[0] & white[1] & white[2]) == 255)
+  { // Neutral white: plain minimum
+    w = (r < g) ? r : g;
+    if (b < w)
+      w = b;
+    if (whiteMode == NEO_WHITE_ACCURATE)
+    {
+      r -= w;
+      g -= w;
+      b -= w;
+    }
+    return w;
+  }
+
+  // Most of the white LED's color that fits: min over c * 255 / white
+  uint32_t t = ((uint32_t)r * whiteScale[0]) >> 8, u;
+  if ((u = ((uint32_t)g * whiteScale[1]) >> 8) < t)
+    t = u;
+  if ((u = ((uint32_t)b * whiteScale[2]) >> 8) < t)
+    t = u;
+  w = (t > 255) ? 255 : t;
+  if (whiteMode == NEO_WHITE_ACCURATE)
+  { // Subtract w * white / 255 (rounded), not below 0
+    r = subWhite(r, w, white[0]);
+    g = subWhite(g, w, white[1]);
+    b = subWhite(b, w, white[2]);
+  }
+  return w;
+}
+
+// Apply the current white extraction to 'count' pixels from 'first'
+// ('count' of 0 = to end of strip) already in the buffer, for content
+// drawn some other way -- fill(), helper classes, getPixels() writes.
+// The white part is added to any W already set (NEO_WHITE_ACCURATE), or
+// raises W to it (NEO_WHITE_BOOST), so a second pass changes nothing.
+void Adafruit_NeoPixel::extractWhite(uint16_t first, uint16_t count)
+{
+  if ((first >= numLEDs) || !whiteMode || (pixelBytes() != 4))
+    return;
+  if (!count || (count > (numLEDs - first)))
+    count = numLEDs - first;
+  setDirty(first, count);
+
+  // Already brightness-scaled, but the white part scales the same way
+  for (uint8_t *p = &pixels[first * 4]; count--; p += 4)
+  {
+    uint16_t w = splitWhite(p[rOffset], p[gOffset], p[bOffset]);
+    if (whiteMode == NEO_WHITE_ACCURATE)
+      w += p[wOffset];
+    else if (p[wOffset] > w)
+      w = p[wOffset];
+    p[wOffset] = (w > 255) ? 255 : w;
+  }
+}
+
+// COLOR CORRECTION -------------------------------------------------------
+
+static const int16_t identity[16] = {NEO_CORRECTION_ONE, 0, 0, 0,
+                                     0, NEO_CORRECTION_ONE, 0, 0,
+                                     0, 0, NEO_CORRECTION_ONE, 0,
+                                     0, 0, 0, NEO_CORRECTION_ONE};
+
+// Set a 3x3 (R,G,B) or 4x4 (R,G,B,W) color correction matrix: 'size'
+// rows of 'size' coefficients, NEO_CORRECTION_ONE = 1.0, where row i
+// gives output channel i as a mix of the drawn channels.  Applies to
+// 8-bit strips with 3 or 4 channels.  The white point (if set) scales
+// the result.  NULL resets to identity.  Returns false if there's no
+// RAM for the corrected buffer (correction is then off).
+bool Adafruit_NeoPixel::setColorCorrection(const int16_t *matrix, uint8_t size)
+{
+  int16_t m[16];
+  uint8_t wp[4] = {255, 255, 255, 255}, i, j;
+
+  memcpy(m, identity, sizeof(m));
+  if (matrix && ((size == 3) || (size == 4)))
+  {
+    for (i = 0; i < size; i++)
+    {
+      for (j = 0; j < size; j++)
+      { // Clamp to +/-8.0 so combined values fit 16 bits
+        int16_t v = matrix[i * size + j];
+        m[i * 4 + j] = (v > 2047) ? 2047 : (v < -2047) ? -2047 : v;
+      }
+    }
+  }
+  if (correction)
+    memcpy(wp, correction->white, 4);
+  return updateCorrection(m, wp);
+}
+
+// Set output gains for R,G,B(,W) -- e.g. a strip's tint or a light
+// source's color temperature (NEO_WHITEPOINT_*).  Combines with the
+// correction matrix, if any.  Returns false as setColorCorrection().
+bool Adafruit_NeoPixel::setWhitePoint(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+  uint8_t wp[4] = {r, g, b, w};
+  return updateCorrection(correction ? correction->matrix : identity, wp);
+}
+
+// Store new correction state, or drop it for an identity matrix with a
+// neutral white point (or 'matrix' NULL), so show() skips correction.
+bool Adafruit_NeoPixel::updateCorrection(const int16_t *matrix, const uint8_t *wp)
+{
+  if (!matrix || (!memcmp(matrix, identity, sizeof(identity)) &&
+                  ((wp[0] & wp[1] & wp[2] & wp[3]) == 255)))
+  {
+    if (correction)
+    {
+      free(correction->frame);
+      free(correction);
+      correction = NULL;
+    }
+    return true;
+  }
+  if (!correction)
+  {
+    if (!(correction = (neoCorrection *)malloc(sizeof(neoCorrection))))
+      return false;
+    correction->frame = NULL;
+    correction->frameBytes = 0;
+    // Only referenced here, so the kernels aren't linked in unless used
+    correction->apply = correctFrame;
+  }
+  memmove(correction->matrix, matrix, sizeof(correction->matrix));
+  memcpy(correction->white, wp, 4);
+  if (correction->frameBytes != numBytes)
+  {
+    free(correction->frame);
+    correction->frame = (uint8_t *)malloc(numBytes);
+    correction->frameBytes = correction->frame ? numBytes : 0;
+    if (!correction->frame && numBytes)
+    {
+      free(correction);
+      correction = NULL;
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline uint8_t clamp8(int32_t v)
+{
+  return (v < 0) ? 0 : (v > 255) ? 255 : v;
+}
+
+// Matrices here are in device byte order with 12 fractional bits
+
+static void correctDiagonal(uint8_t *out, const uint8_t *in, uint16_t n,
+                            const int16_t *g, uint8_t bpp)
+{ // Gains only (white point, no cross terms)
+  int32_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3];
+  for (; n--; in += bpp, out += bpp)
+  {
+    out[0] = clamp8((in[0] * g0 + 2048) >> 12);
+    out[1] = clamp8((in[1] * g1 + 2048) >> 12);
+    out[2] = clamp8((in[2] * g2 + 2048) >> 12);
+    if (bpp == 4)
+      out[3] = clamp8((in[3] * g3 + 2048) >> 12);
+  }
+}
+
+static void correct3(uint8_t *out, const uint8_t *in, uint16_t n, const int16_t (*d)[4])
+{
+  for (; n--; in += 3, out += 3)
+  {
+    int32_t a = in[0], b = in[1], c = in[2];
+    out[0] = clamp8((d[0][0] * a + d[0][1] * b + d[0][2] * c + 2048) >> 12);
+    out[1] = clamp8((d[1][0] * a + d[1][1] * b + d[1][2] * c + 2048) >> 12);
+    out[2] = clamp8((d[2][0] * a + d[2][1] * b + d[2][2] * c + 2048) >> 12);
+  }
+}
+
+static void correct4(uint8_t *out, const uint8_t *in, uint16_t n, const int16_t (*d)[4])
+{
+  for (; n--; in += 4, out += 4)
+  {
+    int32_t a = in[0], b = in[1], c = in[2], e = in[3];
+    out[0] = clamp8((d[0][0] * a + d[0][1] * b + d[0][2] * c + d[0][3] * e + 2048) >> 12);
+    out[1] = clamp8((d[1][0] * a + d[1][1] * b + d[1][2] * c + d[1][3] * e + 2048) >> 12);
+    out[2] = clamp8((d[2][0] * a + d[2][1] * b + d[2][2] * c + d[2][3] * e + 2048) >> 12);
+    out[3] = clamp8((d[3][0] * a + d[3][1] * b + d[3][2] * c + d[3][3] * e + 2048) >> 12);
+  }
+}
+
+// Called by show() to fill the corrected buffer.  Returns the buffer to
+// send: the drawing buffer itself if the strip can't be corrected.
+uint8_t *Adafruit_NeoPixel::correctFrame(Adafruit_NeoPixel &s)
+{
+  neoCorrection *c = s.correction;
+  uint8_t bpp = s.pixelBytes(), o[4] = {s.rOffset, s.gOffset, s.bOffset, s.wOffset}, i, j;
+  int16_t d[4][4];
+  bool diagonal = true;
+
+  if (bpp > 4)
+    return s.pixels; // 16-bit or five-channel: uncorrected
+  if (c->frameBytes != s.numBytes)
+  { // Strip was resized
+    free(c->frame);
+    c->frame = (uint8_t *)malloc(s.numBytes);
+    c->frameBytes = c->frame ? s.numBytes : 0;
+    if (!c->frame)
+      return s.pixels;
+  }
+
+  // Fold in the white point and reorder for the device, once per frame
+  for (i = 0; i < bpp; i++)
+  {
+    for (j = 0; j < bpp; j++)
+    {
+      int32_t v = (int32_t)c->matrix[i * 4 + j] * c->white[i] * 16;
+      d[o[i]][o[j]] = (v + ((v < 0) ? -127 : 127)) / 255;
+      if ((i != j) && d[o[i]][o[j]])
+        diagonal = false;
+    }
+  }
+  if (diagonal)
+  {
+    int16_t g[4] = {d[0][0], d[1][1], d[2][2], (bpp == 4) ? d[3][3] : (int16_t)0};
+    correctDiagonal(c->frame, s.pixels, s.numLEDs, g, bpp);
+  }
+  else if (bpp == 3)
+    correct3(c->frame, s.pixels, s.numLEDs, d);
+  else
+    correct4(c->frame, s.pixels, s.numLEDs, d);
+  return c->frame;
 }
@@ -135,13 +135,169 @@ typedef uint16_t neoPixelType;
 typedef uint8_t neoPixelType;
 #endif
 
+// Add NEO_16BIT to the color order for chips with 16 bits per channel
+// (e.g. UCS8903/UCS8904 on the single-wire protocol, or HD108 through
+// NeoPixelDotStar): the buffer then holds 6 or 8 bytes per pixel, each
+// channel most significant byte first, in device order -- so show()
+// sends it as is.  8-bit colors are widened (x * 257), and
+// setPixelColor16() sets full-precision values.  Only the core drawing
+// calls, NeoPixelMatrix and NeoPixelDotStar understand the wide buffer;
+// the other helper classes expect 8-bit strips (NeoPixelSegments,
+// NeoPixelDDP, NeoPixelDMX, NeoPixelAdalight, NeoPixelSequence,
+// NeoPixelCompositor and NeoPixelTween refuse 16-bit ones).  Needs a 16-bit neoPixelType, so unavailable on
+// ATtiny.
+#ifdef NEO_KHZ400
+#define NEO_16BIT 0x0200
+#endif
+
+// On MCUs where show() times bits with a cycle counter (Teensy 3.x,
+// Arduino Due, ESP8266), setInterruptWindow() lets pending interrupts
+// run between groups of bytes rather than blocking them for the whole
+// frame.  If an interrupt handler keeps the data line idle long enough
+// that the strip may have latched a partial frame, the frame is resent
+// from the start; after this many restarts, windows are suspended for
+// the remainder of that frame so show() is guaranteed to finish.
+#define NEO_MAX_RESTARTS 3
+
+// White extraction for RGBW strips (setWhiteExtraction()): RGB content
+// drawn with setPixelColor(n, r, g, b), setPixels() from an RGB array or
+// fillRainbow() can drive the W channel from the white part of each
+// color -- the most of the white LED's own color (0xFFFFFF by default;
+// e.g. 0xFFC48C for a warm white) that fits in R,G,B.
+#define NEO_WHITE_OFF 0      // W = 0 for RGB content (default)
+#define NEO_WHITE_ACCURATE 1 // White part moves from R,G,B to W
+#define NEO_WHITE_BOOST 2    // W = white part, R,G,B kept (brighter)
+
+// Color correction (setColorCorrection(), setWhitePoint()) maps each
+// pixel's R,G,B(,W) through a matrix as show() starts, into a second
+// buffer that's sent instead; drawing and getPixelColor() are
+// unaffected.  Matrix coefficients are fixed-point, 8 fractional bits:
+#define NEO_CORRECTION_ONE 256 // Coefficient for 1.0 (range +/-8.0)
+
+// Some white points for setWhitePoint(): strip tints, then light
+// source color temperatures (as used by FastLED)
+#define NEO_WHITEPOINT_TYPICAL_STRIP 0xFFB0F0 // 5050 SMD strips
+#define NEO_WHITEPOINT_TYPICAL_PIXEL 0xFFE08C // 8mm through-hole pixels
+#define NEO_WHITEPOINT_CANDLE 0xFF9329        // 1900 K
+#define NEO_WHITEPOINT_TUNGSTEN_100W 0xFFD6AA // 2850 K
+#define NEO_WHITEPOINT_HALOGEN 0xFFF1E0       // 3200 K
+#define NEO_WHITEPOINT_DAYLIGHT 0xFFFFFF      // 5400 K (no change)
+#define NEO_WHITEPOINT_OVERCAST 0xC9E2FF      // 7000 K
+#define NEO_WHITEPOINT_BLUE_SKY 0x409CFF      // 20000 K
+
+// Pixel buffer snapshots track changes in blocks of this many pixels
+// (as a power of 2): 1 bit of RAM per block, and restore() copies only
+// blocks written since the snapshot.
+#define NEO_SNAPSHOT_SHIFT 4 // 16 pixels
+
 #if defined(__cplusplus)
+// A pixel format descriptor spells out what neoPixelType packs into a
+// few bits, and can also describe pixels the packing can't: RGBWW/RGBCCT
+// fixtures with a second white channel.  Channel offsets count channels
+// (not bytes) from the start of a pixel, and an absent white channel
+// has the same offset as red, as with the packed types.  A pixel is
+// channels * depth / 8 bytes (see neoFormatBytes()).  Pass one to the
+// constructor or updateFormat() in place of a neoPixelType.  Besides
+// the core drawing calls, NeoPixelMatrix, NeoPixelSegments, NeoPixelDDP,
+// NeoPixelAdalight, NeoPixelCompositor and NeoPixelDotStar know about
+// five-channel pixels; the other helper classes expect 3 or 4
+// channels (NeoPixelDMX and NeoPixelSequence refuse other strips).
+typedef struct
+{
+  uint8_t channels; // 3 = RGB, 4 = RGBW, 5 = RGBWW (W and W2)
+  uint8_t r, g, b;  // Offsets of red, green and blue
+  uint8_t w, w2;    // Offsets of white and second (e.g. warm) white
+  uint8_t depth;    // Bits per channel: 8, or 16 (NEO_16BIT)
+  uint16_t kHz;     // Data rate: 800, or 400 (NEO_KHZ400)
+} neoPixelFormat;
+
+// Descriptor equivalent to a packed neoPixelType (color order, plus
+// NEO_KHZ400 and NEO_16BIT if supported), e.g. neoFormat(NEO_GRBW).
+constexpr neoPixelFormat neoFormat(neoPixelType t)
+{
+  return {(uint8_t)((((t >> 6) & 3) == ((t >> 4) & 3)) ? 3 : 4),
+          (uint8_t)((t >> 4) & 3), (uint8_t)((t >> 2) & 3), (uint8_t)(t & 3),
+          (uint8_t)((t >> 6) & 3), (uint8_t)((t >> 4) & 3),
+#ifdef NEO_16BIT
+          (uint8_t)((t & NEO_16BIT) ? 16 : 8),
+#else
+          8,
+#endif
+#ifdef NEO_KHZ400
+          (uint16_t)((t & NEO_KHZ400) ? 400 : 800)};
+#else
+          800};
+#endif
+}
+
+constexpr uint8_t neoFormatBytes(const neoPixelFormat &f)
+{
+  return f.channels * f.depth / 8;
+}
+
+// Descriptors for each NEO_* color order (800 KHz, 8 bits/channel)
+constexpr neoPixelFormat NEO_FORMAT_RGB = neoFormat(NEO_RGB);
+constexpr neoPixelFormat NEO_FORMAT_RBG = neoFormat(NEO_RBG);
+constexpr neoPixelFormat NEO_FORMAT_GRB = neoFormat(NEO_GRB);
+constexpr neoPixelFormat NEO_FORMAT_GBR = neoFormat(NEO_GBR);
+constexpr neoPixelFormat NEO_FORMAT_BRG = neoFormat(NEO_BRG);
+constexpr neoPixelFormat NEO_FORMAT_BGR = neoFormat(NEO_BGR);
+
+constexpr neoPixelFormat NEO_FORMAT_WRGB = neoFormat(NEO_WRGB);
+constexpr neoPixelFormat NEO_FORMAT_WRBG = neoFormat(NEO_WRBG);
+constexpr neoPixelFormat NEO_FORMAT_WGRB = neoFormat(NEO_WGRB);
+constexpr neoPixelFormat NEO_FORMAT_WGBR = neoFormat(NEO_WGBR);
+constexpr neoPixelFormat NEO_FORMAT_WBRG = neoFormat(NEO_WBRG);
+constexpr neoPixelFormat NEO_FORMAT_WBGR = neoFormat(NEO_WBGR);
+
+constexpr neoPixelFormat NEO_FORMAT_RWGB = neoFormat(NEO_RWGB);
+constexpr neoPixelFormat NEO_FORMAT_RWBG = neoFormat(NEO_RWBG);
+constexpr neoPixelFormat NEO_FORMAT_RGWB = neoFormat(NEO_RGWB);
+constexpr neoPixelFormat NEO_FORMAT_RGBW = neoFormat(NEO_RGBW);
+constexpr neoPixelFormat NEO_FORMAT_RBWG = neoFormat(NEO_RBWG);
+constexpr neoPixelFormat NEO_FORMAT_RBGW = neoFormat(NEO_RBGW);
+
+constexpr neoPixelFormat NEO_FORMAT_GWRB = neoFormat(NEO_GWRB);
+constexpr neoPixelFormat NEO_FORMAT_GWBR = neoFormat(NEO_GWBR);
+constexpr neoPixelFormat NEO_FORMAT_GRWB = neoFormat(NEO_GRWB);
+constexpr neoPixelFormat NEO_FORMAT_GRBW = neoFormat(NEO_GRBW);
+constexpr neoPixelFormat NEO_FORMAT_GBWR = neoFormat(NEO_GBWR);
+constexpr neoPixelFormat NEO_FORMAT_GBRW = neoFormat(NEO_GBRW);
+
+constexpr neoPixelFormat NEO_FORMAT_BWRG = neoFormat(NEO_BWRG);
+constexpr neoPixelFormat NEO_FORMAT_BWGR = neoFormat(NEO_BWGR);
+constexpr neoPixelFormat NEO_FORMAT_BRWG = neoFormat(NEO_BRWG);
+constexpr neoPixelFormat NEO_FORMAT_BRGW = neoFormat(NEO_BRGW);
+constexpr neoPixelFormat NEO_FORMAT_BGWR = neoFormat(NEO_BGWR);
+constexpr neoPixelFormat NEO_FORMAT_BGRW = neoFormat(NEO_BGRW);
+
+// Five-channel fixtures: R, G, B, then cool white (W), warm white (W2)
+//                                                  ch  R  G  B  W  W2 bits  KHz
+constexpr neoPixelFormat NEO_FORMAT_RGBWW = {5, 0, 1, 2, 3, 4, 8, 800};
+constexpr neoPixelFormat NEO_FORMAT_GRBWW = {5, 1, 0, 2, 3, 4, 8, 800};
+
+struct neoCorrection; // Color correction state, see Adafruit_NeoPixel.cpp
+
+// An alternative output for show(), in place of the built-in NeoPixel
+// signal on a pin: e.g. a file or SPI device on a Linux host, or a
+// clocked LED protocol.  write() receives the pixel buffer in device
+// color order with brightness applied, and handles its own timing.
+class NeoPixelOutput
+{
+
+  public:
+    virtual ~NeoPixelOutput() {}
+    virtual void begin(void) {}
+    virtual void write(const uint8_t *pixels, uint16_t numBytes) = 0;
+};
+
 class Adafruit_NeoPixel
 {
 
   public:
     // Constructor: number of LEDs, pin number, LED type
     Adafruit_NeoPixel(uint16_t n, uint8_t p = 6, neoPixelType t = NEO_GRB + NEO_KHZ800);
+    Adafruit_NeoPixel(uint16_t n, uint8_t p, const neoPixelFormat &f);
     Adafruit_NeoPixel(void);
     ~Adafruit_NeoPixel();
 
@@ -150,29 +306,118 @@ class Adafruit_NeoPixel
     void setPin(uint8_t p);
     void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
     void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint8_t w2);
     void setPixelColor(uint16_t n, uint32_t c);
+    void setPixelColor(uint16_t n, uint32_t c, bool scaled);
+#ifdef NEO_16BIT
+    void setPixelColor16(uint16_t n, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0,
+                         uint16_t w2 = 0);
+    bool is16Bit(void) const { return wide; }
+#endif
     void setBrightness(uint8_t);
     void clear();
+    void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0);
+    void setPixels(uint16_t first, uint16_t count, const uint8_t *src, uint8_t srcBytes = 3);
+    void setWhiteExtraction(uint8_t mode, uint32_t whiteColor = 0xFFFFFF);
+    uint8_t getWhiteExtraction(void) const { return whiteMode; }
+    void extractWhite(uint16_t first = 0, uint16_t count = 0);
+    bool setColorCorrection(const int16_t *matrix, uint8_t size = 3);
+    bool setWhitePoint(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 255);
+    bool setWhitePoint(uint32_t c) { return setWhitePoint(c >> 16, c >> 8, c); }
+    bool isCorrected(void) const { return correction != NULL; }
     void updateLength(uint16_t n);
     void updateType(neoPixelType t);
+    bool updateFormat(const neoPixelFormat &f);
     uint8_t *getPixels(void) const;
     uint8_t getBrightness(void) const;
+    uint32_t scaleColor(uint32_t c) const;
     int8_t getPin(void) { return pin; };
+    void setOutput(NeoPixelOutput *o) { output = o; }
+    NeoPixelOutput *getOutput(void) const { return output; }
+    void setExternalBuffer(uint8_t *buf);
+    bool isExternalBuffer(void) const { return external; }
+    // Dirty flag is set by any change to pixel data and cleared by show().
+    // Call setDirty() after writing directly to the getPixels() buffer,
+    // giving the range of pixels written if a snapshot is held ('count'
+    // of 0 = to end of strip).
+    bool isDirty(void) const { return dirty; }
+    void setDirty(uint16_t first = 0, uint16_t count = 0)
+    {
+      dirty = true;
+      if (snapMap)
+        markSnapshot(first, count);
+    }
+    bool snapshot(void);
+    void restore(void);
+    void freeSnapshot(void);
+    bool hasSnapshot(void) const { return snapBuf != NULL; }
     uint16_t numPixels(void) const;
     static uint32_t Color(uint8_t r, uint8_t g, uint8_t b);
     static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+    static uint32_t ColorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255);
+    static uint8_t gamma8(uint8_t x);
+    static uint32_t gamma32(uint32_t x);
+    void fillRainbow(uint16_t first, uint16_t count, uint16_t hue, uint16_t hueStep,
+                     uint8_t sat = 255, uint8_t val = 255, bool gammify = false);
     uint32_t getPixelColor(uint16_t n) const;
+    void getPixels(uint16_t first, uint16_t count, uint32_t *out) const;
     inline bool canShow(void) { return (micros() - endTime) >= 50L; }
+    void setInterruptWindow(uint16_t bytes, uint8_t maxGapMicros = 5);
+    uint32_t getShowCount(void) const { return showCount; }
+    uint32_t getShowRestarts(void) const { return showRestarts; }
+    void resetShowStats(void);
 
   private:
+    // Helper classes that read or fill the pixel buffer in bulk, in
+    // device-native order, without going through setPixelColor().
+    friend class NeoPixelSegments;
+    friend class NeoPixelMatrix;
+    friend class NeoPixelLayer;
+    friend class NeoPixelCompositor;
+    friend class NeoPixelEffect;
+    friend class NeoPixelTween;
+    friend class NeoPixelSequence;
+    friend class NeoPixelDMX;
+    friend class NeoPixelDDP;
+    friend class NeoPixelAdalight;
+    friend class NeoPixelDotStar;
+
+    void markSnapshot(uint16_t first, uint16_t count);
+    inline void markPixel(uint16_t n)
+    {
+      if (snapMap)
+        snapMap[n >> (NEO_SNAPSHOT_SHIFT + 3)] |= 1 << ((n >> NEO_SNAPSHOT_SHIFT) & 7);
+    }
+    void copyBlocks(uint8_t *dst, const uint8_t *src);
+    // (v << 8) / brightness as a multiply, for reading colors back
+    inline uint32_t unscaled(uint8_t v) const { return (v * unscale) >> 16; }
+    uint8_t splitWhite(uint8_t &r, uint8_t &g, uint8_t &b) const;
+    bool updateCorrection(const int16_t *matrix, const uint8_t *wp);
+    static uint8_t *correctFrame(Adafruit_NeoPixel &strip);
+    inline uint8_t pixelBytes(void) const
+    {
+      uint8_t n = (wOffset == rOffset) ? 3 : (w2Offset == rOffset) ? 4 : 5;
+#ifdef NEO_16BIT
+      return n << wide;
+#else
+      return n;
+#endif
+    }
+
     boolean
 #ifdef NEO_KHZ400 // If 400 KHz NeoPixel support enabled...
         is800KHz, // ...true if 800 KHz pixels
 #endif
-        begun; // true if begin() previously called
+        begun,    // true if begin() previously called
+        dirty,    // true if pixel data changed since last show()
+        external; // true if 'pixels' is caller-owned (don't free)
+#ifdef NEO_16BIT
+    boolean
+        wide; // true if 16 bits per channel (NEO_16BIT)
+#endif
     uint16_t
         numLEDs,  // Number of RGB LEDs in strip
-        numBytes; // Size of 'pixels' buffer below (3 or 4 bytes/pixel)
+        numBytes; // Size of 'pixels' buffer below (3-5 bytes/pixel, x2 if wide)
     int8_t
         pin; // Output pin number (-1 if not yet set)
     uint8_t
@@ -181,9 +426,31 @@ class Adafruit_NeoPixel
         rOffset, // Index of red byte within each 3- or 4-byte pixel
         gOffset, // Index of green byte
         bOffset, // Index of blue byte
-        wOffset; // Index of white byte (same as rOffset if no white)
+        wOffset,  // Index of white byte (same as rOffset if no white)
+        w2Offset; // Index of second white byte (same as rOffset if none)
     uint32_t
         endTime; // Latch timing reference
+    uint16_t
+        windowBytes; // Bytes issued between interrupt windows (0=none)
+    uint8_t
+        windowGap; // Max idle time (microseconds) in a window
+    uint32_t
+        showCount,    // Frames issued by show()
+        showRestarts; // Frames resent after an interrupt window overran
+    NeoPixelOutput
+        *output; // Alternative output for show(), or NULL for pin
+    uint8_t
+        *snapBuf, // Copy of pixels at last snapshot(), or NULL
+        *snapMap; // Bit per block written since snapshot()/restore()
+    uint8_t
+        whiteMode,  // NEO_WHITE_*
+        white[3];   // R,G,B of the white LED (1-255)
+    uint16_t
+        whiteScale[3]; // 255 * 256 / white[], for the white part
+    neoCorrection
+        *correction; // Color correction, or NULL for none (identity)
+    uint32_t
+        unscale; // 2^24 / brightness, rounded up (see setBrightness())
 #ifdef __AVR__
     volatile uint8_t
         *port; // Output PORT register
@@ -201,7 +468,8 @@ typedef struct
         is800KHz, // ...true if 800 KHz pixels
 #endif
         begun,    // true if begin() previously called
-        showing;
+        showing,
+        external; // true if 'pixels' is caller-owned (don't free)
     uint16_t
         numLEDs,  // Number of RGB LEDs in strip
         numBytes; // Size of 'pixels' buffer below (3 or 4 bytes/pixel)
@@ -216,6 +484,18 @@ typedef struct
         wOffset; // Index of white byte (same as rOffset if no white)
     uint32_t
         endTime; // Latch timing reference
+    uint16_t
+        windowBytes; // Bytes issued between interrupt windows (0=none)
+    uint8_t
+        windowGap; // Max idle time (microseconds) in a window
+    uint32_t
+        showCount,    // Frames issued by show()
+        showRestarts; // Frames resent after an interrupt window overran
+    uint8_t
+        *snapBuf, // Copy of pixels at last snapshot(), or NULL
+        *snapMap; // Bit per block written since snapshot()/restore()
+    uint32_t
+        unscale; // 2^24 / brightness, rounded up (see setBrightness())
 #ifdef __AVR__
     volatile uint8_t
         *port; // Output PORT register
@@ -237,6 +517,7 @@ void Adafruit_NeoPixel__setPixelColor_n_r_g_b_w(Adafruit_NeoPixel *this, uint16_
 void Adafruit_NeoPixel__setPixelColor_n_c(Adafruit_NeoPixel *this, uint16_t n, uint32_t c);
 void Adafruit_NeoPixel__setBrightness(Adafruit_NeoPixel *this, uint8_t);
 void Adafruit_NeoPixel__clear(Adafruit_NeoPixel *this);
+void Adafruit_NeoPixel__fill_c_f_n(Adafruit_NeoPixel *this, uint32_t c, uint16_t first, uint16_t count);
 void Adafruit_NeoPixel__updateLength_n(Adafruit_NeoPixel *this, uint16_t n);
 void Adafruit_NeoPixel__updateType_t(Adafruit_NeoPixel *this, neoPixelType t);
 
@@ -247,9 +528,23 @@ int8_t Adafruit_NeoPixel__getPin(Adafruit_NeoPixel *this);
 uint16_t Adafruit_NeoPixel__numPixels(Adafruit_NeoPixel *this);
 uint32_t Adafruit_NeoPixel____static__Color_r_g_b(uint8_t r, uint8_t g, uint8_t b);
 uint32_t Adafruit_NeoPixel____static__Color_r_g_b_w(uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+uint32_t Adafruit_NeoPixel____static__ColorHSV_h_s_v(uint16_t hue, uint8_t sat, uint8_t val);
+uint8_t Adafruit_NeoPixel____static__gamma8_x(uint8_t x);
+uint32_t Adafruit_NeoPixel____static__gamma32_x(uint32_t x);
+void Adafruit_NeoPixel__fillRainbow_f_n_h_d_s_v_g(Adafruit_NeoPixel *this, uint16_t first, uint16_t count, uint16_t hue, uint16_t hueStep,
+                                                  uint8_t sat, uint8_t val, bool gammify);
 uint32_t Adafruit_NeoPixel__getPixelColor_n(Adafruit_NeoPixel *this, uint16_t n);
 bool Adafruit_NeoPixel____inline__canShow(Adafruit_NeoPixel *this);
 // bool Adafruit_NeoPixel__canShow(Adafruit_NeoPixel *this) { return (micros() - endTime) >= 50L; }
+void Adafruit_NeoPixel__setInterruptWindow_b_g(Adafruit_NeoPixel *this, uint16_t bytes, uint8_t maxGapMicros);
+uint32_t Adafruit_NeoPixel__getShowCount(Adafruit_NeoPixel *this);
+uint32_t Adafruit_NeoPixel__getShowRestarts(Adafruit_NeoPixel *this);
+void Adafruit_NeoPixel__resetShowStats(Adafruit_NeoPixel *this);
+void Adafruit_NeoPixel__setExternalBuffer_b(Adafruit_NeoPixel *this, uint8_t *buf);
+void Adafruit_NeoPixel__setDirty_f_n(Adafruit_NeoPixel *this, uint16_t first, uint16_t count);
+bool Adafruit_NeoPixel__snapshot(Adafruit_NeoPixel *this);
+void Adafruit_NeoPixel__restore(Adafruit_NeoPixel *this);
+void Adafruit_NeoPixel__freeSnapshot(Adafruit_NeoPixel *this);
 
 #endif
 
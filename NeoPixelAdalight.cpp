@@ -0,0 +1,210 @@
+/*-------------------------------------------------------------------------
+  Adalight serial protocol receiver for the Adafruit NeoPixel library.
+  Double-buffers incoming frames so the strip can show between them.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelAdalight.h"
+
+#define ADALIGHT_HEADER 6
+
+NeoPixelAdalight::NeoPixelAdalight(Adafruit_NeoPixel &s) : strip(s), headerLen(0), front(0), expected(0), received(0), lastByte(0),
+                                                           idleTime(1000), timeout(100000), pending(false)
+{
+  buffers[0] = buffers[1] = NULL;
+  memset(&stats, 0, sizeof(stats));
+}
+
+NeoPixelAdalight::~NeoPixelAdalight()
+{
+  if (buffers[0] && (strip.pixels == buffers[front]))
+  { // Give the strip a buffer of its own again, keeping the last frame
+    strip.setExternalBuffer(NULL);
+    if (strip.pixels)
+      memcpy(strip.pixels, buffers[front], strip.numBytes);
+  }
+  free(buffers[0]);
+  free(buffers[1]);
+}
+
+// Allocate both pixel buffers and attach the first to the strip (its
+// own buffer is released).  Call after the strip's length and type are
+// set.  Returns false if there isn't RAM for the buffers, or if the
+// strip is NEO_16BIT (frames are converted to 8-bit pixels only).
+bool NeoPixelAdalight::begin(void)
+{
+  uint16_t n = strip.numBytes;
+
+  if (!n)
+    return false;
+#ifdef NEO_16BIT
+  if (strip.is16Bit())
+    return false;
+#endif
+  free(buffers[0]);
+  free(buffers[1]);
+  buffers[0] = (uint8_t *)calloc(1, n);
+  buffers[1] = (uint8_t *)calloc(1, n);
+  if (!buffers[0] || !buffers[1])
+  {
+    free(buffers[0]);
+    free(buffers[1]);
+    buffers[0] = buffers[1] = NULL;
+    return false;
+  }
+  memcpy(buffers[0], strip.pixels, n);
+  memcpy(buffers[1], strip.pixels, n);
+  front = 0;
+  strip.setExternalBuffer(buffers[front]);
+  headerLen = 0;
+  expected = received = 0;
+  pending = false;
+  return true;
+}
+
+// Call from loop() as often as possible.  Reads whatever the stream
+// has buffered and shows the most recent complete frame once the line
+// goes quiet.  Returns true if a frame was shown.
+bool NeoPixelAdalight::poll(Stream &s, uint32_t now)
+{
+  uint8_t *back = buffers[front ^ 1];
+  uint32_t room = (uint32_t)strip.numLEDs * 3; // R,G,B bytes that fit
+  int avail;
+
+  if (!back)
+    return false;
+  if ((headerLen || expected) && ((now - lastByte) > timeout))
+  { // Partial frame stalled; bytes were lost somewhere
+    stats.timeouts++;
+    headerLen = 0;
+    expected = received = 0;
+  }
+
+  while ((avail = s.available()) > 0)
+  {
+    lastByte = now;
+    if (!expected)
+    {
+      // Looking for the header, a byte at a time
+      uint8_t c = s.read();
+      if ((headerLen < 3) && (c != "Ada"[headerLen]))
+      {
+        stats.discarded += headerLen + 1;
+        headerLen = (c == 'A') ? 1 : 0;
+        if (headerLen)
+          stats.discarded--;
+        continue;
+      }
+      header[headerLen++] = c;
+      if (headerLen < ADALIGHT_HEADER)
+        continue;
+      headerLen = 0;
+      if ((header[3] ^ header[4] ^ 0x55) != header[5])
+      {
+        stats.checksum++;
+        continue;
+      }
+      expected = (((uint32_t)header[3] << 8) + header[4] + 1) * 3;
+      received = 0;
+      continue;
+    }
+
+    // Frame data: bulk read straight into the back buffer, packed
+    // R,G,B; anything past the strip's length is read and dropped
+    uint32_t want = expected - received;
+    if ((uint32_t)avail < want)
+      want = avail;
+    if (received < room)
+    {
+      if (want > (room - received))
+        want = room - received;
+      received += s.readBytes(&back[received], want);
+    }
+    else
+    {
+      uint8_t junk[32];
+      if (want > sizeof(junk))
+        want = sizeof(junk);
+      received += s.readBytes(junk, want);
+    }
+    if (received >= expected)
+    {
+      finish();
+      back = buffers[front ^ 1];
+    }
+  }
+
+  if (pending && !headerLen && !expected && ((now - lastByte) >= idleTime))
+  {
+    strip.show();
+    if (s.available() > 0) // Came in with interrupts off
+      stats.overruns++;
+    stats.shown++;
+    pending = false;
+    return true;
+  }
+  return false;
+}
+
+// Frame complete: convert the back buffer in place from packed R,G,B
+// to the strip's order and brightness, then make it the front buffer.
+void NeoPixelAdalight::finish(void)
+{
+  uint8_t *back = buffers[front ^ 1],
+          bpp = strip.pixelBytes(),
+          b = strip.brightness;
+  uint32_t got = (received < expected) ? received : expected;
+  uint16_t n = strip.numLEDs, i;
+
+  if ((got / 3) < n)
+    n = got / 3;
+  // Back buffer still holds the frame before last; fill in any LEDs
+  // this frame didn't cover from the current front frame
+  if (n < strip.numLEDs)
+    memcpy(&back[n * bpp], &buffers[front][n * bpp], (strip.numLEDs - n) * bpp);
+
+  // Walk backward so 3-byte input can expand to 4- or 5-byte pixels
+  // without overwriting input not yet converted
+  for (i = n; i--;)
+  {
+    uint8_t r = back[i * 3], g = back[i * 3 + 1], bl = back[i * 3 + 2],
+            *p = &back[i * bpp];
+    if (b)
+    { // See notes in setBrightness()
+      r = (r * b) >> 8;
+      g = (g * b) >> 8;
+      bl = (bl * b) >> 8;
+    }
+    if (bpp >= 4)
+      p[strip.wOffset] = 0;
+    if (bpp == 5)
+      p[strip.w2Offset] = 0;
+    p[strip.rOffset] = r;
+    p[strip.gOffset] = g;
+    p[strip.bOffset] = bl;
+  }
+
+  if (pending)
+    stats.skipped++;
+  stats.frames++;
+  front ^= 1;
+  strip.setExternalBuffer(buffers[front]);
+  pending = true;
+  expected = received = 0;
+}
@@ -0,0 +1,89 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_ADALIGHT_H
+#define NEOPIXEL_ADALIGHT_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Receiver statistics
+typedef struct
+{
+  uint32_t
+      frames,    // Complete frames received
+      shown,     // Frames shown
+      skipped,   // Frames replaced by a newer one before being shown
+      checksum,  // Headers with a bad checksum
+      discarded, // Bytes discarded while looking for a header
+      timeouts,  // Frames abandoned part way
+      overruns;  // Times bytes arrived while show() was blocking
+} neoAdalightStats;
+
+// NeoPixelAdalight receives the Adalight serial protocol used by PC
+// ambient-lighting software: "Ada", LED count - 1 (high, low byte), a
+// checksum (high ^ low ^ 0x55), then R,G,B for each LED.
+//
+// Frames are read in bulk with readBytes() straight into one of two
+// pixel buffers owned by the receiver, while the strip shows from the
+// other (via setExternalBuffer()).  When a frame completes, a single
+// in-place pass converts it from R,G,B to the strip's color order and
+// brightness, and the buffers swap.  The strip is only shown once the
+// serial line has been idle for a while, since show() blocks
+// interrupts and bytes arriving meanwhile may be lost; if any arrive
+// anyway (the host is sending faster than the strip can be shown),
+// it's counted as an overrun.  A frame that stalls part way, as
+// happens when bytes are lost, is abandoned after a timeout.  Extra LEDs in a frame beyond
+// the strip length are discarded; missing ones are left unchanged.
+class NeoPixelAdalight
+{
+
+  public:
+    NeoPixelAdalight(Adafruit_NeoPixel &strip);
+    ~NeoPixelAdalight();
+
+    bool begin(void);
+    bool poll(Stream &s) { return poll(s, micros()); }
+    bool poll(Stream &s, uint32_t now);
+    void setIdleTime(uint32_t us) { idleTime = us; }
+    void setTimeout(uint32_t us) { timeout = us; }
+    const neoAdalightStats &getStats(void) const { return stats; }
+    void resetStats(void) { memset(&stats, 0, sizeof(stats)); }
+
+  private:
+    void finish(void);
+
+    Adafruit_NeoPixel
+        &strip;
+    uint8_t
+        *buffers[2], // Pixel buffers; strip shows buffers[front]
+        header[6],
+        headerLen, // Header bytes matched so far
+        front;
+    uint32_t
+        expected,  // Data bytes in current frame
+        received,  // Data bytes received so far
+        lastByte,  // micros() of last byte received
+        idleTime,  // Quiet time before show()
+        timeout;   // Gap after which a partial frame is abandoned
+    boolean
+        pending; // Completed frame waiting to be shown
+    neoAdalightStats
+        stats;
+};
+
+#endif // NEOPIXEL_ADALIGHT_H
@@ -0,0 +1,308 @@
+/*-------------------------------------------------------------------------
+  Layer compositor for the Adafruit NeoPixel library.  Flattens a stack
+  of full-brightness layers with per-layer blend mode and opacity into
+  a strip's pixel buffer.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelCompositor.h"
+#include "NeoPixelMath.h"
+
+#if defined(NEO_BLEND_SSE2)
+#include <emmintrin.h>
+#endif
+
+NeoPixelLayer::NeoPixelLayer(const Adafruit_NeoPixel &strip, uint8_t m, uint8_t o) : Adafruit_NeoPixel(), mode(m), opacity(o)
+{
+  rOffset = strip.rOffset;
+  gOffset = strip.gOffset;
+  bOffset = strip.bOffset;
+  wOffset = strip.wOffset;
+  w2Offset = strip.w2Offset;
+#ifdef NEO_KHZ400
+  is800KHz = strip.is800KHz;
+#endif
+#ifdef NEO_16BIT
+  wide = strip.wide;
+#endif
+  updateLength(strip.numLEDs);
+}
+
+void NeoPixelLayer::setOpacity(uint8_t o)
+{
+  if (o != opacity)
+  {
+    opacity = o;
+    dirty = true;
+  }
+}
+
+void NeoPixelLayer::setBlendMode(uint8_t m)
+{
+  if (m != mode)
+  {
+    mode = m;
+    dirty = true;
+  }
+}
+
+NeoPixelCompositor::NeoPixelCompositor(Adafruit_NeoPixel &s, uint8_t maxLayers) : strip(s), count(0), brightness(0), stale(true)
+{
+  if ((layers = (NeoPixelLayer **)malloc(maxLayers * sizeof(NeoPixelLayer *))))
+    capacity = maxLayers;
+  else
+    capacity = 0;
+}
+
+NeoPixelCompositor::~NeoPixelCompositor()
+{
+  if (layers)
+    free(layers);
+}
+
+// Add a layer on top of the stack.  Returns false if the stack is
+// full, the layer's length or color order doesn't match the strip's,
+// or the strip is NEO_16BIT (layers are blended a byte at a time).
+bool NeoPixelCompositor::addLayer(NeoPixelLayer &layer)
+{
+  if ((count >= capacity) || !fits(layer))
+    return false;
+  layers[count++] = &layer;
+  stale = true;
+  return true;
+}
+
+// True if 'l' can be blended into the strip: 8-bit pixels of the same
+// length and color order
+bool NeoPixelCompositor::fits(const NeoPixelLayer &l) const
+{
+#ifdef NEO_16BIT
+  if (strip.wide || l.wide)
+    return false;
+#endif
+  return (l.numBytes == strip.numBytes) && (l.rOffset == strip.rOffset) &&
+         (l.gOffset == strip.gOffset) && (l.bOffset == strip.bOffset) &&
+         (l.wOffset == strip.wOffset) && (l.w2Offset == strip.w2Offset);
+}
+
+// BLEND KERNELS ----------------------------------------------------------
+
+// Each kernel combines 'n' bytes of layer 's' into accumulated result
+// 'd' using the blend function, then mixes by opacity 'a' (1-256, where
+// 256 = opaque): d = (f(d,s) * a + d * (256 - a)) >> 8.  Channels are
+// independent, so the kernels needn't know the color order.
+
+static inline uint8_t blendByte(uint8_t mode, uint8_t d, uint8_t s)
+{
+  switch (mode)
+  {
+  case NEO_BLEND_ADD:
+    return NeoPixelMath::qadd8(d, s);
+  case NEO_BLEND_MULTIPLY:
+    return NeoPixelMath::scale8(d, s);
+  case NEO_BLEND_SCREEN:
+    return 255 - NeoPixelMath::scale8(255 - d, 255 - s);
+  case NEO_BLEND_MAX:
+    return (d > s) ? d : s;
+  default:
+    return s;
+  }
+}
+
+#if defined(NEO_BLEND_SSE2)
+
+// x / 255 on eight 16-bit lanes holding products of two bytes
+static inline __m128i div255x8(__m128i x)
+{
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Sixteen bytes at a time; returns number of bytes handled
+static uint16_t blendSSE2(uint8_t *d, const uint8_t *s, uint16_t n, uint8_t mode, uint16_t a)
+{
+  const __m128i zero = _mm_setzero_si128(),
+                ones = _mm_set1_epi8((char)0xFF),
+                va = _mm_set1_epi16(a),
+                via = _mm_set1_epi16(256 - a);
+  uint16_t i;
+
+  for (i = 0; (i + 16) <= n; i += 16)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)&d[i]),
+            y = _mm_loadu_si128((const __m128i *)&s[i]), f;
+    switch (mode)
+    {
+    case NEO_BLEND_ADD:
+      f = _mm_adds_epu8(x, y);
+      break;
+    case NEO_BLEND_MAX:
+      f = _mm_max_epu8(x, y);
+      break;
+    case NEO_BLEND_MULTIPLY:
+    case NEO_BLEND_SCREEN:
+    {
+      __m128i p = x, q = y, lo, hi;
+      if (mode == NEO_BLEND_SCREEN)
+      { // Screen is multiply of inverses, inverted
+        p = _mm_xor_si128(p, ones);
+        q = _mm_xor_si128(q, ones);
+      }
+      lo = div255x8(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero),
+                                    _mm_unpacklo_epi8(q, zero)));
+      hi = div255x8(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero),
+                                    _mm_unpackhi_epi8(q, zero)));
+      f = _mm_packus_epi16(lo, hi);
+      if (mode == NEO_BLEND_SCREEN)
+        f = _mm_xor_si128(f, ones);
+    }
+    break;
+    default:
+      f = y;
+      break;
+    }
+    if (a < 256)
+    {
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(f, zero), va),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), via)),
+              hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(f, zero), va),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), via));
+      f = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+    }
+    _mm_storeu_si128((__m128i *)&d[i], f);
+  }
+  return i;
+}
+
+#elif defined(NEO_BLEND_SWAR)
+
+// Four bytes at a time in a 32-bit register, for normal and add modes
+// (multiply/screen/max don't reduce to single word operations).  Each
+// mix product fits in 16 bits, so two channels share each multiply.
+// Not used on AVR, where 32-bit math is slower than bytewise.
+static uint16_t blendSWAR(uint8_t *d, const uint8_t *s, uint16_t n, uint8_t mode, uint16_t a)
+{
+  uint16_t i, ia = 256 - a;
+  uint32_t x, y, f;
+
+  if ((mode != NEO_BLEND_NORMAL) && (mode != NEO_BLEND_ADD))
+    return 0;
+  for (i = 0; (i + 4) <= n; i += 4)
+  {
+    memcpy(&x, &d[i], 4); // memcpy() so unaligned buffers are OK
+    memcpy(&y, &s[i], 4);
+    f = (mode == NEO_BLEND_ADD) ? NeoPixelMath::qadd8x4(x, y) : y;
+    if (a < 256)
+    {
+      f = ((((f & 0x00FF00FF) * a + (x & 0x00FF00FF) * ia) >> 8) & 0x00FF00FF) |
+          ((((f >> 8) & 0x00FF00FF) * a + ((x >> 8) & 0x00FF00FF) * ia) & 0xFF00FF00);
+    }
+    memcpy(&d[i], &f, 4);
+  }
+  return i;
+}
+
+#endif
+
+static void blend(uint8_t *d, const uint8_t *s, uint16_t n, uint8_t mode, uint16_t a)
+{
+  uint16_t i, ia = 256 - a;
+
+#if defined(NEO_BLEND_SSE2)
+  i = blendSSE2(d, s, n, mode, a);
+#elif defined(NEO_BLEND_SWAR)
+  i = blendSWAR(d, s, n, mode, a);
+#else
+  i = 0;
+#endif
+  for (; i < n; i++) // Remainder, or everything on AVR (or portable)
+    d[i] = (blendByte(mode, d[i], s[i]) * a + d[i] * ia) >> 8;
+}
+
+// END BLEND KERNELS ------------------------------------------------------
+
+// Flatten all layers into the strip buffer, applying strip brightness.
+// Returns false (and leaves the strip untouched) if nothing changed, or
+// if a layer no longer fits the strip (see addLayer()).
+bool NeoPixelCompositor::flatten(void)
+{
+  uint8_t *dst = strip.pixels, i, start = 0;
+  uint16_t n = strip.numBytes;
+
+  if (!dst)
+    return false;
+#ifdef NEO_16BIT
+  if (strip.wide)
+    return false;
+#endif
+  // A strip or layer resized or retyped since addLayer() no longer
+  // fits; leave the strip as it is rather than flatten without it
+  for (i = 0; i < count; i++)
+    if (!fits(*layers[i]))
+      return false;
+  if (!stale && (strip.brightness == brightness))
+  {
+    for (i = 0; (i < count) && !layers[i]->dirty; i++)
+      ;
+    if (i == count)
+      return false; // No layer changed
+  }
+
+  // Find the topmost opaque normal layer; nothing below it can show.
+  // Blending then starts with the layer above it.
+  for (i = count; i > 0; i--)
+  {
+    NeoPixelLayer *l = layers[i - 1];
+    if ((l->mode == NEO_BLEND_NORMAL) && (l->opacity == 255))
+    {
+      start = i;
+      break;
+    }
+  }
+  if (start)
+    memcpy(dst, layers[start - 1]->pixels, n);
+  else
+    memset(dst, 0, n);
+
+  for (i = start; i < count; i++)
+  {
+    NeoPixelLayer *l = layers[i];
+    if (l->opacity)
+      blend(dst, l->pixels, n, l->mode, l->opacity + 1);
+  }
+  for (i = 0; i < count; i++)
+    layers[i]->dirty = false;
+
+  if (strip.brightness)
+  { // See notes in Adafruit_NeoPixel::setBrightness()
+    uint8_t b = strip.brightness;
+    for (uint16_t j = 0; j < n; j++)
+      dst[j] = (dst[j] * b) >> 8;
+  }
+  brightness = strip.brightness;
+  stale = false;
+  strip.setDirty();
+  return true;
+}
+
+void NeoPixelCompositor::show(void)
+{
+  flatten();
+  strip.show();
+}
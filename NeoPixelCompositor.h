@@ -0,0 +1,102 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_COMPOSITOR_H
+#define NEOPIXEL_COMPOSITOR_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Which blend kernel the compositor uses.  All give the same results;
+// define NEO_BLEND_PORTABLE to blend a byte at a time everywhere, or
+// NEO_BLEND_NO_SIMD to use the word kernel in place of SSE2 (e.g. to
+// compare them, as extras/linux/blendbench.cpp does).
+#if defined(NEO_BLEND_PORTABLE)
+#elif defined(__SSE2__) && !defined(NEO_BLEND_NO_SIMD)
+#define NEO_BLEND_SSE2 // Sixteen bytes at a time (x86 hosts)
+#elif !defined(__AVR__)
+#define NEO_BLEND_SWAR // Four bytes in a 32-bit word (normal/add modes)
+#endif
+
+// How a layer combines with the layers beneath it.  Each channel is
+// combined independently, then mixed with what's beneath by the
+// layer's opacity.
+#define NEO_BLEND_NORMAL 0   // Layer replaces what's beneath
+#define NEO_BLEND_ADD 1      // Sum, clipped at 255
+#define NEO_BLEND_MULTIPLY 2 // Product (darkens)
+#define NEO_BLEND_SCREEN 3   // Inverse product of inverses (lightens)
+#define NEO_BLEND_MAX 4      // Brighter of the two
+
+// A NeoPixelLayer is a pinless Adafruit_NeoPixel with the same length
+// and pixel format as the strip it's composited onto, so all the usual
+// drawing calls work on it.  Layer data is kept at full brightness;
+// the strip's brightness is applied once, when layers are flattened.
+class NeoPixelLayer : public Adafruit_NeoPixel
+{
+
+  public:
+    NeoPixelLayer(const Adafruit_NeoPixel &strip,
+                  uint8_t mode = NEO_BLEND_NORMAL, uint8_t opacity = 255);
+
+    void setOpacity(uint8_t o);
+    uint8_t getOpacity(void) const { return opacity; }
+    void setBlendMode(uint8_t m);
+    uint8_t getBlendMode(void) const { return mode; }
+    void show(void) {} // Layers are never issued directly
+
+  private:
+    friend class NeoPixelCompositor;
+
+    uint8_t
+        mode,    // NEO_BLEND_*
+        opacity; // 0 = invisible, 255 = opaque
+};
+
+// NeoPixelCompositor flattens a stack of layers into a strip's buffer in
+// one pass per visible layer.  Flattening starts from the topmost
+// opaque NEO_BLEND_NORMAL layer (anything beneath it can't show), skips
+// fully transparent layers, and is skipped entirely if no layer (nor
+// the strip brightness) changed since the last flatten.  Blend kernels
+// work a word at a time on 32-bit MCUs and use SSE2 on x86 hosts.
+class NeoPixelCompositor
+{
+
+  public:
+    NeoPixelCompositor(Adafruit_NeoPixel &strip, uint8_t maxLayers = 4);
+    ~NeoPixelCompositor();
+
+    bool addLayer(NeoPixelLayer &layer);
+    uint8_t numLayers(void) const { return count; }
+    bool flatten(void);
+    void show(void);
+
+  private:
+    bool fits(const NeoPixelLayer &l) const;
+
+    Adafruit_NeoPixel
+        &strip;
+    NeoPixelLayer
+        **layers; // Bottom to top
+    uint8_t
+        count,
+        capacity,
+        brightness; // Strip brightness at last flatten
+    boolean
+        stale; // Force next flatten (layer added)
+};
+
+#endif // NEOPIXEL_COMPOSITOR_H
@@ -0,0 +1,284 @@
+/*-------------------------------------------------------------------------
+  DDP (Distributed Display Protocol) receiver for the Adafruit NeoPixel
+  library.  Scatters packet payloads into strip buffers by offset.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelDDP.h"
+
+// DDP header (http://www.3waylabs.com/ddp/).  Fields are big-endian.
+#define DDP_FLAGS 0
+#define DDP_VERSION_MASK 0xC0
+#define DDP_VERSION_1 0x40
+#define DDP_TIMECODE 0x10
+#define DDP_REPLY 0x04
+#define DDP_QUERY 0x02
+#define DDP_PUSH 0x01
+#define DDP_SEQUENCE 1 // Low 4 bits, 1-15 (0 = not used)
+#define DDP_ID 3
+#define DDP_ID_DEFAULT 1
+#define DDP_ID_ALL 255
+#define DDP_OFFSET 4
+#define DDP_LENGTH 8
+#define DDP_HEADER 10
+#define DDP_TIMECODE_SIZE 4
+
+#define BOUNCE_SIZE 48 // Bytes per reorder/brightness pass (whole pixels)
+
+typedef struct
+{
+  const uint8_t *data;
+  uint16_t left;
+} memSource;
+
+NeoPixelDDP::NeoPixelDDP(uint8_t maxStrips) : count(0), nextSeq(0), frameStart(0), framing(false)
+{
+  if ((targets = (target *)malloc(maxStrips * sizeof(target))))
+    capacity = maxStrips;
+  else
+    capacity = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+NeoPixelDDP::~NeoPixelDDP()
+{
+  if (targets)
+    free(targets);
+}
+
+// Append a strip to the address space: its first byte follows the last
+// byte of the previously added strip.  Returns false if the table is
+// full or the strip is NEO_16BIT (DDP data here is 8 bits per channel).
+bool NeoPixelDDP::addStrip(Adafruit_NeoPixel &strip)
+{
+  if (count >= capacity)
+    return false;
+#ifdef NEO_16BIT
+  if (strip.is16Bit())
+    return false;
+#endif
+  target &t = targets[count];
+  t.strip = &strip;
+  t.base = count ? (targets[count - 1].base + targets[count - 1].strip->numBytes) : 0;
+  // DDP pixel data is R,G,B(,W(,W2))
+  t.swizzle[0] = strip.rOffset;
+  t.swizzle[1] = strip.gOffset;
+  t.swizzle[2] = strip.bOffset;
+  t.swizzle[3] = strip.wOffset;
+  t.swizzle[4] = strip.w2Offset;
+  t.direct = (strip.rOffset == 0) && (strip.gOffset == 1) && (strip.bOffset == 2) &&
+             ((strip.wOffset == strip.rOffset) || (strip.wOffset == 3)) &&
+             ((strip.w2Offset == strip.rOffset) || (strip.w2Offset == 4));
+  t.pending = false;
+  count++;
+  return true;
+}
+
+void NeoPixelDDP::resetStats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+int NeoPixelDDP::readMemory(void *ctx, uint8_t *buf, uint16_t n)
+{
+  memSource *m = (memSource *)ctx;
+  if (n > m->left)
+    n = m->left;
+  memcpy(buf, m->data, n);
+  m->data += n;
+  m->left -= n;
+  return n;
+}
+
+// Process one UDP payload already in memory.  Returns true if it was a
+// DDP data packet for this receiver.
+bool NeoPixelDDP::handlePacket(const uint8_t *data, uint16_t len)
+{
+  memSource m = {data, len};
+  return receive(readMemory, &m, len);
+}
+
+bool NeoPixelDDP::receive(reader read, void *ctx, uint16_t len)
+{
+  uint8_t h[DDP_HEADER + DDP_TIMECODE_SIZE];
+
+  stats.packets++;
+  if ((len < DDP_HEADER) || (read(ctx, h, DDP_HEADER) != DDP_HEADER) ||
+      ((h[DDP_FLAGS] & DDP_VERSION_MASK) != DDP_VERSION_1) ||
+      (h[DDP_FLAGS] & (DDP_QUERY | DDP_REPLY)) ||
+      ((h[DDP_ID] != DDP_ID_DEFAULT) && (h[DDP_ID] != DDP_ID_ALL)))
+  {
+    stats.ignored++;
+    return false;
+  }
+  len -= DDP_HEADER;
+  if (h[DDP_FLAGS] & DDP_TIMECODE)
+  { // Timecode isn't used, but shifts the payload
+    if ((len < DDP_TIMECODE_SIZE) ||
+        (read(ctx, &h[DDP_HEADER], DDP_TIMECODE_SIZE) != DDP_TIMECODE_SIZE))
+    {
+      stats.ignored++;
+      return false;
+    }
+    len -= DDP_TIMECODE_SIZE;
+  }
+
+  // Sequence numbers cycle 1-15.  A jump ahead of up to 7 counts the
+  // skipped packets as lost; anything behind arrived late, so it's
+  // counted as reordered instead (and not as lost).
+  uint8_t seq = h[DDP_SEQUENCE] & 0x0F;
+  if (seq)
+  {
+    if (nextSeq)
+    {
+      uint8_t d = (seq + 15 - nextSeq) % 15;
+      if (d <= 7)
+      {
+        stats.lost += d;
+        nextSeq = (seq % 15) + 1;
+      }
+      else
+      {
+        stats.reordered++;
+        if (stats.lost)
+          stats.lost--;
+      }
+    }
+    else
+    {
+      nextSeq = (seq % 15) + 1;
+    }
+  }
+
+  uint32_t offset = ((uint32_t)h[DDP_OFFSET] << 24) | ((uint32_t)h[DDP_OFFSET + 1] << 16) |
+                    ((uint32_t)h[DDP_OFFSET + 2] << 8) | h[DDP_OFFSET + 3];
+  uint16_t n = ((uint16_t)h[DDP_LENGTH] << 8) | h[DDP_LENGTH + 1];
+  if (n > len)
+    n = len; // Truncated packet
+  if (n)
+  {
+    if (!framing)
+    {
+      frameStart = micros();
+      framing = true;
+    }
+    if (!scatter(read, ctx, offset, n))
+    {
+      stats.ignored++;
+      return false;
+    }
+    stats.data++;
+  }
+  if (h[DDP_FLAGS] & DDP_PUSH)
+    push();
+  return true;
+}
+
+// Read 'n' payload bytes belonging at 'offset' into whichever strips
+// cover that range.  Bytes beyond the last strip are left unread.
+bool NeoPixelDDP::scatter(reader read, void *ctx, uint32_t offset, uint16_t n)
+{
+  uint8_t i;
+
+  for (i = 0; n && (i < count); i++)
+  {
+    target &t = targets[i];
+    Adafruit_NeoPixel *s = t.strip;
+    uint32_t end = t.base + s->numBytes;
+    if ((offset >= end) || !s->pixels)
+      continue;
+    if (offset < t.base)
+    { // Gap between strips (one was resized); skip those bytes, then
+      // carry on with this strip
+      uint16_t gap = ((t.base - offset) < n) ? (t.base - offset) : n;
+      uint8_t junk[BOUNCE_SIZE];
+      for (uint16_t left = gap, k; left; left -= k)
+      {
+        k = (left < BOUNCE_SIZE) ? left : BOUNCE_SIZE;
+        if (read(ctx, junk, k) != k)
+          return false;
+      }
+      offset += gap;
+      n -= gap;
+      if (!n)
+        break;
+    }
+
+    uint16_t o = offset - t.base,
+             c = ((end - offset) < n) ? (end - offset) : n;
+    uint8_t b = s->brightness;
+    if (t.direct && !b)
+    { // Straight from the packet source into the pixel buffer
+      if (read(ctx, &s->pixels[o], c) != c)
+        return false;
+    }
+    else
+    {
+      uint8_t bpp = s->pixelBytes(),
+              ch = o % bpp, // Channel of first byte
+              buf[BOUNCE_SIZE];
+      uint8_t *px = &s->pixels[o - ch]; // Start of its pixel
+      for (uint16_t left = c, k; left; left -= k)
+      {
+        k = (left < BOUNCE_SIZE) ? left : BOUNCE_SIZE;
+        if (read(ctx, buf, k) != k)
+          return false;
+        for (uint16_t j = 0; j < k; j++)
+        {
+          // See notes in setBrightness()
+          px[t.swizzle[ch]] = b ? ((buf[j] * b) >> 8) : buf[j];
+          if (++ch == bpp)
+          {
+            ch = 0;
+            px += bpp;
+          }
+        }
+      }
+    }
+    t.pending = true;
+    uint8_t bpp = s->pixelBytes();
+    s->setDirty(o / bpp, (o + c - 1) / bpp - o / bpp + 1);
+    offset += c;
+    n -= c;
+  }
+  return true;
+}
+
+// Show every strip written since the last push.
+void NeoPixelDDP::push(void)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (targets[i].pending)
+    {
+      targets[i].strip->show();
+      targets[i].pending = false;
+    }
+  }
+  stats.pushes++;
+  if (framing)
+  {
+    uint32_t t = micros() - frameStart;
+    stats.lastLatency = t;
+    stats.totalLatency += t;
+    if (t > stats.maxLatency)
+      stats.maxLatency = t;
+    framing = false;
+  }
+}
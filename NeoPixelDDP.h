@@ -0,0 +1,111 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_DDP_H
+#define NEOPIXEL_DDP_H
+
+#include "Adafruit_NeoPixel.h"
+
+#define NEO_DDP_PORT 4048 // UDP port for DDP
+
+// Receiver statistics.  Latencies are in microseconds, from the first
+// data packet of a frame until show() has returned for all its strips.
+typedef struct
+{
+  uint32_t
+      packets,      // Packets received
+      data,         // Data packets written to strips
+      pushes,       // Push flags acted on
+      lost,         // Packets missing from the sequence
+      reordered,    // Packets arriving after a later one
+      ignored,      // Malformed, query/reply, or other destinations
+      lastLatency,  // Latency of most recent frame
+      maxLatency,   // Longest latency seen
+      totalLatency; // Sum of latencies (for averaging over 'pushes')
+} neoDDPStats;
+
+// NeoPixelDDP receives Distributed Display Protocol packets.  Strips
+// added with addStrip() form one linear address space, in order, and
+// each packet's payload is written at its byte offset into that space.
+// Through poll(), payload bytes are read from the UDP object straight
+// into the strip buffers when a strip's color order is RGB(W(W)) and
+// it has no brightness set; otherwise they pass through a small bounce
+// buffer that reorders bytes and applies brightness on the way.  When a
+// packet carries the push flag, every strip written since the last push
+// is shown.  The 4-bit DDP sequence number is tracked to count lost
+// and reordered packets; data is applied either way.
+//
+// Destination IDs 1 (default output) and 255 (all) are accepted.
+// Query, reply, status and config packets are ignored (this receiver
+// doesn't answer discovery).
+class NeoPixelDDP
+{
+
+  public:
+    NeoPixelDDP(uint8_t maxStrips = 4);
+    ~NeoPixelDDP();
+
+    bool addStrip(Adafruit_NeoPixel &strip);
+    bool handlePacket(const uint8_t *data, uint16_t len);
+    template <class UDPClass>
+    bool poll(UDPClass &udp)
+    {
+      int n = udp.parsePacket();
+      return (n > 0) && receive(readUDP<UDPClass>, &udp, n);
+    }
+    const neoDDPStats &getStats(void) const { return stats; }
+    void resetStats(void);
+
+  private:
+    // Packet source: reads up to 'n' bytes, returns number read
+    typedef int (*reader)(void *ctx, uint8_t *buf, uint16_t n);
+    template <class UDPClass>
+    static int readUDP(void *ctx, uint8_t *buf, uint16_t n)
+    {
+      return ((UDPClass *)ctx)->read(buf, n);
+    }
+    static int readMemory(void *ctx, uint8_t *buf, uint16_t n);
+    bool receive(reader read, void *ctx, uint16_t len);
+    bool scatter(reader read, void *ctx, uint32_t offset, uint16_t n);
+    void push(void);
+
+    typedef struct
+    {
+      Adafruit_NeoPixel *strip;
+      uint32_t base;      // Offset of strip in address space
+      uint8_t swizzle[5]; // Strip byte for each channel of a pixel
+      boolean
+          direct,  // RGB(W(W)) order: payload can land unmodified
+          pending; // Written since last push
+    } target;
+
+    target
+        *targets;
+    uint8_t
+        count,
+        capacity,
+        nextSeq; // Expected sequence number (0 = none yet)
+    uint32_t
+        frameStart; // micros() at first data since last push
+    boolean
+        framing; // Data received since last push
+    neoDDPStats
+        stats;
+};
+
+#endif // NEOPIXEL_DDP_H
@@ -0,0 +1,327 @@
+/*-------------------------------------------------------------------------
+  E1.31 (sACN) and Art-Net receiver for the Adafruit NeoPixel library.
+  Maps DMX universes onto strip ranges.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelDMX.h"
+
+// E1.31 packet offsets and values (ANSI E1.31-2016).  Fields are big-endian.
+#define E131_ROOT_VECTOR 18
+#define E131_VECTOR_ROOT_DATA 0x00000004
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_FRAME_VECTOR 40
+#define E131_VECTOR_DATA_PACKET 0x00000002
+#define E131_VECTOR_EXTENDED_SYNC 0x00000001
+#define E131_SYNC_ADDRESS 109
+#define E131_SEQUENCE 111
+#define E131_OPTIONS 112
+#define E131_OPTION_PREVIEW 0x80
+#define E131_OPTION_TERMINATED 0x40
+#define E131_UNIVERSE 113
+#define E131_DMP_VECTOR 117
+#define E131_PROPERTY_COUNT 123
+#define E131_START_CODE 125
+#define E131_DATA 126
+#define E131_SYNC_SEQUENCE 44
+#define E131_SYNC_UNIVERSE 45
+#define E131_SYNC_LENGTH 49
+
+// Art-Net offsets and values.  OpCode is little-endian, the rest big.
+#define ARTNET_OPCODE 8
+#define ARTNET_OP_DMX 0x5000
+#define ARTNET_OP_SYNC 0x5200
+#define ARTNET_SEQUENCE 12
+#define ARTNET_UNIVERSE 14 // SubUni, then Net
+#define ARTNET_LENGTH 16
+#define ARTNET_DATA 18
+#define ARTNET_SYNC_TIMEOUT 4000 // ms without ArtSync before reverting
+
+static const uint8_t e131Id[12] = {0x41, 0x53, 0x43, 0x2D, 0x45, 0x31,
+                                   0x2E, 0x31, 0x37, 0x00, 0x00, 0x00};
+static const uint8_t artnetId[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+static inline uint16_t be16(const uint8_t *p)
+{
+  return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static inline uint32_t be32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+NeoPixelDMX::NeoPixelDMX(uint8_t maxUniverses) : packet(NULL), count(0), artSyncTime(0), artSync(false)
+{
+  if ((maps = (mapping *)malloc(maxUniverses * sizeof(mapping))))
+    capacity = maxUniverses;
+  else
+    capacity = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+NeoPixelDMX::~NeoPixelDMX()
+{
+  if (maps)
+    free(maps);
+  if (packet)
+    free(packet);
+}
+
+bool NeoPixelDMX::packetBuffer(void)
+{
+  return packet || (packet = (uint8_t *)malloc(NEO_DMX_MAX_PACKET));
+}
+
+// Map DMX 'universe', from channel 'startChannel' (1-512) on, onto the
+// strip's pixels from 'firstPixel'.  Each pixel takes 3 channels (4 on
+// RGBW strips) in 'order' -- one of the NEO_RGB, NEO_GRBW etc. values
+// with the same bytes per pixel as the strip -- or R,G,B(,W) by
+// default.  The range is clipped to the universe and the strip.
+// Several universes may map onto one strip (and a universe onto
+// several strips).  Returns false if the table is full, the range is
+// empty, or 'order' doesn't suit the strip (RGBWW and NEO_16BIT strips
+// can't be mapped).
+bool NeoPixelDMX::addUniverse(uint16_t universe, Adafruit_NeoPixel &strip,
+                              uint16_t firstPixel, uint16_t startChannel,
+                              neoPixelType order)
+{
+  uint8_t bpp = strip.pixelBytes(), in[4];
+
+  if ((count >= capacity) || (firstPixel >= strip.numLEDs) ||
+      !startChannel || (startChannel > NEO_DMX_CHANNELS))
+    return false;
+  if (order == NEO_DMX_ORDER_RGB)
+    order = (bpp == 4) ? NEO_RGBW : NEO_RGB;
+  in[0] = (order >> 4) & 0b11; // Channel offsets of R, G, B, W in
+  in[1] = (order >> 2) & 0b11; // the input, as in updateType()
+  in[2] = order & 0b11;
+  in[3] = (order >> 6) & 0b11;
+  if ((((in[3] == in[0]) ? 3 : 4)) != bpp)
+    return false;
+
+  uint16_t n = (NEO_DMX_CHANNELS - (startChannel - 1)) / bpp;
+  if (n > (strip.numLEDs - firstPixel))
+    n = strip.numLEDs - firstPixel;
+  if (!n)
+    return false;
+
+  mapping &m = maps[count++];
+  m.strip = &strip;
+  m.universe = universe;
+  m.dst = firstPixel * bpp;
+  m.src = startChannel - 1;
+  m.count = n;
+  m.syncAddr = 0;
+  m.bpp = bpp;
+  m.swizzle[in[0]] = strip.rOffset;
+  m.swizzle[in[1]] = strip.gOffset;
+  m.swizzle[in[2]] = strip.bOffset;
+  if (bpp == 4)
+    m.swizzle[in[3]] = strip.wOffset;
+  m.identity = true;
+  for (uint8_t i = 0; i < bpp; i++)
+  {
+    if (m.swizzle[i] != i)
+      m.identity = false;
+  }
+  m.received = m.seqValid = false;
+  m.seq = 0;
+  return true;
+}
+
+// Process one UDP payload.  Returns true if it was a valid E1.31 or
+// Art-Net data or sync packet (whether or not it was mapped here).
+bool NeoPixelDMX::handlePacket(const uint8_t *p, uint16_t len)
+{
+  stats.packets++;
+
+  if ((len >= E131_SYNC_LENGTH) && !memcmp(&p[4], e131Id, sizeof(e131Id)))
+  {
+    uint32_t root = be32(&p[E131_ROOT_VECTOR]),
+             frame = be32(&p[E131_FRAME_VECTOR]);
+    if ((root == E131_VECTOR_ROOT_EXTENDED) && (frame == E131_VECTOR_EXTENDED_SYNC))
+    {
+      sync(be16(&p[E131_SYNC_UNIVERSE]), false);
+      return true;
+    }
+    if ((root == E131_VECTOR_ROOT_DATA) && (frame == E131_VECTOR_DATA_PACKET) &&
+        (len > E131_DATA) && (p[E131_DMP_VECTOR] == 0x02) && !p[E131_START_CODE])
+    {
+      uint16_t n = be16(&p[E131_PROPERTY_COUNT]) - 1; // Less start code
+      if (n > (len - E131_DATA))
+        n = len - E131_DATA;
+      if (p[E131_OPTIONS] & (E131_OPTION_PREVIEW | E131_OPTION_TERMINATED))
+      { // Not for live output
+        stats.ignored++;
+        return true;
+      }
+      data(be16(&p[E131_UNIVERSE]), p[E131_SEQUENCE], true,
+           be16(&p[E131_SYNC_ADDRESS]), &p[E131_DATA], n);
+      return true;
+    }
+  }
+  else if ((len >= 14) && !memcmp(p, artnetId, sizeof(artnetId)))
+  {
+    uint16_t op = p[ARTNET_OPCODE] | ((uint16_t)p[ARTNET_OPCODE + 1] << 8);
+    if (op == ARTNET_OP_SYNC)
+    {
+      sync(0, true);
+      return true;
+    }
+    if ((op == ARTNET_OP_DMX) && (len > ARTNET_DATA))
+    {
+      uint16_t n = be16(&p[ARTNET_LENGTH]);
+      if (n > (len - ARTNET_DATA))
+        n = len - ARTNET_DATA;
+      if (artSync && ((millis() - artSyncTime) > ARTNET_SYNC_TIMEOUT))
+        artSync = false; // Sender stopped syncing
+      // Art-Net sequence 0 means sequencing is disabled.  Sync address
+      // 0xFFFF (not a valid E1.31 universe) marks data awaiting ArtSync.
+      data((p[ARTNET_UNIVERSE] | ((uint16_t)(p[ARTNET_UNIVERSE + 1] & 0x7F) << 8)),
+           p[ARTNET_SEQUENCE], p[ARTNET_SEQUENCE] != 0,
+           artSync ? 0xFFFF : 0, &p[ARTNET_DATA], n);
+      return true;
+    }
+  }
+  stats.ignored++;
+  return false;
+}
+
+// Copy 'n' channels of universe data into each strip range it maps to,
+// then show any strip whose frame is now complete.
+void NeoPixelDMX::data(uint16_t universe, uint8_t seq, bool checkSeq,
+                       uint16_t syncAddr, const uint8_t *ch, uint16_t n)
+{
+  uint8_t i, mapped = 0, written = 0;
+
+  for (i = 0; i < count; i++)
+  {
+    mapping &m = maps[i];
+    if (m.universe != universe)
+      continue;
+    mapped++;
+    if (checkSeq && m.seqValid)
+    { // Per E1.31 6.7.2: drop if within 20 behind (or equal to) the last
+      int8_t d = seq - m.seq;
+      if ((d <= 0) && (d > -20))
+        continue; // Other mappings of the universe still get it
+    }
+    m.seq = seq;
+    m.seqValid = checkSeq;
+    m.syncAddr = syncAddr;
+    write(m, ch, n);
+    m.received = true;
+    written++;
+  }
+  if (!mapped)
+  {
+    stats.ignored++;
+    return;
+  }
+  if (written < mapped)
+    stats.sequence++;
+  if (!written)
+    return;
+  stats.data++;
+
+  // Frame complete: every universe on the strip has arrived
+  for (i = 0; i < count; i++)
+  {
+    mapping &m = maps[i];
+    if ((m.universe != universe) || m.syncAddr || !m.received)
+      continue;
+    uint8_t j;
+    for (j = 0; (j < count) && ((maps[j].strip != m.strip) || maps[j].received); j++)
+      ;
+    if (j == count)
+      showStrip(m.strip);
+  }
+}
+
+void NeoPixelDMX::write(mapping &m, const uint8_t *ch, uint16_t n)
+{
+  Adafruit_NeoPixel *s = m.strip;
+  uint8_t bpp = m.bpp, b = s->brightness;
+  uint16_t px;
+
+  if (n <= m.src)
+    return;
+  px = (n - m.src) / bpp;
+  if (px > m.count)
+    px = m.count;
+  // Strip may have been resized since the universe was added
+  if (!px || (((uint32_t)m.dst + (uint32_t)px * bpp) > s->numBytes))
+    return;
+  s->setDirty(m.dst / bpp, px);
+  uint8_t *dst = &s->pixels[m.dst];
+  ch += m.src;
+
+  if (m.identity && !b)
+  {
+    memcpy(dst, ch, px * bpp);
+  }
+  else if (!b)
+  {
+    for (; px--; ch += bpp, dst += bpp)
+    {
+      dst[m.swizzle[0]] = ch[0];
+      dst[m.swizzle[1]] = ch[1];
+      dst[m.swizzle[2]] = ch[2];
+      if (bpp == 4)
+        dst[m.swizzle[3]] = ch[3];
+    }
+  }
+  else
+  { // See notes in setBrightness()
+    for (; px--; ch += bpp, dst += bpp)
+    {
+      for (uint8_t i = 0; i < bpp; i++)
+        dst[m.swizzle[i]] = (ch[i] * b) >> 8;
+    }
+  }
+}
+
+// Show every strip with synchronized data waiting for this sync.
+void NeoPixelDMX::sync(uint16_t syncAddr, bool artnet)
+{
+  stats.syncs++;
+  if (artnet)
+  {
+    artSync = true;
+    artSyncTime = millis();
+  }
+  for (uint8_t i = 0; i < count; i++)
+  {
+    mapping &m = maps[i];
+    if (m.received && m.syncAddr && (artnet ? (m.syncAddr == 0xFFFF) : (m.syncAddr == syncAddr)))
+      showStrip(m.strip);
+  }
+}
+
+void NeoPixelDMX::showStrip(Adafruit_NeoPixel *strip)
+{
+  strip->show();
+  stats.frames++;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (maps[i].strip == strip)
+      maps[i].received = false;
+  }
+}
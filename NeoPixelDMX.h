@@ -0,0 +1,125 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_DMX_H
+#define NEOPIXEL_DMX_H
+
+#include "Adafruit_NeoPixel.h"
+
+#define NEO_DMX_CHANNELS 512    // Channels per DMX universe
+#define NEO_DMX_MAX_PACKET 638  // Largest E1.31 data packet
+#define NEO_DMX_E131_PORT 5568  // UDP port for E1.31 (sACN)
+#define NEO_DMX_ARTNET_PORT 6454 // UDP port for Art-Net
+#define NEO_DMX_ORDER_RGB 0     // addUniverse() default: R,G,B(,W)
+
+// Receiver statistics
+typedef struct
+{
+  uint32_t
+      packets,    // Packets passed to handlePacket()
+      data,       // DMX data packets for mapped universes
+      syncs,      // Sync packets (E1.31 universe sync or ArtSync)
+      frames,     // Strip show() calls
+      sequence,   // Data packets dropped as out of sequence
+      ignored;    // Malformed, unsupported or unmapped packets
+} neoDMXStats;
+
+// NeoPixelDMX receives E1.31 (sACN) and Art-Net (ArtDmx/ArtSync) DMX
+// data and writes it straight into strip buffers.  Each universe is
+// mapped onto a range of pixels on a strip with addUniverse(), which
+// resolves once how channel bytes land in the strip's color order, so a
+// packet is copied with memcpy() or a fixed byte swizzle -- no
+// per-channel setPixelColor() calls.  The strip's brightness is applied
+// as data is written.
+//
+// A strip is shown when every universe mapped onto it has arrived since
+// its last show() (frame complete).  When the sender synchronizes --
+// E1.31 data packets naming a sync address, or Art-Net with ArtSync
+// seen in the last 4 seconds -- strips are instead shown together when
+// the sync packet arrives.  E1.31 packets arriving out of sequence are
+// dropped, as the standard requires.  Art-Net universes are 15-bit
+// port-addresses (net, sub-net and universe together).
+//
+// The receiver is transport-agnostic: pass each UDP payload to
+// handlePacket(), or call poll() with any Arduino UDP object (e.g.
+// WiFiUDP, EthernetUDP) listening on the relevant port.
+class NeoPixelDMX
+{
+
+  public:
+    NeoPixelDMX(uint8_t maxUniverses = 8);
+    ~NeoPixelDMX();
+
+    bool addUniverse(uint16_t universe, Adafruit_NeoPixel &strip,
+                     uint16_t firstPixel = 0, uint16_t startChannel = 1,
+                     neoPixelType order = NEO_DMX_ORDER_RGB);
+    bool handlePacket(const uint8_t *data, uint16_t len);
+    template <class UDPClass>
+    bool poll(UDPClass &udp)
+    {
+      int n = udp.parsePacket();
+      if ((n <= 0) || !packetBuffer())
+        return false;
+      n = udp.read(packet, NEO_DMX_MAX_PACKET);
+      return (n > 0) && handlePacket(packet, n);
+    }
+    const neoDMXStats &getStats(void) const { return stats; }
+    void resetStats(void) { memset(&stats, 0, sizeof(stats)); }
+
+  private:
+    typedef struct
+    {
+      Adafruit_NeoPixel *strip;
+      uint16_t
+          universe,
+          dst,      // Byte offset of first pixel in strip buffer
+          src,      // Channel (0-based) of first pixel's data
+          count,    // Pixels
+          syncAddr; // E1.31 sync universe from last data packet (0=none)
+      uint8_t
+          bpp,
+          swizzle[4], // Strip byte for each channel of a pixel
+          seq;        // Last sequence number
+      boolean
+          identity, // Channel order matches strip; copy directly
+          received, // Data arrived since the strip's last show()
+          seqValid; // 'seq' holds a real sequence number
+    } mapping;
+
+    bool packetBuffer(void);
+    void write(mapping &m, const uint8_t *ch, uint16_t n);
+    void data(uint16_t universe, uint8_t seq, bool checkSeq,
+              uint16_t syncAddr, const uint8_t *ch, uint16_t n);
+    void sync(uint16_t syncAddr, bool artnet);
+    void showStrip(Adafruit_NeoPixel *strip);
+
+    mapping
+        *maps;
+    uint8_t
+        *packet, // poll() receive buffer, allocated on first use
+        count,
+        capacity;
+    uint32_t
+        artSyncTime; // millis() of last ArtSync
+    boolean
+        artSync; // ArtSync seen; Art-Net data waits for sync
+    neoDMXStats
+        stats;
+};
+
+#endif // NEOPIXEL_DMX_H
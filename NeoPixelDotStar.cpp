@@ -0,0 +1,318 @@
+/*-------------------------------------------------------------------------
+  APA102 / SK9822 output for the Adafruit NeoPixel library.  Clocks
+  the pixel buffer out over hardware SPI or two bit-banged pins.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelDotStar.h"
+
+#define CHUNK_LEDS 8 // LEDs assembled per SPI transfer
+
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#endif
+
+// ceil(2^31 / c) for c = 1-31: floor(x / c) is (x * table[c]) >> 31
+// exactly for any x below 2^26, so no divide is needed per pixel.
+static const uint32_t PROGMEM _DotStarReciprocal[32] = {
+    0x00000000, 0x80000000, 0x40000000, 0x2AAAAAAB,
+    0x20000000, 0x1999999A, 0x15555556, 0x12492493,
+    0x10000000, 0x0E38E38F, 0x0CCCCCCD, 0x0BA2E8BB,
+    0x0AAAAAAB, 0x09D89D8A, 0x0924924A, 0x08888889,
+    0x08000000, 0x07878788, 0x071C71C8, 0x06BCA1B0,
+    0x06666667, 0x06186187, 0x05D1745E, 0x0590B217,
+    0x05555556, 0x051EB852, 0x04EC4EC5, 0x04BDA130,
+    0x04924925, 0x0469EE59, 0x04444445, 0x04210843};
+
+NeoPixelDotStar::NeoPixelDotStar(Adafruit_NeoPixel &s, int8_t d, int8_t c, neoPixelType order)
+    : strip(s), spi(NULL), wide(NULL), wideLength(0), hz(0), dataPin(d), clockPin(c), global(31),
+      chip(NEO_DOTSTAR_APA102)
+{
+  gain[0] = gain[1] = gain[2] = 31;
+  wire[0] = (order >> 4) & 0b11; // Same encoding as the strip types
+  wire[1] = (order >> 2) & 0b11;
+  wire[2] = order & 0b11;
+  strip.setOutput(this);
+}
+
+NeoPixelDotStar::NeoPixelDotStar(Adafruit_NeoPixel &s, SPIClass &p, uint32_t h, neoPixelType order)
+    : strip(s), spi(&p), wide(NULL), wideLength(0), hz(h), dataPin(-1), clockPin(-1), global(31),
+      chip(NEO_DOTSTAR_APA102)
+{
+  gain[0] = gain[1] = gain[2] = 31;
+  wire[0] = (order >> 4) & 0b11;
+  wire[1] = (order >> 2) & 0b11;
+  wire[2] = order & 0b11;
+  strip.setOutput(this);
+}
+
+NeoPixelDotStar::~NeoPixelDotStar()
+{
+  free(wide);
+}
+
+// Switch to 16-bit colors: allocates 6 bytes per pixel of the strip's
+// current length, all off.  Returns false if there isn't RAM for it.
+bool NeoPixelDotStar::enable16(void)
+{
+  free(wide);
+  if ((wide = (uint16_t *)calloc(strip.numLEDs, 3 * sizeof(uint16_t))))
+  {
+    wideLength = strip.numLEDs;
+    return true;
+  }
+  wideLength = 0;
+  return false;
+}
+
+// Back to sending the strip's own 8-bit buffer
+void NeoPixelDotStar::disable16(void)
+{
+  free(wide);
+  wide = NULL;
+  wideLength = 0;
+}
+
+// Set a pixel from 16-bit linear R,G,B (0-65535); only after enable16()
+void NeoPixelDotStar::setPixelColor16(uint16_t n, uint16_t r, uint16_t g, uint16_t b)
+{
+  if (n < wideLength)
+  {
+    uint16_t *p = &wide[n * 3];
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+    strip.setDirty(n, 1);
+  }
+}
+
+// Fill 'count' pixels from 'first' ('count' of 0 = to end) with one
+// 16-bit color; fill16(0, 0, 0) clears the strip
+void NeoPixelDotStar::fill16(uint16_t r, uint16_t g, uint16_t b, uint16_t first, uint16_t count)
+{
+  if (first >= wideLength)
+    return;
+  if (!count || (count > (wideLength - first)))
+    count = wideLength - first;
+  strip.setDirty(first, count);
+  for (uint16_t *p = &wide[first * 3]; count--; p += 3)
+  {
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+  }
+}
+
+// Called by the strip's begin()
+void NeoPixelDotStar::begin(void)
+{
+  if (spi)
+  {
+    spi->begin();
+    return;
+  }
+  pinMode(dataPin, OUTPUT);
+  pinMode(clockPin, OUTPUT);
+  digitalWrite(dataPin, LOW);
+  digitalWrite(clockPin, LOW);
+#ifdef __AVR__
+  dataPort = portOutputRegister(digitalPinToPort(dataPin));
+  dataMask = digitalPinToBitMask(dataPin);
+  clockPort = portOutputRegister(digitalPinToPort(clockPin));
+  clockMask = digitalPinToBitMask(clockPin);
+#endif
+}
+
+// Send 'n' bytes over hardware SPI (which overwrites 'buf' with what's
+// read back), or bit-banged MSB first with data changing while clock
+// is low (mode 0)
+void NeoPixelDotStar::send(uint8_t *buf, uint16_t n)
+{
+  if (spi)
+  {
+    spi->transfer(buf, n);
+    return;
+  }
+  while (n--)
+  {
+    uint8_t b = *buf++;
+    for (uint8_t bit = 0x80; bit; bit >>= 1)
+    {
+#ifdef __AVR__
+      if (b & bit)
+        *dataPort |= dataMask;
+      else
+        *dataPort &= ~dataMask;
+      *clockPort |= clockMask;
+      *clockPort &= ~clockMask;
+#else
+      digitalWrite(dataPin, (b & bit) ? HIGH : LOW);
+      digitalWrite(clockPin, HIGH);
+      digitalWrite(clockPin, LOW);
+#endif
+    }
+  }
+}
+
+void NeoPixelDotStar::sendRepeat(uint8_t c, uint16_t n)
+{
+  uint8_t buf[CHUNK_LEDS * 4];
+  for (uint16_t k; n; n -= k)
+  {
+    k = (n < sizeof(buf)) ? n : sizeof(buf);
+    memset(buf, c, k); // Every time; send() may overwrite it
+    send(buf, k);
+  }
+}
+
+// Convert 'n' 16-bit pixels from 'first' into LED words in 'buf'.
+// Working in units where the brightest output (level 'global' at PWM
+// 255) is G*255, a channel v is T = v * G * 255 / 65535, held with 8
+// fraction bits.  The level for the pixel is the lowest c at which its
+// brightest channel rounds to no more than 255 PWM, i.e. T/c < 255.5,
+// and each channel is round(T / c).  Choosing c this way keeps output
+// monotonic across level changes: just past a step, c+1 times the
+// rounded PWM is never below the c*255 just before it.
+uint16_t NeoPixelDotStar::encode16(uint8_t *buf, uint16_t first, uint16_t n)
+{
+  const uint16_t *src = &wide[first * 3];
+  uint8_t g = global, *p = buf;
+
+  for (uint16_t i = 0; i < n; i++, src += 3, p += 4)
+  {
+    uint32_t t[3], m;
+    for (uint8_t k = 0; k < 3; k++)
+    { // v*G*65280/65535, non-decreasing in v, without overflow
+      uint32_t x = (uint32_t)src[k] * g;
+      t[k] = x - (x * 255 + 32767) / 65535;
+    }
+    m = (t[0] > t[1]) ? t[0] : t[1];
+    if (t[2] > m)
+      m = t[2];
+    uint8_t c = (m * 2) / (511 * 256) + 1;
+    if (c > g)
+      c = g; // Only when g is 0: all off
+    uint32_t r = pgm_read_dword(&_DotStarReciprocal[c]);
+    p[0] = 0xE0 | c;
+    for (uint8_t k = 0; k < 3; k++)
+      p[1 + wire[k]] = (uint8_t)((((uint64_t)(t[k] + 128 * c) * r) >> 31) >> 8);
+  }
+  return n * 4;
+}
+
+// APA102 words from the strip buffer; 16-bit strips send the most
+// significant byte of each channel.  White channels (RGBW, RGBWW) are
+// skipped over.
+uint16_t NeoPixelDotStar::encode8(uint8_t *buf, const uint8_t *src, uint16_t n)
+{
+#ifdef NEO_16BIT
+  uint8_t s = strip.is16Bit() ? 1 : 0; // Not pixelBytes(): RGBWW is 5
+#else
+  uint8_t s = 0;
+#endif
+  uint8_t bpp = strip.pixelBytes(),
+          r = strip.rOffset << s, g = strip.gOffset << s, b = strip.bOffset << s,
+          head = 0xE0 | global, *p = buf;
+
+  for (uint16_t i = 0; i < n; i++, src += bpp, p += 4)
+  {
+    p[0] = head;
+    p[1 + wire[0]] = src[r];
+    p[1 + wire[1]] = src[g];
+    p[1 + wire[2]] = src[b];
+  }
+  return n * 4;
+}
+
+// HD108 words: a start bit and three 5-bit gains (R, G, B), then 16-bit
+// channels in wire order.  Values come from 'w', the 16-bit buffer,
+// if not NULL, else the strip's buffer -- as is from a NEO_16BIT strip,
+// or widened (x * 257) from an 8-bit one.
+uint16_t NeoPixelDotStar::encodeHD108(uint8_t *buf, const uint8_t *src, const uint16_t *w, uint16_t n)
+{
+  uint8_t bpp = strip.pixelBytes(),
+          h0 = 0x80 | (gain[0] << 2) | (gain[1] >> 3),
+          h1 = (gain[1] << 5) | gain[2], *p = buf,
+          o[3] = {strip.rOffset, strip.gOffset, strip.bOffset};
+#ifdef NEO_16BIT
+  bool wide16 = strip.is16Bit();
+#else
+  bool wide16 = false;
+#endif
+
+  for (uint16_t i = 0; i < n; i++, src += bpp, p += 8)
+  {
+    p[0] = h0;
+    p[1] = h1;
+    for (uint8_t k = 0; k < 3; k++)
+    {
+      uint8_t *d = &p[2 + wire[k] * 2];
+      if (w)
+      {
+        d[0] = w[k] >> 8;
+        d[1] = w[k];
+      }
+      else if (wide16)
+      {
+        d[0] = src[o[k] * 2];
+        d[1] = src[o[k] * 2 + 1];
+      }
+      else
+      {
+        d[0] = d[1] = src[o[k]];
+      }
+    }
+    if (w)
+      w += 3;
+  }
+  return n * 8;
+}
+
+// Issue one frame: a start frame of zeros (32 bits for APA102, 128 for
+// HD108), a word per LED, then enough clock edges to push data through
+// the chain.  Each LED delays data by half a clock, so n/2 extra
+// clocks are needed; SK9822 parts also latch on a further 32 zero
+// bits.  Zeros are used for both, so LEDs past the end of the chain
+// stay off.
+void NeoPixelDotStar::write(const uint8_t *pixels, uint16_t numBytes)
+{
+  uint8_t buf[CHUNK_LEDS * 8];
+  uint8_t bpp = strip.pixelBytes();
+  uint16_t n = numBytes / bpp;
+  bool fromWide = wide && (n <= wideLength);
+
+  if (spi)
+    spi->beginTransaction(SPISettings(hz, MSBFIRST, SPI_MODE0));
+  sendRepeat(0x00, (chip == NEO_DOTSTAR_HD108) ? 16 : 4);
+
+  for (uint16_t i = 0, k; i < n; i += k)
+  {
+    k = ((n - i) < CHUNK_LEDS) ? (n - i) : CHUNK_LEDS;
+    if (chip == NEO_DOTSTAR_HD108)
+      send(buf, encodeHD108(buf, &pixels[i * bpp], fromWide ? &wide[i * 3] : NULL, k));
+    else if (fromWide)
+      send(buf, encode16(buf, i, k));
+    else
+      send(buf, encode8(buf, &pixels[i * bpp], k));
+  }
+
+  sendRepeat(0x00, 4 + (n + 15) / 16); // End frame
+  if (spi)
+    spi->endTransaction();
+}
@@ -0,0 +1,126 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_DOTSTAR_H
+#define NEOPIXEL_DOTSTAR_H
+
+#include "Adafruit_NeoPixel.h"
+#include <SPI.h>
+
+#define NEO_DOTSTAR_HZ 8000000L // Default hardware SPI clock
+
+// Chips for setChip()
+#define NEO_DOTSTAR_APA102 0 // APA102, SK9822 and clones: 8-bit channels
+#define NEO_DOTSTAR_HD108 1  // 16-bit channels, 5-bit gain per channel
+
+// NeoPixelDotStar drives APA102 / SK9822 ("DotStar") LEDs from an
+// ordinary Adafruit_NeoPixel object: attach it and the strip's usual
+// calls -- setPixelColor(), fill(), show() and the rest -- work
+// unchanged, but show() clocks data out over hardware SPI or two bit-
+// banged pins instead of the timing-critical single-wire signal, with
+// interrupts left on.  Declare the strip with pin -1 and any 3-byte
+// color order (the W bytes of RGBW and RGBWW types are not sent); the
+// driver maps it to the LEDs' wire order (blue, green, red for genuine
+// parts), and adds the start frame, per-LED header and end frame.
+//
+// Each LED's header carries a 5-bit global brightness that scales
+// current in the LED itself, so dimming with setGlobalBrightness()
+// loses none of the 8-bit color resolution the way setBrightness()
+// does.  SK9822 parts apply it as a true current setting; APA102
+// parts as a slow PWM, which may flicker on camera at low settings.
+//
+// After enable16(), colors are instead kept as 16-bit linear values
+// (setPixelColor16(), fill16()) and the strip's 8-bit buffer is not
+// sent.  At show time each pixel is split into the lowest 5-bit level
+// that holds its brightest channel plus 8-bit PWM values rounded at
+// that level, for roughly 13 bits of range: fine steps near black,
+// where 8 bits alone are coarsest.  Output never decreases as a value
+// rises.  setGlobalBrightness() then sets the level for full scale.
+//
+// HD108 chips (setChip(NEO_DOTSTAR_HD108), usually with wire order
+// NEO_RGB) take 16-bit channels plus a 5-bit current gain for each
+// of R, G and B in every LED's header: setGains() for white balance,
+// or setGlobalBrightness() for all three.  Data comes from a NEO_16BIT
+// strip's buffer as is, from an 8-bit strip widened, or from the
+// 16-bit buffer if enabled (sent without the level splitting above).
+class NeoPixelDotStar : public NeoPixelOutput
+{
+
+  public:
+    NeoPixelDotStar(Adafruit_NeoPixel &strip, int8_t dataPin, int8_t clockPin,
+                    neoPixelType order = NEO_BGR);
+    NeoPixelDotStar(Adafruit_NeoPixel &strip, SPIClass &spi = SPI,
+                    uint32_t hz = NEO_DOTSTAR_HZ, neoPixelType order = NEO_BGR);
+    ~NeoPixelDotStar();
+
+    void begin(void);
+    void write(const uint8_t *pixels, uint16_t numBytes);
+    void setChip(uint8_t c) { chip = c; }
+    void setGlobalBrightness(uint8_t b)
+    {
+      global = (b > 31) ? 31 : b;
+      gain[0] = gain[1] = gain[2] = global;
+    }
+    void setGains(uint8_t r, uint8_t g, uint8_t b)
+    {
+      gain[0] = (r > 31) ? 31 : r;
+      gain[1] = (g > 31) ? 31 : g;
+      gain[2] = (b > 31) ? 31 : b;
+    }
+    uint8_t getGlobalBrightness(void) const { return global; }
+    bool enable16(void);
+    void disable16(void);
+    bool is16(void) const { return wide != NULL; }
+    void setPixelColor16(uint16_t n, uint16_t r, uint16_t g, uint16_t b);
+    void fill16(uint16_t r, uint16_t g, uint16_t b, uint16_t first = 0, uint16_t count = 0);
+
+  private:
+    uint16_t encode8(uint8_t *buf, const uint8_t *src, uint16_t n);
+    uint16_t encode16(uint8_t *buf, uint16_t first, uint16_t n);
+    uint16_t encodeHD108(uint8_t *buf, const uint8_t *src, const uint16_t *w, uint16_t n);
+    void send(uint8_t *buf, uint16_t n);
+    void sendRepeat(uint8_t c, uint16_t n);
+
+    Adafruit_NeoPixel
+        &strip;
+    SPIClass
+        *spi; // Hardware SPI, or NULL to bit-bang
+    uint16_t
+        *wide,      // 16-bit R,G,B per pixel after enable16(), else NULL
+        wideLength; // Pixels in 'wide'
+    uint32_t
+        hz;
+    int8_t
+        dataPin,
+        clockPin;
+    uint8_t
+        wire[3], // Wire position (after header) of R, G, B
+        global,  // 5-bit brightness in each LED header (0-31)
+        chip,    // NEO_DOTSTAR_*
+        gain[3]; // HD108 5-bit R, G, B gains
+#ifdef __AVR__
+    volatile uint8_t
+        *dataPort,
+        *clockPort;
+    uint8_t
+        dataMask,
+        clockMask;
+#endif
+};
+
+#endif // NEOPIXEL_DOTSTAR_H
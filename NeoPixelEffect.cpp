@@ -0,0 +1,130 @@
+/*-------------------------------------------------------------------------
+  Non-blocking effect engine for the Adafruit NeoPixel library.  Runs
+  animations as time-stepped state machines instead of delay() loops.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelEffect.h"
+
+NeoPixelEffect::NeoPixelEffect(Adafruit_NeoPixel &s, uint32_t intervalMicros) : strip(s), interval(intervalMicros), next(0), step(0), frames(0), overruns(0), started(false), done(false), looping(false)
+{
+}
+
+// Start over from frame 0; the first frame is shown on the next update().
+void NeoPixelEffect::restart(void)
+{
+  step = 0;
+  started = done = false;
+}
+
+// Call from loop() as often as possible.  Renders and shows the next
+// frame if it's due and the strip can accept it; returns true if a
+// frame was shown.
+bool NeoPixelEffect::update(uint32_t now)
+{
+  if (done)
+    return false;
+  if (!started)
+  {
+    next = now;
+    started = true;
+  }
+  if ((int32_t)(now - next) < 0)
+    return false; // Not time yet
+  if (!strip.canShow())
+    return false; // Still latching; frame stays due until next call
+
+  bool more = render(step);
+  strip.show();
+  frames++;
+  if (more)
+  {
+    step++;
+  }
+  else if (looping)
+  {
+    step = 0;
+  }
+  else
+  {
+    done = true;
+    return true;
+  }
+
+  if ((now - next) >= interval)
+  { // Fell a whole frame behind; resync rather than rushing frames out
+    overruns++;
+    next = now;
+  }
+  next += interval;
+  return true;
+}
+
+bool NeoPixelEffect::hasWhite(void) const
+{
+  return strip.wOffset != strip.rOffset;
+}
+
+// STRANDTEST EFFECTS -----------------------------------------------------
+
+bool NeoPixelColorWipe::render(uint32_t step)
+{
+  if (!step)
+    strip.clear();
+  strip.setPixelColor(step, color);
+  return (step + 1) < strip.numPixels();
+}
+
+bool NeoPixelRainbow::render(uint32_t step)
+{
+  // The examples' Wheel() has 256 positions; ColorHSV() hues are 16 bit
+  uint16_t n = strip.numPixels(),
+           hueStep = (spread && n) ? (65536UL / n) : 256;
+  strip.fillRainbow(0, 0, (uint16_t)(step << 8), hueStep);
+  return (step + 1) < ((uint32_t)cycles * 256);
+}
+
+bool NeoPixelTheaterChase::render(uint32_t step)
+{
+  // Three frames per chase cycle, lighting every third pixel from
+  // offset 0, 1, 2.  The rainbow variant advances the wheel once per
+  // cycle, over 256 cycles.
+  uint16_t n = strip.numPixels(), i;
+  uint8_t q = step % 3;
+  uint16_t j = step / 3;
+
+  strip.clear();
+  for (i = q; i < n; i += 3)
+  {
+    if (color == NEO_EFFECT_RAINBOW)
+      strip.setPixelColor(i, Adafruit_NeoPixel::ColorHSV((uint16_t)((i + j) & 255) << 8));
+    else
+      strip.setPixelColor(i, color);
+  }
+  return (step + 1) < (3UL * ((color == NEO_EFFECT_RAINBOW) ? 256 : cycles));
+}
+
+bool NeoPixelPulseWhite::render(uint32_t step)
+{
+  // 256 frames up, then 256 down
+  uint8_t v = Adafruit_NeoPixel::gamma8((step < 256) ? step : (511 - step));
+  strip.fill(hasWhite() ? Adafruit_NeoPixel::Color(0, 0, 0, v)
+                        : Adafruit_NeoPixel::Color(v, v, v));
+  return (step + 1) < 512;
+}
@@ -0,0 +1,147 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_EFFECT_H
+#define NEOPIXEL_EFFECT_H
+
+#include "Adafruit_NeoPixel.h"
+
+// NeoPixelEffect is the base for non-blocking animations.  An effect is
+// a sequence of numbered frames; update() -- called from loop() as
+// often as convenient -- renders and shows the next frame once its
+// time has come and the strip is ready (canShow()), and otherwise
+// returns immediately, so the sketch stays free to service serial,
+// network, buttons, etc. between frames.  Frame timing is kept against
+// a schedule rather than the time of the last frame, so occasional late
+// calls don't slow the animation; if the sketch falls a whole frame or
+// more behind, the schedule resyncs instead of bursting to catch up.
+//
+// Subclasses implement render(step), drawing frame 'step' (0, 1, 2...)
+// into the strip and returning false once it has drawn the last frame.
+class NeoPixelEffect
+{
+
+  public:
+    NeoPixelEffect(Adafruit_NeoPixel &strip, uint32_t intervalMicros);
+    virtual ~NeoPixelEffect() {}
+
+    bool update(void) { return update(micros()); }
+    bool update(uint32_t now);
+    void restart(void);
+    void setInterval(uint32_t us) { interval = us; }
+    uint32_t getInterval(void) const { return interval; }
+    void setLoop(bool l) { looping = l; }
+    bool isDone(void) const { return done; }
+    uint32_t getStep(void) const { return step; }
+    uint32_t getFrames(void) const { return frames; }
+    uint32_t getOverruns(void) const { return overruns; }
+
+  protected:
+    virtual bool render(uint32_t step) = 0;
+    bool hasWhite(void) const;
+
+    Adafruit_NeoPixel
+        &strip;
+
+  private:
+    uint32_t
+        interval,  // Microseconds between frames
+        next,      // micros() at which the next frame is due
+        step,      // Next frame number to render
+        frames,    // Frames rendered since construction
+        overruns;  // Times the schedule fell a whole frame behind
+    boolean
+        started, // false until first update() after (re)start
+        done,    // true once the last frame has been shown
+        looping; // Restart at frame 0 after the last frame
+};
+
+// Ports of the blocking animations in the strandtest examples.  'wait'
+// arguments there (milliseconds per frame) become the interval here.
+
+// Light pixels one after the other with a color (colorWipe()).
+class NeoPixelColorWipe : public NeoPixelEffect
+{
+
+  public:
+    NeoPixelColorWipe(Adafruit_NeoPixel &strip, uint32_t c, uint32_t intervalMicros)
+        : NeoPixelEffect(strip, intervalMicros), color(c) {}
+    void setColor(uint32_t c) { color = c; }
+
+  protected:
+    bool render(uint32_t step);
+
+  private:
+    uint32_t color;
+};
+
+// Moving rainbow.  With 'spread' false, adjacent pixels are 1/256 of
+// the color wheel apart (rainbow()); with 'spread' true, the wheel is
+// stretched across the whole strip (rainbowCycle()).  'cycles' full
+// turns of the wheel are run before the effect is done.
+class NeoPixelRainbow : public NeoPixelEffect
+{
+
+  public:
+    NeoPixelRainbow(Adafruit_NeoPixel &strip, uint32_t intervalMicros,
+                    bool s = false, uint8_t n = 1)
+        : NeoPixelEffect(strip, intervalMicros), spread(s), cycles(n) {}
+
+  protected:
+    bool render(uint32_t step);
+
+  private:
+    boolean spread;
+    uint8_t cycles;
+};
+
+// Theater-style crawling lights, every third pixel lit (theaterChase()),
+// or in rainbow colors cycling the wheel once if 'color' is
+// NEO_EFFECT_RAINBOW (theaterChaseRainbow()).
+#define NEO_EFFECT_RAINBOW 0xFFFFFFFF
+
+class NeoPixelTheaterChase : public NeoPixelEffect
+{
+
+  public:
+    NeoPixelTheaterChase(Adafruit_NeoPixel &strip, uint32_t c, uint32_t intervalMicros,
+                         uint8_t n = 10)
+        : NeoPixelEffect(strip, intervalMicros), color(c), cycles(n) {}
+
+  protected:
+    bool render(uint32_t step);
+
+  private:
+    uint32_t color;
+    uint8_t cycles;
+};
+
+// Gamma-corrected fade of the white channel up and back down
+// (pulseWhite()).  On RGB strips, R, G and B are faded together.
+class NeoPixelPulseWhite : public NeoPixelEffect
+{
+
+  public:
+    NeoPixelPulseWhite(Adafruit_NeoPixel &strip, uint32_t intervalMicros)
+        : NeoPixelEffect(strip, intervalMicros) {}
+
+  protected:
+    bool render(uint32_t step);
+};
+
+#endif // NEOPIXEL_EFFECT_H
@@ -0,0 +1,167 @@
+/*-------------------------------------------------------------------------
+  Multi-strip scheduler for the Adafruit NeoPixel library.  Interleaves
+  show() across several strips on different pins so that per-strip
+  latch waits overlap, skips unchanged strips and paces output to a
+  target frame rate.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelGroup.h"
+
+NeoPixelGroup::NeoPixelGroup(uint8_t maxStrips) : count(0), period(0), nextFrame(0), frames(0), overruns(0), issued(false)
+{
+  if ((entries = (entry *)malloc(maxStrips * sizeof(entry))))
+    capacity = maxStrips;
+  else
+    capacity = 0;
+}
+
+NeoPixelGroup::~NeoPixelGroup()
+{
+  if (entries)
+    free(entries);
+}
+
+// Add a strip to the group.  Strips of higher priority are issued first
+// each frame and are the last to be deferred when a frame rate is set.
+// Returns false if the group is full.
+bool NeoPixelGroup::add(Adafruit_NeoPixel &strip, uint8_t priority)
+{
+  if (count >= capacity)
+    return false;
+
+  // Insertion keeps the list sorted by descending priority; strips of
+  // equal priority stay in the order they were added.
+  uint8_t i = count++;
+  while (i && (entries[i - 1].priority < priority))
+  {
+    entries[i] = entries[i - 1];
+    i--;
+  }
+  entries[i].strip = &strip;
+  entries[i].priority = priority;
+  memset(&entries[i].stats, 0, sizeof(neoGroupStats));
+  return true;
+}
+
+void NeoPixelGroup::begin(void)
+{
+  for (uint8_t i = 0; i < count; i++)
+    entries[i].strip->begin();
+}
+
+// Pace update() to 'fps' frames per second; 0 issues a frame on every
+// call to update().
+void NeoPixelGroup::setFrameRate(uint16_t fps)
+{
+  period = fps ? (1000000UL / fps) : 0;
+  nextFrame = micros();
+}
+
+// Call from loop() as often as possible.  Issues a frame if one is due
+// and returns true if any strip was shown.
+bool NeoPixelGroup::update(uint32_t now)
+{
+  if (period)
+  {
+    if ((int32_t)(now - nextFrame) < 0)
+      return false; // Not time yet
+    if ((now - nextFrame) >= period)
+    { // Fell more than a whole frame behind; resync rather than
+      // issuing a burst of back-to-back catch-up frames.
+      overruns++;
+      nextFrame = now;
+    }
+    nextFrame += period;
+  }
+  show();
+  return issued;
+}
+
+// Issue one frame to all dirty strips now, regardless of frame pacing.
+void NeoPixelGroup::show(void)
+{
+  uint32_t start = micros();
+  uint8_t i, j, k, pass;
+
+  issued = false;
+  for (i = 0; i < count; i = j)
+  {
+    // Strips are reordered only among equal priority, so a low-priority
+    // strip never takes budget ahead of a higher one.  Within the level,
+    // the first pass takes strips that can be issued immediately and the
+    // second pass picks up those that were still latching.
+    for (j = i + 1; (j < count) && (entries[j].priority == entries[i].priority); j++)
+      ;
+    for (pass = 0; pass < 2; pass++)
+    {
+      for (k = i; k < j; k++)
+      {
+        entry &e = entries[k];
+        if (!e.strip->isDirty())
+        {
+          if (!pass)
+            e.stats.skipped++;
+          continue;
+        }
+        if (!pass && !e.strip->canShow())
+          continue;
+        if (period && issued &&
+            ((micros() - start) + e.stats.lastTime > period))
+        { // Wouldn't finish within the frame; leave it dirty for next time
+          if (pass)
+            e.stats.deferred++;
+          continue;
+        }
+        issue(e);
+      }
+    }
+  }
+  frames++;
+}
+
+void NeoPixelGroup::issue(entry &e)
+{
+  uint32_t t = micros();
+  e.strip->show();
+  t = micros() - t;
+  e.stats.frames++;
+  e.stats.lastTime = t;
+  e.stats.totalTime += t;
+  if (t > e.stats.maxTime)
+    e.stats.maxTime = t;
+  issued = true;
+}
+
+Adafruit_NeoPixel *NeoPixelGroup::getStrip(uint8_t i) const
+{
+  return (i < count) ? entries[i].strip : NULL;
+}
+
+const neoGroupStats *NeoPixelGroup::getStats(uint8_t i) const
+{
+  return (i < count) ? &entries[i].stats : NULL;
+}
+
+void NeoPixelGroup::resetStats(void)
+{
+  for (uint8_t i = 0; i < count; i++)
+    memset(&entries[i].stats, 0, sizeof(neoGroupStats));
+  frames = overruns = 0;
+}
@@ -0,0 +1,93 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_GROUP_H
+#define NEOPIXEL_GROUP_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Per-strip frame statistics kept by NeoPixelGroup.  Times are in
+// microseconds and cover the strip's own show() call (data + wait for
+// any outstanding latch on that strip).
+typedef struct
+{
+  uint32_t
+      frames,    // Times this strip was issued
+      skipped,   // Frames where strip had no changes and wasn't issued
+      deferred,  // Frames where strip was dirty but didn't fit the budget
+      lastTime,  // Duration of most recent show()
+      maxTime,   // Longest show() seen
+      totalTime; // Sum of all show() durations (for averaging)
+} neoGroupStats;
+
+// NeoPixelGroup coordinates show() across several Adafruit_NeoPixel
+// instances on different pins.  Each strip's show() blocks with
+// interrupts off for the duration of its data, then leaves a latch
+// period that only matters to that strip -- so the group issues strips
+// whose latch has already elapsed first and leaves recently-shown
+// strips for last, letting their latch waits overlap other strips'
+// data.  Strips with no changes since their last show() are skipped.
+// With a frame rate set, update() paces frames and a strip whose last
+// measured show() time would push the frame past its period is
+// deferred to the next frame, lowest priority first.  The group
+// doesn't own the strips; they must outlive it.
+class NeoPixelGroup
+{
+
+  public:
+    NeoPixelGroup(uint8_t maxStrips);
+    ~NeoPixelGroup();
+
+    bool add(Adafruit_NeoPixel &strip, uint8_t priority = 0);
+    void begin(void);
+    bool update(void) { return update(micros()); }
+    bool update(uint32_t now);
+    void show(void);
+    void setFrameRate(uint16_t fps);
+    uint8_t numStrips(void) const { return count; }
+    Adafruit_NeoPixel *getStrip(uint8_t i) const;
+    const neoGroupStats *getStats(uint8_t i) const;
+    uint32_t getFrames(void) const { return frames; }
+    uint32_t getOverruns(void) const { return overruns; }
+    void resetStats(void);
+
+  private:
+    typedef struct
+    {
+      Adafruit_NeoPixel *strip;
+      uint8_t priority; // Higher values are issued (and kept) first
+      neoGroupStats stats;
+    } entry;
+
+    void issue(entry &e);
+
+    entry
+        *entries; // Strips, sorted by descending priority
+    uint8_t
+        count,    // Number of strips added
+        capacity; // Size of 'entries' array
+    uint32_t
+        period,    // Frame period in microseconds (0 = unpaced)
+        nextFrame, // micros() at which update() issues the next frame
+        frames,    // Frames issued
+        overruns;  // Frames that started later than one period late
+    boolean
+        issued; // Set once any strip has been issued in current frame
+};
+
+#endif // NEOPIXEL_GROUP_H
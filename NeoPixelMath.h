@@ -0,0 +1,200 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_MATH_H
+#define NEOPIXEL_MATH_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Which implementation NeoPixelMath uses.  Every one gives the same
+// results for every input; define NEO_MATH_PORTABLE before including
+// this file to use plain C everywhere (e.g. to compare on a target).
+#if defined(NEO_MATH_PORTABLE)
+#elif defined(__AVR__) && defined(__AVR_HAVE_MUL__)
+#define NEO_MATH_AVR // MUL, plus carry branches for saturation
+#elif defined(__ARM_FEATURE_DSP)
+#define NEO_MATH_ARM_DSP // UQADD8/UQSUB8 lanes and SMLAD (Cortex-M4/M7)
+#endif
+
+// NeoPixelMath is a set of small fixed-point color functions, all
+// inline, for effects and helper classes to share instead of each
+// rolling its own.  8-bit fractions run 0-255 with 255 = 1.0 (not 256),
+// and results are correctly rounded, so scale8(x, 255) == x and
+// lerp8(a, b, 255) == b.  Packed colors are 0xWWRRGGBB, as from Color().
+class NeoPixelMath
+{
+
+  public:
+    // x / 255, rounded to nearest, for x in 0-65025 (255 * 255)
+    static inline uint8_t div255(uint16_t x)
+    {
+      x += 128;
+      return (x + (x >> 8)) >> 8;
+    }
+
+    // i * scale / 255, rounded
+    static inline uint8_t scale8(uint8_t i, uint8_t scale)
+    {
+#if defined(NEO_MATH_AVR)
+      uint16_t p;
+      asm("mul %1, %2\n\t"
+          "movw %0, r0\n\t"
+          "clr __zero_reg__"
+          : "=r"(p)
+          : "r"(i), "r"(scale));
+      return div255(p);
+#else
+      return div255(i * scale);
+#endif
+    }
+
+    // i + j, clipped at 255
+    static inline uint8_t qadd8(uint8_t i, uint8_t j)
+    {
+#if defined(NEO_MATH_AVR)
+      asm("add %0, %1\n\t"
+          "brcc 1f\n\t"
+          "ldi %0, 0xFF\n"
+          "1:"
+          : "+d"(i)
+          : "r"(j));
+      return i;
+#elif defined(NEO_MATH_ARM_DSP)
+      uint32_t r;
+      asm("uqadd8 %0, %1, %2" : "=r"(r) : "r"((uint32_t)i), "r"((uint32_t)j));
+      return r;
+#else
+      uint16_t t = i + j;
+      return (t > 255) ? 255 : t;
+#endif
+    }
+
+    // i - j, clipped at 0
+    static inline uint8_t qsub8(uint8_t i, uint8_t j)
+    {
+#if defined(NEO_MATH_AVR)
+      asm("sub %0, %1\n\t"
+          "brcc 1f\n\t"
+          "clr %0\n"
+          "1:"
+          : "+r"(i)
+          : "r"(j));
+      return i;
+#elif defined(NEO_MATH_ARM_DSP)
+      uint32_t r;
+      asm("uqsub8 %0, %1, %2" : "=r"(r) : "r"((uint32_t)i), "r"((uint32_t)j));
+      return r;
+#else
+      return (i > j) ? (i - j) : 0;
+#endif
+    }
+
+    // Saturating add and subtract of each byte of two packed colors
+    static inline uint32_t qadd8x4(uint32_t x, uint32_t y)
+    {
+#if defined(NEO_MATH_ARM_DSP)
+      uint32_t r;
+      asm("uqadd8 %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+      return r;
+#else
+      // Sum low 7 bits of each byte, then fill bytes that carried out
+      uint32_t t = ((x & 0x7F7F7F7F) + (y & 0x7F7F7F7F)) ^ ((x ^ y) & 0x80808080),
+               c = ((x & y) | ((x | y) & ~t)) & 0x80808080;
+      return t | ((c >> 7) * 0xFF);
+#endif
+    }
+
+    static inline uint32_t qsub8x4(uint32_t x, uint32_t y)
+    {
+#if defined(NEO_MATH_ARM_DSP)
+      uint32_t r;
+      asm("uqsub8 %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+      return r;
+#else
+      // Bytewise difference with the high bit borrowed; bytes that
+      // borrowed past it went below zero and are cleared
+      uint32_t t = ((x | 0x80808080) - (y & 0x7F7F7F7F)) ^ ((x ^ ~y) & 0x80808080),
+               b = ((~x & y) | (~(x ^ y) & t)) & 0x80808080;
+      return t & ~((b >> 7) * 0xFF);
+#endif
+    }
+
+    // From 'a' (frac 0) to 'b' (frac 255): (a * (255 - frac) + b * frac)
+    // / 255, rounded
+    static inline uint8_t lerp8(uint8_t a, uint8_t b, uint8_t frac)
+    {
+#if defined(NEO_MATH_ARM_DSP)
+      // Both products and their sum in one SMLAD
+      uint32_t s;
+      asm("smlad %0, %1, %2, %3"
+          : "=r"(s)
+          : "r"(a | ((uint32_t)b << 16)), "r"((255 - frac) | ((uint32_t)frac << 16)), "r"(0));
+      return div255(s);
+#else
+      return div255(a * (255 - frac) + b * frac);
+#endif
+    }
+
+    // 16-bit version: 'frac' 0-65535, 65535 = b, rounded
+    static inline uint16_t lerp16(uint16_t a, uint16_t b, uint16_t frac)
+    {
+      // Fits 32 bits: a * (65535 - frac) + b * frac <= 65535 * 65535
+      uint32_t x = (uint32_t)a * (uint16_t)(65535 - frac) + (uint32_t)b * frac + 32768;
+      return (x + (x >> 16)) >> 16; // / 65535, as div255() for 8 bits
+    }
+
+    // lerp8() of each channel (W, R, G, B) of two packed colors: 'alpha'
+    // 0 = c1, 255 = c2.  Two channels share each multiply.
+    static inline uint32_t blend(uint32_t c1, uint32_t c2, uint8_t alpha)
+    {
+      uint32_t ia = 255 - alpha,
+               lo = (c1 & 0x00FF00FF) * ia + (c2 & 0x00FF00FF) * alpha + 0x00800080,
+               hi = ((c1 >> 8) & 0x00FF00FF) * ia + ((c2 >> 8) & 0x00FF00FF) * alpha + 0x00800080;
+      // div255() in both 16-bit lanes
+      lo = ((lo + ((lo >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+      hi = (hi + ((hi >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+      return hi | lo;
+    }
+
+    // scale8() of each channel of a packed color
+    static inline uint32_t scale8x4(uint32_t c, uint8_t scale)
+    {
+      uint32_t lo = (c & 0x00FF00FF) * scale + 0x00800080,
+               hi = ((c >> 8) & 0x00FF00FF) * scale + 0x00800080;
+      lo = ((lo + ((lo >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+      hi = (hi + ((hi >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+      return hi | lo;
+    }
+
+    // (x * scale) >> 8 for each channel, 'scale' 0-256: the strip's own
+    // brightness arithmetic (see setBrightness()), truncated, so the
+    // result matches setPixelColor() byte for byte
+    static inline uint32_t mul8x4(uint32_t c, uint16_t scale)
+    {
+      return ((((c & 0x00FF00FF) * scale) >> 8) & 0x00FF00FF) |
+             ((((c >> 8) & 0x00FF00FF) * scale) & 0xFF00FF00);
+    }
+
+    // (x + y) / 2 of each channel, rounded down
+    static inline uint32_t avg8x4(uint32_t x, uint32_t y)
+    {
+      return (x & y) + (((x ^ y) >> 1) & 0x7F7F7F7F);
+    }
+};
+
+#endif // NEOPIXEL_MATH_H
@@ -0,0 +1,439 @@
+/*-------------------------------------------------------------------------
+  2D matrix layer for the Adafruit NeoPixel library.  Maps (x,y)
+  coordinates onto strip indices through a precomputed lookup table
+  supporting row/column order, serpentine wiring, tiling and rotation.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelMatrix.h"
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+#ifndef pgm_read_word
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#endif
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#endif
+
+// Constructor for a single matrix:
+NeoPixelMatrix::NeoPixelMatrix(Adafruit_NeoPixel &s, uint16_t mw, uint16_t mh, uint8_t matrixType) : strip(s), lut(NULL), w(mw), h(mh), matrixW(mw), matrixH(mh),
+                                                                                                   type(matrixType), tilesX(1), tilesY(1), rotation(0)
+{
+  buildTable();
+}
+
+// Constructor for a grid of identical matrices ("tiles"), all chained
+// on one strip:
+NeoPixelMatrix::NeoPixelMatrix(Adafruit_NeoPixel &s, uint8_t mw, uint8_t mh, uint8_t tx, uint8_t ty, uint8_t matrixType) : strip(s), lut(NULL), w(mw * tx), h(mh * ty), matrixW(mw), matrixH(mh),
+                                                                                                                           type(matrixType), tilesX(tx), tilesY(ty), rotation(0)
+{
+  buildTable();
+}
+
+NeoPixelMatrix::~NeoPixelMatrix()
+{
+  if (lut)
+    free(lut);
+}
+
+// Rotate the drawing coordinate space by 'r' clockwise quarter turns
+// (as with Adafruit_GFX).  Width and height swap for odd rotations.
+void NeoPixelMatrix::setRotation(uint8_t r)
+{
+  r &= 3;
+  if (r == rotation)
+    return;
+  if ((r ^ rotation) & 1)
+  { // Odd number of quarter turns from current orientation
+    uint16_t t = w;
+    w = h;
+    h = t;
+  }
+  rotation = r;
+  buildTable();
+}
+
+// Map (x,y) in rotated space to a strip index the slow way.  Used to
+// fill the lookup table, or directly if there's no table.
+uint16_t NeoPixelMatrix::remap(int16_t x, int16_t y) const
+{
+  uint16_t rawW = matrixW * tilesX,
+           rawH = matrixH * tilesY,
+           rx, ry, tile, lx, ly, major, minor;
+  uint8_t corner = type & NEO_MATRIX_CORNER;
+
+  switch (rotation)
+  { // Same convention as Adafruit_GFX
+  case 1:
+    rx = rawW - 1 - y;
+    ry = x;
+    break;
+  case 2:
+    rx = rawW - 1 - x;
+    ry = rawH - 1 - y;
+    break;
+  case 3:
+    rx = y;
+    ry = rawH - 1 - x;
+    break;
+  default:
+    rx = x;
+    ry = y;
+    break;
+  }
+
+  // Which tile, and position within that tile
+  major = rx / matrixW; // Tile column for now
+  minor = ry / matrixH; // Tile row
+  lx = rx - major * matrixW;
+  ly = ry - minor * matrixH;
+  if (type & NEO_TILE_RIGHT)
+    major = tilesX - 1 - major;
+  if (type & NEO_TILE_BOTTOM)
+    minor = tilesY - 1 - minor;
+  if (type & NEO_TILE_COLUMNS)
+  {
+    if ((type & NEO_TILE_ZIGZAG) && (major & 1))
+    {
+      minor = tilesY - 1 - minor;
+      corner ^= NEO_MATRIX_CORNER; // Alternate tiles are upside down
+    }
+    tile = major * tilesY + minor;
+  }
+  else
+  {
+    if ((type & NEO_TILE_ZIGZAG) && (minor & 1))
+    {
+      major = tilesX - 1 - major;
+      corner ^= NEO_MATRIX_CORNER;
+    }
+    tile = minor * tilesX + major;
+  }
+
+  // Pixel within the tile
+  if (corner & NEO_MATRIX_RIGHT)
+    lx = matrixW - 1 - lx;
+  if (corner & NEO_MATRIX_BOTTOM)
+    ly = matrixH - 1 - ly;
+  if (type & NEO_MATRIX_COLUMNS)
+  {
+    if ((type & NEO_MATRIX_ZIGZAG) && (lx & 1))
+      ly = matrixH - 1 - ly;
+    return tile * (matrixW * matrixH) + lx * matrixH + ly;
+  }
+  if ((type & NEO_MATRIX_ZIGZAG) && (ly & 1))
+    lx = matrixW - 1 - lx;
+  return tile * (matrixW * matrixH) + ly * matrixW + lx;
+}
+
+void NeoPixelMatrix::buildTable(void)
+{
+  uint16_t x, y, *p;
+
+  if (!lut) // Allocated once; rotation keeps the same number of pixels
+    lut = (uint16_t *)malloc((uint32_t)w * h * sizeof(uint16_t));
+  if ((p = lut))
+  {
+    for (y = 0; y < h; y++)
+    {
+      for (x = 0; x < w; x++)
+        *p++ = remap(x, y);
+    }
+  }
+
+  // Note whether rows (vs columns) are the contiguous direction, so
+  // fills can walk whichever direction yields long runs.
+  if (w > 1)
+  {
+    uint16_t a = XY(0, 0), b = XY(1, 0);
+    rowRuns = (b == a + 1) || (a == b + 1);
+  }
+  else
+  {
+    rowRuns = false;
+  }
+}
+
+void NeoPixelMatrix::drawPixel(int16_t x, int16_t y, uint32_t c)
+{
+  uint16_t i = XY(x, y);
+  if (i != NEO_MATRIX_NONE)
+    strip.setPixelColor(i, c);
+}
+
+void NeoPixelMatrix::drawPixel(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+  uint16_t i = XY(x, y);
+  if (i != NEO_MATRIX_NONE)
+    strip.setPixelColor(i, r, g, b);
+}
+
+uint32_t NeoPixelMatrix::getPixelColor(int16_t x, int16_t y) const
+{
+  uint16_t i = XY(x, y);
+  return (i != NEO_MATRIX_NONE) ? strip.getPixelColor(i) : 0;
+}
+
+// Fill 'len' pixels along a line (already clipped), issuing one fill()
+// for each run of consecutive strip indices in either direction.
+void NeoPixelMatrix::fillLine(int16_t x, int16_t y, int8_t dx, int8_t dy, uint16_t len, uint32_t c)
+{
+  uint16_t first = XY(x, y), last = first, i;
+  int8_t dir = 0; // Direction of current run through strip (0 = unknown)
+
+  while (--len)
+  {
+    x += dx;
+    y += dy;
+    i = XY(x, y);
+    if (!dir && ((i == last + 1) || (i + 1 == last)))
+      dir = (i > last) ? 1 : -1;
+    if (dir && (i == (uint16_t)(last + dir)))
+    {
+      last = i;
+      continue;
+    }
+    if (first <= last)
+      strip.fill(c, first, last - first + 1);
+    else
+      strip.fill(c, last, first - last + 1);
+    first = last = i;
+    dir = 0;
+  }
+  if (first <= last)
+    strip.fill(c, first, last - first + 1);
+  else
+    strip.fill(c, last, first - last + 1);
+}
+
+void NeoPixelMatrix::fillRect(int16_t x, int16_t y, int16_t rw, int16_t rh, uint32_t c)
+{
+  // Clip once up front; lines are then known to be on-matrix
+  if (x < 0)
+  {
+    rw += x;
+    x = 0;
+  }
+  if (y < 0)
+  {
+    rh += y;
+    y = 0;
+  }
+  if ((x + rw) > (int16_t)w)
+    rw = w - x;
+  if ((y + rh) > (int16_t)h)
+    rh = h - y;
+  if ((rw <= 0) || (rh <= 0))
+    return;
+
+  int16_t i;
+  if (rowRuns)
+  {
+    for (i = 0; i < rh; i++)
+      fillLine(x, y + i, 1, 0, rw, c);
+  }
+  else
+  {
+    for (i = 0; i < rw; i++)
+      fillLine(x + i, y, 0, 1, rh, c);
+  }
+}
+
+void NeoPixelMatrix::fillScreen(uint32_t c)
+{
+  // Every layout covers strip pixels 0 to w*h-1 exactly once
+  strip.fill(c, 0, w * h);
+}
+
+// Destination state for drawBitmap(), resolved once per call
+typedef struct
+{
+  Adafruit_NeoPixel *strip;
+  uint8_t *pixels, bpp, r, g, b, w, w2, brightness;
+  uint16_t alpha, // 1-256
+      count;      // Strip length: cells past it (w*h too big) are skipped
+  bool wide;      // NEO_16BIT strip: stored through setPixelColor()
+} blitTarget;
+
+// Store one source color at strip pixel 'i': scale to strip brightness
+// and, if translucent, blend with what's there.  Stored values are
+// already brightness-scaled, and scaling is linear, so blending the
+// scaled source with them directly is equivalent to blending first.
+static inline void blitPixel(const blitTarget &t, uint16_t i, uint8_t r, uint8_t g, uint8_t b)
+{
+  if (i >= t.count)
+    return;
+  if (t.wide)
+  { // 16-bit pixels: the strip scales, widens and places them itself
+    uint8_t w = 0;
+    if (t.alpha < 256)
+    {
+      uint16_t ia = 256 - t.alpha;
+      uint32_t c = t.strip->getPixelColor(i);
+      r = (r * t.alpha + (uint8_t)(c >> 16) * ia) >> 8;
+      g = (g * t.alpha + (uint8_t)(c >> 8) * ia) >> 8;
+      b = (b * t.alpha + (uint8_t)c * ia) >> 8;
+      w = ((c >> 24) * ia) >> 8;
+    }
+    t.strip->setPixelColor(i, r, g, b, w);
+    return;
+  }
+  uint8_t *p = &t.pixels[i * t.bpp];
+  t.strip->setDirty(i, 1); // Only does more than flag if snapshot held
+  if (t.brightness)
+  { // See notes in Adafruit_NeoPixel::setBrightness()
+    r = (r * t.brightness) >> 8;
+    g = (g * t.brightness) >> 8;
+    b = (b * t.brightness) >> 8;
+  }
+  if (t.alpha < 256)
+  {
+    uint16_t ia = 256 - t.alpha;
+    p[t.r] = (r * t.alpha + p[t.r] * ia) >> 8;
+    p[t.g] = (g * t.alpha + p[t.g] * ia) >> 8;
+    p[t.b] = (b * t.alpha + p[t.b] * ia) >> 8;
+    if (t.bpp >= 4)
+      p[t.w] = (p[t.w] * ia) >> 8; // R,G,B only -- fade W toward 0
+    if (t.bpp == 5)
+      p[t.w2] = (p[t.w2] * ia) >> 8;
+  }
+  else
+  {
+    p[t.r] = r;
+    p[t.g] = g;
+    p[t.b] = b;
+    if (t.bpp >= 4)
+      p[t.w] = 0;
+    if (t.bpp == 5)
+      p[t.w2] = 0;
+  }
+}
+
+// Draw a bitmap with its top-left corner at (x,y).  Clipping is worked
+// out once for the whole bitmap, then each visible row is converted
+// straight into the strip's byte order and brightness.  'alpha' (0-255)
+// blends the whole bitmap over existing contents; 'color' is the color
+// drawn for set bits of a NEO_BITMAP_MASK bitmap (clear bits are left
+// untouched).  Bitmaps in PROGMEM are read with pgm_read_*() on AVR.
+void NeoPixelMatrix::drawBitmap(int16_t x, int16_t y, const neoBitmap &bmp, uint8_t alpha, uint32_t color)
+{
+  int16_t sx0 = 0, sy0 = 0, cols = bmp.width, rows = bmp.height, col;
+  if (x < 0)
+    sx0 = -x;
+  if (y < 0)
+    sy0 = -y;
+  if ((x + cols) > (int16_t)w)
+    cols = w - x;
+  if ((y + rows) > (int16_t)h)
+    rows = h - y;
+  if ((cols <= sx0) || (rows <= sy0) || !alpha || !strip.pixels)
+    return;
+
+  blitTarget t;
+  t.strip = &strip;
+  t.pixels = strip.pixels;
+  t.bpp = strip.pixelBytes();
+  t.r = strip.rOffset;
+  t.g = strip.gOffset;
+  t.b = strip.bOffset;
+  t.w = strip.wOffset;
+  t.w2 = strip.w2Offset;
+#ifdef NEO_16BIT
+  t.wide = strip.is16Bit();
+#else
+  t.wide = false;
+#endif
+  t.brightness = strip.brightness;
+  t.alpha = alpha + 1;
+  t.count = strip.numLEDs;
+
+  boolean pgm = bmp.format & NEO_BITMAP_PROGMEM;
+  uint8_t format = bmp.format & NEO_BITMAP_FORMAT,
+          cr = (uint8_t)(color >> 16),
+          cg = (uint8_t)(color >> 8),
+          cb = (uint8_t)color;
+  uint16_t stride; // Bytes per source row
+  switch (format)
+  {
+  case NEO_BITMAP_RGB888:
+    stride = bmp.width * 3;
+    break;
+  case NEO_BITMAP_RGB565:
+    stride = bmp.width * 2;
+    break;
+  case NEO_BITMAP_MASK:
+    stride = (bmp.width + 7) / 8;
+    break;
+  default:
+    stride = bmp.width;
+    break;
+  }
+
+  for (int16_t row = sy0; row < rows; row++)
+  {
+    const uint8_t *src = (const uint8_t *)bmp.data + (uint32_t)row * stride;
+    int16_t dy = y + row;
+    // Format is tested per row rather than per pixel
+    switch (format)
+    {
+    case NEO_BITMAP_RGB888:
+      src += sx0 * 3;
+      for (col = sx0; col < cols; col++, src += 3)
+      {
+        if (pgm)
+          blitPixel(t, XY(x + col, dy), pgm_read_byte(src),
+                    pgm_read_byte(src + 1), pgm_read_byte(src + 2));
+        else
+          blitPixel(t, XY(x + col, dy), src[0], src[1], src[2]);
+      }
+      break;
+    case NEO_BITMAP_RGB565:
+      src += sx0 * 2;
+      for (col = sx0; col < cols; col++, src += 2)
+      {
+        uint16_t c = pgm ? pgm_read_word(src) : *(const uint16_t *)src;
+        blitPixel(t, XY(x + col, dy),
+                  ((c >> 8) & 0xF8) | (c >> 13),
+                  ((c >> 3) & 0xFC) | ((c >> 9) & 0x03),
+                  (c << 3) | ((c >> 2) & 0x07));
+      }
+      break;
+    case NEO_BITMAP_MASK:
+      for (col = sx0; col < cols; col++)
+      {
+        uint8_t bits = pgm ? pgm_read_byte(src + (col >> 3)) : src[col >> 3];
+        if (bits & (0x80 >> (col & 7)))
+          blitPixel(t, XY(x + col, dy), cr, cg, cb);
+      }
+      break;
+    default: // NEO_BITMAP_PALETTE
+      src += sx0;
+      for (col = sx0; col < cols; col++)
+      {
+        uint8_t i = pgm ? pgm_read_byte(src++) : *src++;
+        uint32_t c = pgm ? pgm_read_dword(&bmp.palette[i]) : bmp.palette[i];
+        blitPixel(t, XY(x + col, dy),
+                  (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+      }
+      break;
+    }
+  }
+}
@@ -0,0 +1,138 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_MATRIX_H
+#define NEOPIXEL_MATRIX_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Matrix layout is described by adding together one of each of these
+// (values match the Adafruit_NeoMatrix library, so sketches can use
+// either).  Position of the FIRST pixel in the matrix:
+#ifndef NEO_MATRIX_TOP
+#define NEO_MATRIX_TOP 0x00    // Pixel 0 is at top of matrix
+#define NEO_MATRIX_BOTTOM 0x01 // Pixel 0 is at bottom of matrix
+#define NEO_MATRIX_LEFT 0x00   // Pixel 0 is at left of matrix
+#define NEO_MATRIX_RIGHT 0x02  // Pixel 0 is at right of matrix
+#define NEO_MATRIX_CORNER 0x03 // Bitmask for pixel 0 matrix corner
+// Pixels are arranged in horizontal rows or vertical columns:
+#define NEO_MATRIX_ROWS 0x00    // Matrix is row major (horizontal)
+#define NEO_MATRIX_COLUMNS 0x04 // Matrix is column major (vertical)
+#define NEO_MATRIX_AXIS 0x04    // Bitmask for row/column layout
+// All rows/columns run the same direction, or alternate (serpentine):
+#define NEO_MATRIX_PROGRESSIVE 0x00 // Same pixel order across each line
+#define NEO_MATRIX_ZIGZAG 0x08      // Pixel order reverses between lines
+#define NEO_MATRIX_SEQUENCE 0x08    // Bitmask for pixel line order
+// Same three fields for panels tiled into a larger display.  With
+// NEO_TILE_ZIGZAG, alternate tiles are rotated 180 degrees.
+#define NEO_TILE_TOP 0x00         // First tile is at top of matrix
+#define NEO_TILE_BOTTOM 0x10      // First tile is at bottom of matrix
+#define NEO_TILE_LEFT 0x00        // First tile is at left of matrix
+#define NEO_TILE_RIGHT 0x20       // First tile is at right of matrix
+#define NEO_TILE_CORNER 0x30      // Bitmask for first tile corner
+#define NEO_TILE_ROWS 0x00        // Tiles ordered in rows
+#define NEO_TILE_COLUMNS 0x40     // Tiles ordered in columns
+#define NEO_TILE_AXIS 0x40        // Bitmask for tile H/V orientation
+#define NEO_TILE_PROGRESSIVE 0x00 // Same tile order across each line
+#define NEO_TILE_ZIGZAG 0x80      // Tile order reverses between lines
+#define NEO_TILE_SEQUENCE 0x80    // Bitmask for tile line order
+#endif
+
+#define NEO_MATRIX_NONE 0xFFFF // XY() result for off-matrix coordinates
+
+// Source formats for drawBitmap().  Rows are stored top to bottom with
+// no padding, except NEO_BITMAP_MASK rows which are padded to a whole
+// byte (as with Adafruit_GFX::drawBitmap()).
+#define NEO_BITMAP_RGB888 0x00  // 3 bytes/pixel: R, G, B
+#define NEO_BITMAP_RGB565 0x01  // 1 uint16_t/pixel, as Adafruit_GFX
+#define NEO_BITMAP_MASK 0x02    // 1 bit/pixel, MSB first; 1 = draw color
+#define NEO_BITMAP_PALETTE 0x03 // 1 byte/pixel index into 'palette'
+#define NEO_BITMAP_FORMAT 0x03  // Bitmask for format
+#define NEO_BITMAP_PROGMEM 0x80 // Add if data and palette are in PROGMEM
+
+typedef struct
+{
+  const void *data;        // Pixel data, in the above format
+  const uint32_t *palette; // Packed colors (as from Color()) for PALETTE
+  uint16_t width, height;  // Bitmap size in pixels
+  uint8_t format;          // NEO_BITMAP_* + optional NEO_BITMAP_PROGMEM
+} neoBitmap;
+
+// NeoPixelMatrix presents a strip (or NeoPixelSegments canvas) as a 2D
+// display.  The layout -- corner, row/column order, serpentine wiring,
+// tiling and rotation -- is resolved once into a lookup table of strip
+// indices, so drawing never divides or branches on layout.  Fills walk
+// the table to find runs of consecutive strip pixels and hand each run
+// to Adafruit_NeoPixel::fill().  If there isn't RAM for the table
+// (2 bytes/pixel), coordinates are mapped on the fly instead.
+class NeoPixelMatrix
+{
+
+  public:
+    NeoPixelMatrix(Adafruit_NeoPixel &strip, uint16_t w, uint16_t h,
+                   uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT +
+                                        NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+    NeoPixelMatrix(Adafruit_NeoPixel &strip, uint8_t matrixW, uint8_t matrixH,
+                   uint8_t tilesX, uint8_t tilesY, uint8_t matrixType);
+    ~NeoPixelMatrix();
+
+    void setRotation(uint8_t r);
+    uint8_t getRotation(void) const { return rotation; }
+    uint16_t width(void) const { return w; }
+    uint16_t height(void) const { return h; }
+    inline uint16_t XY(int16_t x, int16_t y) const
+    {
+      if ((x < 0) || (y < 0) || (x >= (int16_t)w) || (y >= (int16_t)h))
+        return NEO_MATRIX_NONE;
+      return lut ? lut[(uint16_t)y * w + x] : remap(x, y);
+    }
+    void drawPixel(int16_t x, int16_t y, uint32_t c);
+    void drawPixel(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
+    uint32_t getPixelColor(int16_t x, int16_t y) const;
+    void fillRow(int16_t y, uint32_t c) { fillRect(0, y, w, 1, c); }
+    void fillColumn(int16_t x, uint32_t c) { fillRect(x, 0, 1, h, c); }
+    void fillRect(int16_t x, int16_t y, int16_t rw, int16_t rh, uint32_t c);
+    void fillScreen(uint32_t c);
+    void drawBitmap(int16_t x, int16_t y, const neoBitmap &bmp,
+                    uint8_t alpha = 255, uint32_t color = 0xFFFFFF);
+    void show(void) { strip.show(); }
+    Adafruit_NeoPixel &getStrip(void) const { return strip; }
+
+  private:
+    uint16_t remap(int16_t x, int16_t y) const;
+    void buildTable(void);
+    void fillLine(int16_t x, int16_t y, int8_t dx, int8_t dy, uint16_t len, uint32_t c);
+
+    Adafruit_NeoPixel
+        &strip;
+    uint16_t
+        *lut,    // Strip index for each (x,y) in rotated space, or NULL
+        w,       // Width and height in rotated space
+        h,
+        matrixW, // Size of one tile
+        matrixH;
+    uint8_t
+        type,     // NEO_MATRIX_* + NEO_TILE_* layout
+        tilesX,   // Tiles across and down
+        tilesY,
+        rotation; // 0-3, clockwise quarter turns
+    boolean
+        rowRuns; // true if horizontal lines are contiguous in strip
+};
+
+#endif // NEOPIXEL_MATRIX_H
@@ -0,0 +1,166 @@
+/*-------------------------------------------------------------------------
+  Virtual segment map for the Adafruit NeoPixel library.  Maps one
+  logical canvas of pixels onto ranges of several physical strips.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelSegments.h"
+
+NeoPixelSegments::NeoPixelSegments(uint16_t n, neoPixelType t, uint8_t maxSegments) : Adafruit_NeoPixel(), numRuns(0)
+{
+  updateType(t);
+  updateLength(n);
+  if ((runs = (run *)malloc(maxSegments * sizeof(run))))
+    maxRuns = maxSegments;
+  else
+    maxRuns = 0;
+}
+
+NeoPixelSegments::~NeoPixelSegments()
+{
+  if (runs)
+    free(runs);
+}
+
+// Map 'count' canvas pixels starting at 'first' onto 'strip', starting
+// at pixel 'stripFirst'.  If 'reversed', canvas pixel 'first' lands on
+// the LAST pixel of the strip range and order runs backward.  The run
+// is clipped to both the canvas and strip lengths.  Returns false if
+// the segment table is full, the range is entirely out of bounds, or
+// canvas or strip is NEO_16BIT (only 8-bit pixels are gathered).
+bool NeoPixelSegments::addSegment(uint16_t first, uint16_t count, Adafruit_NeoPixel &strip,
+                                  uint16_t stripFirst, bool reversed)
+{
+  if ((numRuns >= maxRuns) || (first >= numLEDs) || (stripFirst >= strip.numLEDs))
+    return false;
+#ifdef NEO_16BIT
+  if (is16Bit() || strip.is16Bit())
+    return false;
+#endif
+  if (count > (numLEDs - first))
+    count = numLEDs - first;
+  if (count > (strip.numLEDs - stripFirst))
+    count = strip.numLEDs - stripFirst;
+  if (!count)
+    return false;
+
+  run &r = runs[numRuns++];
+  r.strip = &strip;
+  r.src = first * pixelBytes();
+  r.dst = stripFirst * strip.pixelBytes();
+  r.count = count;
+  r.flags = reversed ? RUN_REVERSED : 0;
+  if ((strip.rOffset == rOffset) && (strip.gOffset == gOffset) &&
+      (strip.bOffset == bOffset) && (strip.wOffset == wOffset) &&
+      (strip.w2Offset == w2Offset))
+    r.flags |= RUN_SAMEORDER;
+  return true;
+}
+
+// Begin the canvas and every strip it maps onto.
+void NeoPixelSegments::begin(void)
+{
+  Adafruit_NeoPixel::begin();
+  for (uint8_t i = 0; i < numRuns; i++)
+    runs[i].strip->begin();
+}
+
+// Copy canvas contents into the physical strips' buffers without
+// showing them; use this when the strips are issued some other way
+// (e.g. by a NeoPixelGroup).
+void NeoPixelSegments::gather(void)
+{
+  uint8_t cbpp = pixelBytes();
+
+  for (uint8_t i = 0; i < numRuns; i++)
+  {
+    run &r = runs[i];
+    Adafruit_NeoPixel *s = r.strip;
+    uint8_t sbpp = s->pixelBytes();
+    uint16_t n = r.count;
+    // Canvas or strip may have been resized since the segment was added
+    if ((((uint32_t)r.dst + (uint32_t)n * sbpp) > s->numBytes) ||
+        (((uint32_t)r.src + (uint32_t)n * cbpp) > numBytes))
+      continue;
+    uint8_t *src = &pixels[r.src],
+            *dst = &s->pixels[r.dst];
+
+    if (r.flags & RUN_SAMEORDER)
+    {
+      if (!(r.flags & RUN_REVERSED))
+      {
+        memcpy(dst, src, n * cbpp);
+      }
+      else if (cbpp == 3)
+      {
+        for (dst += (n - 1) * 3; n--; src += 3, dst -= 3)
+        {
+          dst[0] = src[0];
+          dst[1] = src[1];
+          dst[2] = src[2];
+        }
+      }
+      else
+      {
+        for (dst += (n - 1) * cbpp; n--; src += cbpp, dst -= cbpp)
+          memcpy(dst, src, cbpp);
+      }
+    }
+    else
+    { // Color order differs; reorder each pixel
+      int8_t step = sbpp;
+      if (r.flags & RUN_REVERSED)
+      {
+        dst += (n - 1) * sbpp;
+        step = -step;
+      }
+      for (; n--; src += cbpp, dst += step)
+      {
+        dst[s->rOffset] = src[rOffset];
+        dst[s->gOffset] = src[gOffset];
+        dst[s->bOffset] = src[bOffset];
+        if (sbpp >= 4)
+          dst[s->wOffset] = (cbpp >= 4) ? src[wOffset] : 0;
+        if (sbpp == 5)
+          dst[s->w2Offset] = (cbpp == 5) ? src[w2Offset] : 0;
+      }
+    }
+    s->setDirty(r.dst / sbpp, r.count);
+  }
+}
+
+// Gather canvas into the physical strips (if anything changed) and
+// show each strip once.
+void NeoPixelSegments::show(void)
+{
+  if (dirty)
+  {
+    gather();
+    dirty = false;
+  }
+  for (uint8_t i = 0; i < numRuns; i++)
+  {
+    // A strip may carry several segments; only issue it once
+    uint8_t j;
+    for (j = 0; (j < i) && (runs[j].strip != runs[i].strip); j++)
+      ;
+    if (j == i)
+      runs[i].strip->show();
+  }
+}
@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_SEGMENTS_H
+#define NEOPIXEL_SEGMENTS_H
+
+#include "Adafruit_NeoPixel.h"
+
+// NeoPixelSegments is a logical "canvas" strip that isn't attached to
+// any pin.  It supports the full Adafruit_NeoPixel drawing API (it IS
+// an Adafruit_NeoPixel), and addSegment() maps ranges of its pixels
+// onto ranges of one or more physical strips, optionally reversed for
+// strips that are mounted back-to-front.  show() gathers the canvas
+// into each physical strip's buffer and then shows each strip once.
+//
+// Mappings are resolved into byte-offset runs when added, so the gather
+// is a memcpy() per run (or a reversed per-pixel copy) when canvas and
+// strip share a color order, with a per-pixel reorder only when they
+// don't.  Canvas brightness applies; the physical strips' own
+// setBrightness() settings are bypassed, as with getPixels() writes.
+//
+// Note that show() is not virtual -- call it on the NeoPixelSegments
+// object itself, not through an Adafruit_NeoPixel reference (which
+// sends nothing, as the canvas has no pin, and doesn't gather).
+class NeoPixelSegments : public Adafruit_NeoPixel
+{
+
+  public:
+    NeoPixelSegments(uint16_t n, neoPixelType t = NEO_GRB + NEO_KHZ800,
+                     uint8_t maxSegments = 8);
+    ~NeoPixelSegments();
+
+    bool addSegment(uint16_t first, uint16_t count, Adafruit_NeoPixel &strip,
+                    uint16_t stripFirst = 0, bool reversed = false);
+    void clearSegments(void) { numRuns = 0; }
+    uint8_t numSegments(void) const { return numRuns; }
+    void begin(void);
+    void gather(void);
+    void show(void);
+
+  private:
+    typedef struct
+    {
+      Adafruit_NeoPixel *strip;
+      uint16_t
+          src,   // Byte offset of first pixel in canvas
+          dst,   // Byte offset of first (or last, if reversed) in strip
+          count; // Pixels in run
+      uint8_t
+          flags; // RUN_* bits below
+    } run;
+
+    enum
+    {
+      RUN_REVERSED = 0x01,  // Strip pixels are in descending order
+      RUN_SAMEORDER = 0x02, // Canvas and strip share color order
+    };
+
+    run
+        *runs;
+    uint8_t
+        numRuns,
+        maxRuns;
+};
+
+#endif // NEOPIXEL_SEGMENTS_H
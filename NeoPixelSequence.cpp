@@ -0,0 +1,220 @@
+/*-------------------------------------------------------------------------
+  Compressed frame sequence player for the Adafruit NeoPixel library.
+  Decodes run-length and delta encoded frames into a strip.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelSequence.h"
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+
+NeoPixelSequence::NeoPixelSequence(Adafruit_NeoPixel &s) : strip(s), data(NULL), stream(NULL), len(0), pos(0), frames(0), frame(0), interval(0), next(0), pixelsPerFrame(0), bpp(0), progmem(false), started(false), done(true), error(false), looping(false)
+{
+}
+
+// Play a sequence held in RAM.  Returns false if the header is invalid
+// or doesn't suit the strip.
+bool NeoPixelSequence::begin(const uint8_t *d, uint32_t l)
+{
+  data = d;
+  len = l;
+  stream = NULL;
+  progmem = false;
+  return rewind();
+}
+
+// Play a sequence held in PROGMEM (e.g. a header from neoseq_encode -c).
+bool NeoPixelSequence::begin_P(const uint8_t *d, uint32_t l)
+{
+  data = d;
+  len = l;
+  stream = NULL;
+  progmem = true;
+  return rewind();
+}
+
+// Play a sequence from a Stream positioned at its header.  Streams
+// can't be rewound here; to replay a file, seek it to 0 and call
+// begin() again.
+bool NeoPixelSequence::begin(Stream &s)
+{
+  data = NULL;
+  stream = &s;
+  return readHeader();
+}
+
+// Restart from the first frame (RAM and PROGMEM sequences only).
+bool NeoPixelSequence::rewind(void)
+{
+  if (!data)
+    return fail();
+  pos = 0;
+  return readHeader();
+}
+
+bool NeoPixelSequence::readHeader(void)
+{
+  uint8_t h[NEOSEQ_HEADER_SIZE];
+
+  error = false;
+  done = true;
+  if (!readBytes(h, NEOSEQ_HEADER_SIZE) ||
+      (h[0] != 'N') || (h[1] != 'P') || (h[2] != 'S') || (h[3] != 'Q') ||
+      (h[4] != NEOSEQ_VERSION))
+    return fail();
+  bpp = h[5];
+  pixelsPerFrame = h[6] | ((uint16_t)h[7] << 8);
+  frames = h[8] | ((uint32_t)h[9] << 8) | ((uint32_t)h[10] << 16) | ((uint32_t)h[11] << 24);
+  interval = h[12] | ((uint32_t)h[13] << 8) | ((uint32_t)h[14] << 16) | ((uint32_t)h[15] << 24);
+  // 3 or 4 bytes per pixel, as the strip (so not RGBWW or NEO_16BIT)
+  if ((bpp < 3) || (bpp > 4) || (bpp != strip.pixelBytes()) ||
+      (pixelsPerFrame > strip.numLEDs) || !strip.pixels)
+    return fail();
+  // The frame before the first is all off
+  memset(strip.pixels, 0, (uint16_t)pixelsPerFrame * bpp);
+  strip.setDirty(0, pixelsPerFrame);
+  frame = 0;
+  started = false;
+  done = !frames;
+  return true;
+}
+
+bool NeoPixelSequence::fail(void)
+{
+  error = done = true;
+  return false;
+}
+
+// Next byte of sequence, or -1 at end of data
+int16_t NeoPixelSequence::readByte(void)
+{
+  if (stream)
+    return stream->read();
+  if (pos >= len)
+    return -1;
+  return progmem ? pgm_read_byte(&data[pos++]) : data[pos++];
+}
+
+bool NeoPixelSequence::readBytes(uint8_t *dst, uint16_t n)
+{
+  if (stream)
+    return stream->readBytes(dst, n) == n;
+  if ((len - pos) < n)
+    return false;
+  if (progmem)
+  {
+    for (uint16_t i = 0; i < n; i++)
+      dst[i] = pgm_read_byte(&data[pos + i]);
+  }
+  else
+  {
+    memcpy(dst, &data[pos], n);
+  }
+  pos += n;
+  return true;
+}
+
+// Decode the next frame into the strip buffer (but don't show it).
+// Returns false at the end of the sequence or on bad data.
+bool NeoPixelSequence::nextFrame(void)
+{
+  if (done && looping && !error && data && frames)
+    rewind();
+  if (done)
+    return false;
+
+  uint8_t *p = strip.pixels, *end = &p[(uint16_t)pixelsPerFrame * bpp],
+          b = strip.brightness;
+  int16_t c;
+  for (;;)
+  {
+    if ((c = readByte()) < 0)
+      return fail();
+    if (c == NEOSEQ_END)
+      break;
+    uint16_t n = c & NEOSEQ_COUNT;
+    if (!n)
+    {
+      int16_t lo = readByte(), hi = readByte();
+      if ((lo < 0) || (hi < 0) || !(n = lo | (hi << 8)))
+        return fail();
+    }
+    uint16_t bytes = n * bpp;
+    if ((bytes / bpp != n) || (bytes > (uint16_t)(end - p)))
+      return fail(); // Overflow or past end of frame
+    switch (c & NEOSEQ_OP)
+    {
+    case NEOSEQ_SKIP:
+      break;
+    case NEOSEQ_RUN:
+      if (!readBytes(p, bpp))
+        return fail();
+      if (b) // See notes in setBrightness()
+      {
+        for (uint8_t i = 0; i < bpp; i++)
+          p[i] = (p[i] * b) >> 8;
+      }
+      // Replicate the first pixel by doubling copies
+      for (uint16_t have = bpp; have < bytes; have *= 2)
+        memcpy(&p[have], p, ((bytes - have) < have) ? (bytes - have) : have);
+      break;
+    default: // NEOSEQ_LITERAL
+      if (!readBytes(p, bytes))
+        return fail();
+      if (b)
+      {
+        for (uint16_t i = 0; i < bytes; i++)
+          p[i] = (p[i] * b) >> 8;
+      }
+      break;
+    }
+    if ((c & NEOSEQ_OP) != NEOSEQ_SKIP)
+      strip.setDirty((p - strip.pixels) / bpp, n);
+    p += bytes;
+  }
+  strip.dirty = true;
+  if (++frame >= frames)
+    done = true;
+  return true;
+}
+
+// Call from loop() as often as possible.  Decodes and shows the next
+// frame when it's due and the strip is ready; returns true if a frame
+// was shown.  Timing follows the interval in the sequence header.
+bool NeoPixelSequence::update(uint32_t now)
+{
+  if (done && !(looping && data && !error))
+    return false;
+  if (!started)
+  {
+    next = now;
+    started = true;
+  }
+  if (((int32_t)(now - next) < 0) || !strip.canShow())
+    return false;
+  if (!nextFrame())
+    return false;
+  strip.show();
+  if ((now - next) >= interval)
+    next = now; // Fell a whole frame behind; resync
+  next += interval;
+  return true;
+}
@@ -0,0 +1,114 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_SEQUENCE_H
+#define NEOPIXEL_SEQUENCE_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Compressed frame sequence format, as written by extras/neoseq_encode.c.
+// All multi-byte values are little-endian.
+//
+//   Header (16 bytes):
+//     0   'N','P','S','Q'
+//     4   uint8_t  version (1)
+//     5   uint8_t  bytes per pixel (3 or 4), device color order
+//     6   uint16_t pixels per frame
+//     8   uint32_t number of frames
+//     12  uint32_t frame interval, microseconds
+//
+//   Then each frame in turn, as a list of ops applied to the previous
+//   frame (the frame before the first is all off), ending with
+//   NEOSEQ_END.  Op byte bits 7,6 are the op; bits 5-0 are a pixel
+//   count of 1-63, or 0 if a uint16_t count (1-65535) follows.
+//
+//     NEOSEQ_SKIP     count pixels unchanged from previous frame
+//     NEOSEQ_RUN      one pixel value follows; repeat it count times
+//     NEOSEQ_LITERAL  count pixel values follow
+//
+//   Pixels past the last op in a frame are unchanged.
+#define NEOSEQ_VERSION 1
+#define NEOSEQ_HEADER_SIZE 16
+#define NEOSEQ_SKIP 0x00
+#define NEOSEQ_RUN 0x40
+#define NEOSEQ_LITERAL 0x80
+#define NEOSEQ_END 0xC0
+#define NEOSEQ_OP 0xC0    // Bitmask for op
+#define NEOSEQ_COUNT 0x3F // Bitmask for short count
+
+// NeoPixelSequence plays a compressed sequence straight into a strip's
+// pixel buffer, from RAM, PROGMEM, or any Stream (e.g. an SD card
+// File).  Decoding a frame touches each op once and each pixel at most
+// once -- op counts are clipped to the frame, so malformed data can't
+// run past the buffer -- and unchanged pixels aren't touched at all.
+// The strip's brightness is applied as pixels are written.  The
+// sequence's bytes per pixel must match the strip (so RGBWW and
+// NEO_16BIT strips can't play sequences), and its frame can't be
+// longer than the strip.
+class NeoPixelSequence
+{
+
+  public:
+    NeoPixelSequence(Adafruit_NeoPixel &strip);
+
+    bool begin(const uint8_t *data, uint32_t len);
+    bool begin_P(const uint8_t *data, uint32_t len);
+    bool begin(Stream &s);
+    bool nextFrame(void);
+    bool update(void) { return update(micros()); }
+    bool update(uint32_t now);
+    bool rewind(void);
+    void setLoop(bool l) { looping = l; }
+    bool isDone(void) const { return done; }
+    bool isError(void) const { return error; }
+    uint32_t numFrames(void) const { return frames; }
+    uint32_t getFrame(void) const { return frame; }
+    uint32_t getInterval(void) const { return interval; }
+
+  private:
+    bool readHeader(void);
+    int16_t readByte(void);
+    bool readBytes(uint8_t *dst, uint16_t n);
+    bool fail(void);
+
+    Adafruit_NeoPixel
+        &strip;
+    const uint8_t
+        *data; // Start of sequence in RAM or PROGMEM
+    Stream
+        *stream;
+    uint32_t
+        len,       // Size of 'data'
+        pos,       // Read position in 'data'
+        frames,    // Frames in sequence
+        frame,     // Next frame to decode
+        interval,  // Microseconds between frames
+        next;      // micros() at which update() shows the next frame
+    uint16_t
+        pixelsPerFrame;
+    uint8_t
+        bpp;
+    boolean
+        progmem, // 'data' is in PROGMEM
+        started, // 'next' has been set
+        done,    // All frames played
+        error,   // Bad header or data; playback stopped
+        looping; // Rewind after the last frame (not for Streams)
+};
+
+#endif // NEOPIXEL_SEQUENCE_H
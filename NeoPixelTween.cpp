@@ -0,0 +1,187 @@
+/*-------------------------------------------------------------------------
+  Crossfade engine for the Adafruit NeoPixel library.  Interpolates a
+  strip between two frames over time, with easing.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelTween.h"
+
+NeoPixelTween::NeoPixelTween(Adafruit_NeoPixel &s) : strip(s), from(NULL), to(NULL), snapshot(NULL), easing(NEO_EASE_LINEAR), durShift(0), snapBytes(0), bytes(0), progress(0), duration16(0), lastWeight(0), startTime(0), active(false), started(false), fullFrom(false)
+{
+}
+
+NeoPixelTween::~NeoPixelTween()
+{
+  if (snapshot)
+    free(snapshot);
+}
+
+// Fade from the strip's current contents to canvas 'to'.  Returns false
+// if the canvas doesn't match the strip, either is NEO_16BIT (bytes
+// are mixed separately, which would split each 16-bit value), or
+// there's no RAM for the snapshot.  Timing starts at the first
+// update().
+bool NeoPixelTween::begin(const Adafruit_NeoPixel &t, uint32_t durationMicros, uint8_t e)
+{
+  uint16_t n = strip.numBytes;
+
+  if (!strip.pixels)
+    return false;
+#ifdef NEO_16BIT
+  if (strip.wide)
+    return false;
+#endif
+  if (snapBytes != n)
+  {
+    if (snapshot)
+      free(snapshot);
+    if (!(snapshot = (uint8_t *)malloc(n)))
+    {
+      snapBytes = 0;
+      return false;
+    }
+    snapBytes = n;
+  }
+  memcpy(snapshot, strip.pixels, n);
+  from = snapshot;
+  fullFrom = false;
+  return start(t, durationMicros, e);
+}
+
+// Fade from canvas 'from' to canvas 'to', both at full brightness.
+bool NeoPixelTween::begin(const Adafruit_NeoPixel &f, const Adafruit_NeoPixel &t,
+                          uint32_t durationMicros, uint8_t e)
+{
+  if (!f.pixels || (f.numBytes != strip.numBytes))
+    return false;
+#ifdef NEO_16BIT
+  if (f.wide)
+    return false;
+#endif
+  from = f.pixels;
+  fullFrom = true;
+  return start(t, durationMicros, e);
+}
+
+bool NeoPixelTween::start(const Adafruit_NeoPixel &t, uint32_t durationMicros, uint8_t e)
+{
+  active = false;
+  if (!t.pixels || !strip.pixels || (t.numBytes != strip.numBytes))
+    return false;
+#ifdef NEO_16BIT
+  if (strip.wide || t.wide)
+    return false;
+#endif
+  to = t.pixels;
+  bytes = t.numBytes;
+  easing = e;
+  // Progress is elapsed * 65536 / duration; shifting both down until
+  // the duration fits 16 bits keeps that product within 32 bits.
+  for (durShift = 0; (durationMicros >> durShift) > 0xFFFF; durShift++)
+    ;
+  duration16 = durationMicros >> durShift;
+  progress = 0;
+  lastWeight = 0xFFFF; // Force first mix
+  started = false;
+  active = true;
+  return true;
+}
+
+// Map linear progress 'p' (0-65535) through an easing curve.
+uint16_t NeoPixelTween::ease(uint8_t easing, uint16_t p)
+{
+  uint32_t p2, q;
+
+  switch (easing)
+  {
+  case NEO_EASE_IN:
+    return ((uint32_t)p * p) >> 16;
+  case NEO_EASE_OUT:
+    q = 65535 - p;
+    return 65535 - ((q * q) >> 16);
+  case NEO_EASE_IN_OUT: // 3p^2 - 2p^3
+    p2 = ((uint32_t)p * p) >> 16;
+    q = 3 * p2 - 2 * ((p2 * p) >> 16);
+    return (q > 65535) ? 65535 : q;
+  default:
+    return p;
+  }
+}
+
+// Call from loop() as often as possible.  Mixes the frame for the
+// current time into the strip buffer (but doesn't show it) and returns
+// true if the buffer changed.  The final frame is exactly the target.
+bool NeoPixelTween::update(uint32_t now)
+{
+  uint16_t w;
+
+  if (!active)
+    return false;
+  if (!started)
+  {
+    startTime = now;
+    started = true;
+  }
+  uint32_t elapsed = (now - startTime) >> durShift;
+  if (elapsed >= duration16)
+  {
+    progress = 65535;
+    w = 256;
+    active = false;
+  }
+  else
+  {
+    progress = ease(easing, (elapsed << 16) / duration16);
+    w = (progress + 128) >> 8; // 0-256
+  }
+  if (w == lastWeight)
+    return false; // Same mix as last time; nothing to redo
+  mix(w);
+  lastWeight = w;
+  return true;
+}
+
+// One pass over the buffer: out = from + (to - from) * w / 256, with
+// brightness folded in.  A full-brightness 'from' is mixed with 'to'
+// first and the sum scaled once; a snapshot is already scaled, so only
+// 'to' is scaled before mixing.
+void NeoPixelTween::mix(uint16_t w)
+{
+  uint8_t *dst = strip.pixels;
+  uint16_t n = strip.numBytes, i,
+           iw = 256 - w,
+           b = strip.brightness ? strip.brightness : 256; // See setBrightness()
+
+  if (!dst || (n != bytes))
+  {
+    active = false; // Strip was resized out from under the tween
+    return;
+  }
+  if (fullFrom)
+  {
+    for (i = 0; i < n; i++)
+      dst[i] = (((uint32_t)from[i] * iw + (uint32_t)to[i] * w) * b) >> 16;
+  }
+  else
+  {
+    for (i = 0; i < n; i++)
+      dst[i] = (from[i] * iw + ((to[i] * b) >> 8) * w) >> 8;
+  }
+  strip.setDirty();
+}
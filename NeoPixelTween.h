@@ -0,0 +1,91 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_TWEEN_H
+#define NEOPIXEL_TWEEN_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Easing curves for NeoPixelTween: how progress through the duration
+// maps to progress between the two frames.
+#define NEO_EASE_LINEAR 0 // Constant rate
+#define NEO_EASE_IN 1     // Start slow, end fast (quadratic)
+#define NEO_EASE_OUT 2    // Start fast, end slow (quadratic)
+#define NEO_EASE_IN_OUT 3 // Slow at both ends (smoothstep)
+
+// NeoPixelTween crossfades a strip from one frame to another over a
+// duration.  The target is an Adafruit_NeoPixel canvas (typically
+// pinless, from the default constructor) of the same length and color
+// order as the strip, drawn at full brightness; the strip's brightness
+// is applied as each frame is mixed.  The starting frame is either
+// another such canvas or, if none is given, a snapshot of what the
+// strip currently holds.  Canvases are best: the strip's own buffer has
+// already lost precision to brightness scaling (see setBrightness()),
+// whereas canvases are mixed at full precision and scaled once.
+// Mixing is a byte at a time, so NEO_16BIT strips and canvases are
+// refused.
+//
+// Each update() eases the elapsed time into a mix weight, then makes a
+// single fixed-point pass over the pixel buffer.  The canvases are
+// referenced, not copied, and must stay valid while the tween runs.
+class NeoPixelTween
+{
+
+  public:
+    NeoPixelTween(Adafruit_NeoPixel &strip);
+    ~NeoPixelTween();
+
+    bool begin(const Adafruit_NeoPixel &to, uint32_t durationMicros,
+               uint8_t easing = NEO_EASE_LINEAR);
+    bool begin(const Adafruit_NeoPixel &from, const Adafruit_NeoPixel &to,
+               uint32_t durationMicros, uint8_t easing = NEO_EASE_LINEAR);
+    bool update(void) { return update(micros()); }
+    bool update(uint32_t now);
+    void cancel(void) { active = false; }
+    bool isActive(void) const { return active; }
+    uint16_t getProgress(void) const { return progress; }
+    static uint16_t ease(uint8_t easing, uint16_t p);
+
+  private:
+    bool start(const Adafruit_NeoPixel &to, uint32_t durationMicros, uint8_t easing);
+    void mix(uint16_t w);
+
+    Adafruit_NeoPixel
+        &strip;
+    const uint8_t
+        *from, // Start frame: canvas pixels or 'snapshot'
+        *to;   // Target canvas pixels
+    uint8_t
+        *snapshot,    // Copy of strip buffer when no 'from' canvas given
+        easing,       // NEO_EASE_*
+        durShift;     // Right shift bringing duration into 16 bits
+    uint16_t
+        snapBytes,    // Size of 'snapshot'
+        bytes,        // Strip buffer size when tween began
+        progress,     // Eased progress at last update, 0-65535
+        duration16,   // Duration >> durShift
+        lastWeight;   // Mix weight (0-256) last written to the strip
+    uint32_t
+        startTime; // micros() at first update()
+    boolean
+        active,    // Tween is running
+        started,   // startTime has been set
+        fullFrom;  // 'from' is a full-brightness canvas
+};
+
+#endif // NEOPIXEL_TWEEN_H
@@ -7,6 +7,10 @@
 #include <Arduino.h>
 #include <eagle_soc.h>
 
+#ifndef NEO_MAX_RESTARTS
+#define NEO_MAX_RESTARTS 3 // Must match Adafruit_NeoPixel.h
+#endif
+
 static uint32_t _getCycleCount(void) __attribute__((always_inline));
 static inline uint32_t _getCycleCount(void) {
   uint32_t ccount;
@@ -14,8 +18,11 @@ static inline uint32_t _getCycleCount(void) {
   return ccount;
 }
 
-void ICACHE_RAM_ATTR espShow(
- uint8_t pin, uint8_t *pixels, uint32_t numBytes, boolean is800KHz) {
+// Returns the number of times the frame was restarted because an
+// interrupt window overran (see Adafruit_NeoPixel::setInterruptWindow()).
+uint8_t ICACHE_RAM_ATTR espShow(
+ uint8_t pin, uint8_t *pixels, uint32_t numBytes, boolean is800KHz,
+ uint16_t windowBytes, uint8_t windowGap) {
 
 #define CYCLES_800_T0H  (F_CPU / 2500000) // 0.4us
 #define CYCLES_800_T1H  (F_CPU / 1250000) // 0.8us
@@ -23,9 +30,11 @@ void ICACHE_RAM_ATTR espShow(
 #define CYCLES_400_T0H  (F_CPU / 2000000) // 0.5uS
 #define CYCLES_400_T1H  (F_CPU /  833333) // 1.2us
 #define CYCLES_400      (F_CPU /  400000) // 2.5us per bit
+#define CYCLES_LATCH    (F_CPU /   20000) // 50us
 
-  uint8_t *p, *end, pix, mask;
-  uint32_t t, time0, time1, period, c, startTime, pinMask;
+  uint8_t *p, *end, pix, mask, restarts = 0;
+  uint16_t chunk = windowBytes;
+  uint32_t t, time0, time1, period, limit, c, startTime, pinMask;
 
   pinMask   = _BV(pin);
   p         =  pixels;
@@ -47,6 +56,7 @@ void ICACHE_RAM_ATTR espShow(
     period = CYCLES_400;
   }
 #endif
+  limit = period + windowGap * (F_CPU / 1000000);
 
   for(t = time0;; t = time0) {
     if(pix & mask) t = time1;                             // Bit high duration
@@ -57,11 +67,25 @@ void ICACHE_RAM_ATTR espShow(
     GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, pinMask);       // Set low
     if(!(mask >>= 1)) {                                   // Next bit/byte
       if(p >= end) break;
+      if(chunk && !--chunk) {                             // Int. window
+        while((_getCycleCount() - startTime) < period);   // Finish bit
+        interrupts();                                     // Let ISRs run
+        noInterrupts();
+        if((_getCycleCount() - startTime) > limit) {      // Overran gap,
+          interrupts();                                   // strip latched
+          while((_getCycleCount() - startTime) < CYCLES_LATCH);
+          noInterrupts();
+          p = pixels;                                     // Resend frame
+          if(++restarts >= NEO_MAX_RESTARTS) windowBytes = 0;
+        }
+        chunk = windowBytes;
+      }
       pix  = *p++;
       mask = 0x80;
     }
   }
   while((_getCycleCount() - startTime) < period); // Wait for last bit
+  return restarts;
 }
 
 #endif // ESP8266
@@ -1,4 +1,5 @@
 #include <Adafruit_NeoPixel.h>
+#include <NeoPixelMath.h>
 #ifdef __AVR__
   #include <avr/power.h>
 #endif
@@ -93,21 +94,19 @@ void rainbowFade2White(uint8_t wait, int rainbowLoops, int whiteLoops) {
   float fadeMax = 100.0;
   int fadeVal = 0;
   uint32_t wheelVal;
-  int redVal, greenVal, blueVal;
 
   for(int k = 0 ; k < rainbowLoops ; k ++){
     
     for(int j=0; j<256; j++) { // 5 cycles of all colors on wheel
 
+      uint8_t fade = fadeVal * 255 / fadeMax;
+
       for(int i=0; i< strip.numPixels(); i++) {
 
         wheelVal = Wheel(((i * 256 / strip.numPixels()) + j) & 255);
 
-        redVal = red(wheelVal) * float(fadeVal/fadeMax);
-        greenVal = green(wheelVal) * float(fadeVal/fadeMax);
-        blueVal = blue(wheelVal) * float(fadeVal/fadeMax);
-
-        strip.setPixelColor( i, strip.Color( redVal, greenVal, blueVal ) );
+        // Fade all channels at once, without unpacking the color
+        strip.setPixelColor( i, NeoPixelMath::scale8x4( wheelVal, fade ) );
 
       }
 
@@ -249,15 +248,3 @@ uint32_t Wheel(byte WheelPos) {
   WheelPos -= 170;
   return strip.Color(WheelPos * 3, 255 - WheelPos * 3, 0,0);
 }
-
-uint8_t red(uint32_t c) {
-  return (c >> 8);
-}
-uint8_t green(uint32_t c) {
-  return (c >> 16);
-}
-uint8_t blue(uint32_t c) {
-  return (c);
-}
-
-
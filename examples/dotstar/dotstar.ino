@@ -0,0 +1,31 @@
+// Drive APA102 / SK9822 (DotStar) LEDs with the usual Adafruit_NeoPixel
+// calls.  NeoPixelDotStar takes over show(), clocking data out over
+// hardware SPI (MOSI and SCK pins) -- or two pins of your choice, bit-
+// banged -- with no timing-critical code and interrupts left on.
+
+#include <Adafruit_NeoPixel.h>
+#include <NeoPixelDotStar.h>
+
+#define NUMPIXELS 72
+
+// Pin is unused (-1); any 3-byte color order works for drawing
+Adafruit_NeoPixel strip(NUMPIXELS, -1, NEO_RGB);
+
+// Hardware SPI; for bit-banging instead use e.g.
+// NeoPixelDotStar dots(strip, 4, 5); // Data pin, clock pin
+NeoPixelDotStar dots(strip);
+
+void setup() {
+  strip.begin();
+  // Dim in the LEDs rather than in RAM, keeping full color resolution
+  dots.setGlobalBrightness(8); // 0-31
+  strip.show(); // Initialize all pixels to 'off'
+}
+
+void loop() {
+  static uint16_t hue = 0;
+  strip.fillRainbow(0, 0, hue, 65536 / NUMPIXELS);
+  strip.show();
+  hue += 256;
+  delay(10);
+}
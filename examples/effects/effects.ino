@@ -0,0 +1,60 @@
+// Non-blocking version of strandtest: the same animations, run by the
+// NeoPixelEffect engine so loop() never waits in delay().  The sketch
+// stays responsive -- here it echoes serial input while animating.
+
+#include <Adafruit_NeoPixel.h>
+#include <NeoPixelEffect.h>
+#ifdef __AVR__
+  #include <avr/power.h>
+#endif
+
+#define PIN 6
+
+Adafruit_NeoPixel strip = Adafruit_NeoPixel(60, PIN, NEO_GRB + NEO_KHZ800);
+
+// Intervals are in microseconds: 50000 = the examples' delay(50)
+NeoPixelColorWipe    wipeRed(strip, strip.Color(255, 0, 0), 50000);
+NeoPixelColorWipe    wipeGreen(strip, strip.Color(0, 255, 0), 50000);
+NeoPixelColorWipe    wipeBlue(strip, strip.Color(0, 0, 255), 50000);
+NeoPixelTheaterChase chaseWhite(strip, strip.Color(127, 127, 127), 50000);
+NeoPixelTheaterChase chaseRed(strip, strip.Color(127, 0, 0), 50000);
+NeoPixelTheaterChase chaseBlue(strip, strip.Color(0, 0, 127), 50000);
+NeoPixelRainbow      rainbow(strip, 20000);
+NeoPixelRainbow      rainbowCycle(strip, 20000, true, 5);
+NeoPixelTheaterChase chaseRainbow(strip, NEO_EFFECT_RAINBOW, 50000);
+NeoPixelPulseWhite   pulse(strip, 5000);
+
+NeoPixelEffect *playlist[] = {
+  &wipeRed, &wipeGreen, &wipeBlue,
+  &chaseWhite, &chaseRed, &chaseBlue,
+  &rainbow, &rainbowCycle, &chaseRainbow, &pulse
+};
+#define NUM_EFFECTS (sizeof(playlist) / sizeof(playlist[0]))
+uint8_t current = 0;
+
+void setup() {
+  // This is for Trinket 5V 16MHz, you can remove these three lines if you are not using a Trinket
+  #if defined (__AVR_ATtiny85__)
+    if (F_CPU == 16000000) clock_prescale_set(clock_div_1);
+  #endif
+  // End of trinket special code
+
+  Serial.begin(115200);
+  strip.begin();
+  strip.show(); // Initialize all pixels to 'off'
+}
+
+void loop() {
+  NeoPixelEffect *e = playlist[current];
+
+  e->update(); // Returns immediately unless a frame is due
+  if (e->isDone()) {
+    e->restart(); // Ready for next time through the playlist
+    current = (current + 1) % NUM_EFFECTS;
+  }
+
+  // Other work carries on between frames
+  while (Serial.available()) {
+    Serial.write(Serial.read());
+  }
+}
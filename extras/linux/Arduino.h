@@ -0,0 +1,117 @@
+/*-------------------------------------------------------------------------
+  Minimal Arduino API for building the NeoPixel library on a Linux host
+  (e.g. a single-board computer driving strips through NeoPixelOutput
+  backends).  Put this directory on the include path and define
+  ARDUINO=100; see neoplay.cpp for an example build.  Pin functions do
+  nothing: output goes through Adafruit_NeoPixel::setOutput().  With
+  NEO_LINUX_SIMTIME defined, time is simulated (see effectcheck.cpp).
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_LINUX_ARDUINO_H
+#define NEOPIXEL_LINUX_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#ifdef NEO_LINUX_SIMTIME
+// Simulated time for tests: micros() returns this, and only the
+// program (or delay()) moves it.  Build the library with the same
+// define, and define the variable once in the test.
+extern uint32_t neoSimMicros;
+
+static inline uint32_t micros(void)
+{
+  return neoSimMicros;
+}
+
+static inline void delayMicroseconds(unsigned int us)
+{
+  neoSimMicros += us;
+}
+
+static inline void delay(unsigned long ms)
+{
+  neoSimMicros += ms * 1000;
+}
+#else
+static inline uint32_t micros(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint32_t)t.tv_sec * 1000000UL + t.tv_nsec / 1000;
+}
+
+static inline void delayMicroseconds(unsigned int us)
+{
+  struct timespec t = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+  nanosleep(&t, NULL);
+}
+
+static inline void delay(unsigned long ms)
+{
+  struct timespec t = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000};
+  nanosleep(&t, NULL);
+}
+#endif
+
+static inline uint32_t millis(void)
+{
+  return micros() / 1000;
+}
+
+static inline void pinMode(uint8_t, uint8_t) {}
+static inline void digitalWrite(uint8_t, uint8_t) {}
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+// Just enough of Stream for NeoPixelSequence
+class Stream
+{
+
+  public:
+    virtual ~Stream() {}
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual size_t readBytes(uint8_t *buf, size_t n)
+    {
+      size_t i;
+      int c;
+      for (i = 0; (i < n) && ((c = read()) >= 0); i++)
+        buf[i] = c;
+      return i;
+    }
+};
+
+#endif // NEOPIXEL_LINUX_ARDUINO_H
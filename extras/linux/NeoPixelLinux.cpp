@@ -0,0 +1,249 @@
+/*-------------------------------------------------------------------------
+  Linux support for the Adafruit NeoPixel library: output backends for
+  raw frames to a file descriptor and WS2812 timing encoded onto an
+  spidev MOSI line, a UDP socket for the network receivers and a
+  serial Stream for NeoPixelAdalight.  Also defines the mock SPI object
+  (see SPI.h).
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "SPI.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <linux/spi/spidev.h>
+
+#define SPI_LATCH_BYTES 32 // 107 uS of low at 2.4 MHz
+#define SPI_BUFSIZ "/sys/module/spidev/parameters/bufsiz"
+#define SPI_BUFSIZ_DEFAULT 4096 // spidev's own default
+
+SPIClass SPI;
+
+void NeoPixelFileOutput::write(const uint8_t *pixels, uint16_t numBytes)
+{
+  while (numBytes)
+  {
+    ssize_t n = ::write(fd, pixels, numBytes);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      errors++;
+      return;
+    }
+    pixels += n;
+    numBytes -= n;
+  }
+}
+
+NeoPixelSpiOutput::NeoPixelSpiOutput(const char *d, uint32_t h) : device(d), fd(-1), hz(h), errors(0), buf(NULL), bufSize(0), maxTransfer(SPI_BUFSIZ_DEFAULT)
+{
+}
+
+NeoPixelSpiOutput::~NeoPixelSpiOutput()
+{
+  if (fd >= 0)
+    close(fd);
+  if (buf)
+    free(buf);
+}
+
+void NeoPixelSpiOutput::begin(void)
+{
+  uint8_t mode = SPI_MODE_0, bits = 8;
+
+  if (fd >= 0)
+    return;
+  if ((fd = open(device, O_RDWR)) < 0)
+    return;
+  if ((ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+      (ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+      (ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &hz) < 0))
+  {
+    close(fd);
+    fd = -1;
+    return;
+  }
+  // spidev refuses any message longer than its bufsiz parameter
+  FILE *f = fopen(SPI_BUFSIZ, "r");
+  unsigned long n;
+  if (f)
+  {
+    if ((fscanf(f, "%lu", &n) == 1) && n)
+      maxTransfer = n;
+    fclose(f);
+  }
+}
+
+void NeoPixelSpiOutput::write(const uint8_t *pixels, uint16_t numBytes)
+{
+  size_t need = (size_t)numBytes * 3 + SPI_LATCH_BYTES;
+
+  if (fd < 0)
+  {
+    errors++;
+    return;
+  }
+  if (need > bufSize)
+  {
+    uint8_t *b = (uint8_t *)realloc(buf, need);
+    if (!b)
+    {
+      errors++;
+      return;
+    }
+    buf = b;
+    bufSize = need;
+  }
+
+  // Expand each data bit, MSB first, to 1x0: 8 bits -> 24 bits
+  uint8_t *p = buf;
+  for (uint16_t i = 0; i < numBytes; i++)
+  {
+    uint32_t x = 0;
+    for (uint8_t m = 0x80; m; m >>= 1)
+      x = (x << 3) | ((pixels[i] & m) ? 0b110 : 0b100);
+    *p++ = x >> 16;
+    *p++ = x >> 8;
+    *p++ = x;
+  }
+  memset(p, 0, SPI_LATCH_BYTES);
+
+  // In transfers of at most maxTransfer bytes; MOSI idles low between
+  struct spi_ioc_transfer t;
+  memset(&t, 0, sizeof(t));
+  t.speed_hz = hz;
+  t.bits_per_word = 8;
+  for (size_t sent = 0; sent < need; sent += t.len)
+  {
+    t.tx_buf = (unsigned long)&buf[sent];
+    t.len = ((need - sent) < maxTransfer) ? (need - sent) : maxTransfer;
+    if (ioctl(fd, SPI_IOC_MESSAGE(1), &t) < 0)
+    {
+      errors++;
+      return;
+    }
+  }
+}
+
+NeoPixelLinuxUDP::~NeoPixelLinuxUDP()
+{
+  if (fd >= 0)
+    close(fd);
+}
+
+bool NeoPixelLinuxUDP::begin(uint16_t port, uint32_t timeoutMs, bool loopbackOnly)
+{
+  struct sockaddr_in a;
+  struct timeval tv = {(time_t)(timeoutMs / 1000), (suseconds_t)(timeoutMs % 1000) * 1000};
+  int size = 8 << 20; // Ride out bursts while show() is busy
+
+  if ((fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+    return false;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  a.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&a, sizeof(a)))
+  {
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  return true;
+}
+
+int NeoPixelLinuxUDP::parsePacket(void)
+{
+  ssize_t n = recv(fd, packet, sizeof(packet), 0);
+  len = (n > 0) ? n : 0;
+  pos = 0;
+  return len;
+}
+
+int NeoPixelLinuxUDP::read(uint8_t *buf, size_t n)
+{
+  if (n > (len - pos))
+    n = len - pos;
+  memcpy(buf, &packet[pos], n);
+  pos += n;
+  return n;
+}
+
+// Open a serial device raw at 'baud' (a standard rate), non-blocking.
+// Returns the descriptor, or -1 on error.
+int NeoPixelLinuxSerial::open(const char *device, uint32_t baud)
+{
+  static const struct
+  {
+    uint32_t baud;
+    speed_t speed;
+  } rates[] = {{9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+               {115200, B115200}, {230400, B230400}, {460800, B460800},
+               {500000, B500000}, {921600, B921600}, {1000000, B1000000},
+               {2000000, B2000000}};
+  struct termios t;
+  uint8_t i;
+  int fd;
+
+  for (i = 0; (i < (sizeof(rates) / sizeof(rates[0]))) && (rates[i].baud != baud); i++)
+    ;
+  if (i == (sizeof(rates) / sizeof(rates[0])))
+    return -1;
+  if ((fd = ::open(device, O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0)
+    return -1;
+  if (tcgetattr(fd, &t) == 0)
+  {
+    cfmakeraw(&t);
+    cfsetispeed(&t, rates[i].speed);
+    cfsetospeed(&t, rates[i].speed);
+    t.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &t);
+  }
+  return fd;
+}
+
+int NeoPixelLinuxSerial::available(void)
+{
+  int n = 0;
+  if (ioctl(fd, FIONREAD, &n) < 0)
+    return 0;
+  return n;
+}
+
+int NeoPixelLinuxSerial::read(void)
+{
+  uint8_t c;
+  return (::read(fd, &c, 1) == 1) ? c : -1;
+}
+
+size_t NeoPixelLinuxSerial::readBytes(uint8_t *buf, size_t n)
+{
+  ssize_t got = ::read(fd, buf, n);
+  return (got > 0) ? got : 0;
+}
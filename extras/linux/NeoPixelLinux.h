@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_LINUX_H
+#define NEOPIXEL_LINUX_H
+
+#include "Adafruit_NeoPixel.h"
+
+// Writes each frame's raw bytes to a file descriptor: a file (to record
+// a show), a FIFO feeding another process, a UART bridge, /dev/null for
+// benchmarking, etc.  The descriptor isn't closed by this class.
+class NeoPixelFileOutput : public NeoPixelOutput
+{
+
+  public:
+    NeoPixelFileOutput(int fd) : fd(fd), errors(0) {}
+    void write(const uint8_t *pixels, uint16_t numBytes);
+    uint32_t getErrors(void) const { return errors; }
+
+  private:
+    int fd;
+    uint32_t errors; // Frames not completely written
+};
+
+// Drives WS2812-type strips from an SPI MOSI pin via spidev.  Each data
+// bit is sent as three SPI bits -- 100 for 0, 110 for 1 -- at 2.4 MHz
+// (about 417 ns each), followed by enough zero bytes to latch.  spidev
+// takes at most its bufsiz parameter (default 4096 bytes, i.e. about
+// 450 RGB pixels) per transfer, so longer frames are split into
+// several, with the data line idling low in between.  A gap longer
+// than the strip's latch time (50 us or more) would show the frame in
+// two parts, so for long strips raise the limit (spidev.bufsiz=65536
+// on the kernel command line) to send each frame in one transfer.
+class NeoPixelSpiOutput : public NeoPixelOutput
+{
+
+  public:
+    NeoPixelSpiOutput(const char *device = "/dev/spidev0.0", uint32_t hz = 2400000);
+    ~NeoPixelSpiOutput();
+    void begin(void);
+    void write(const uint8_t *pixels, uint16_t numBytes);
+    bool isOpen(void) const { return fd >= 0; }
+    uint32_t getErrors(void) const { return errors; }
+
+  private:
+    const char *device;
+    int fd;
+    uint32_t hz,
+        errors; // Frames that failed to transfer
+    uint8_t *buf;
+    size_t bufSize,
+        maxTransfer; // Bytes per transfer spidev accepts
+};
+
+// Enough of the Arduino UDP API (parsePacket(), read()) to feed the
+// network receivers' poll() from a Linux socket.  parsePacket() blocks
+// for up to 'timeoutMs' (0 = forever) and returns 0 on timeout.
+class NeoPixelLinuxUDP
+{
+
+  public:
+    NeoPixelLinuxUDP() : fd(-1), len(0), pos(0) {}
+    ~NeoPixelLinuxUDP();
+    bool begin(uint16_t port, uint32_t timeoutMs = 0, bool loopbackOnly = true);
+    int parsePacket(void);
+    int read(uint8_t *buf, size_t n);
+
+  private:
+    int fd;
+    size_t len, pos;
+    uint8_t packet[1500];
+};
+
+// Stream over a serial port, pty or pipe descriptor, for receivers
+// such as NeoPixelAdalight.  Never blocks: available() is what the
+// kernel has buffered and read() returns -1 when there's nothing.
+// The descriptor isn't closed by this class.
+class NeoPixelLinuxSerial : public Stream
+{
+
+  public:
+    NeoPixelLinuxSerial(int fd) : fd(fd) {}
+    static int open(const char *device, uint32_t baud);
+    int available(void);
+    int read(void);
+    size_t readBytes(uint8_t *buf, size_t n);
+
+  private:
+    int fd;
+};
+
+#endif // NEOPIXEL_LINUX_H
@@ -0,0 +1,107 @@
+/*-------------------------------------------------------------------------
+  Mock Arduino SPI library for building clocked-LED outputs (e.g.
+  NeoPixelDotStar) on a Linux host.  Nothing is sent anywhere: bytes
+  from transfer() are captured in memory, along with the settings of
+  the last transaction, so a host program can check the wire format.
+  The SPI object is defined in NeoPixelLinux.cpp.
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#ifndef NEOPIXEL_LINUX_SPI_H
+#define NEOPIXEL_LINUX_SPI_H
+
+#include "Arduino.h"
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+
+  public:
+    SPISettings(uint32_t hz = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t mode = SPI_MODE0)
+        : hz(hz), bitOrder(bitOrder), mode(mode) {}
+    uint32_t hz;
+    uint8_t bitOrder, mode;
+};
+
+class SPIClass
+{
+
+  public:
+    SPIClass() : transactions(0), open(false), begun(false), data(NULL), len(0), size(0) {}
+    ~SPIClass() { free(data); }
+    void begin(void) { begun = true; }
+    void end(void) { begun = false; }
+    void beginTransaction(SPISettings s)
+    {
+      settings = s;
+      transactions++;
+      open = true;
+    }
+    void endTransaction(void) { open = false; }
+    uint8_t transfer(uint8_t b)
+    {
+      capture(&b, 1);
+      return 0;
+    }
+    void transfer(void *buf, size_t n)
+    {
+      capture((const uint8_t *)buf, n);
+      memset(buf, 0, n); // Nothing on MISO
+    }
+
+    // Mock only: captured bytes, and discarding them
+    const uint8_t *captured(void) const { return data; }
+    size_t capturedLength(void) const { return len; }
+    void clearCapture(void) { len = 0; }
+
+    SPISettings settings; // Of last beginTransaction()
+    uint32_t transactions;
+    bool open, begun;
+
+  private:
+    void capture(const uint8_t *buf, size_t n)
+    {
+      if ((len + n) > size)
+      {
+        size_t s = size ? size : 1024;
+        while (s < (len + n))
+          s *= 2;
+        uint8_t *d = (uint8_t *)realloc(data, s);
+        if (!d)
+          return;
+        data = d;
+        size = s;
+      }
+      memcpy(&data[len], buf, n);
+      len += n;
+    }
+
+    uint8_t *data;
+    size_t len, size;
+};
+
+extern SPIClass SPI;
+
+#endif // NEOPIXEL_LINUX_SPI_H
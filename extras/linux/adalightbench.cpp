@@ -0,0 +1,269 @@
+/*-------------------------------------------------------------------------
+  adalightbench: pty loopback test for NeoPixelAdalight.  A generator
+  thread writes Adalight frames into the master side of a pseudo-
+  terminal, paced to a serial baud rate, with a gap between frames as
+  PC ambient-lighting software leaves.  The main thread receives them
+  from the slave side through NeoPixelAdalight::poll() into a GRB strip
+  whose show() is made to block for a set time; with -l, bytes arriving
+  while it blocks are thrown away (all but the last), as happens to a
+  UART with interrupts off.  Reports frames received, shown and lost,
+  and whether the final frame arrived intact.
+
+  Build (from the library directory):
+    g++ -O2 -pthread -DARDUINO=100 -Iextras/linux -I. -o adalightbench \
+        extras/linux/adalightbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelAdalight.cpp -lutil
+
+  Usage: adalightbench [-f frames] [-r fps] [-b baud] [-s us] [-i us] [-l]
+                       [-c N] pixels
+
+  -f frames  frames to send (default 500)
+  -r fps     generator frame rate (default 60)
+  -b baud    emulated line rate, 10 bits per byte (default 1000000)
+  -s us      time show() blocks (default 30 us per pixel)
+  -i us      receiver idle time before show() (default 1000)
+  -l         lose bytes that arrive while show() blocks
+  -c N       corrupt the header checksum of every Nth frame
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelAdalight.h"
+
+#include <pthread.h>
+#include <pty.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#define BRIGHTNESS 128
+#define CHUNK 16 // Bytes written at a time
+
+static struct
+{
+  uint32_t frames, fps, baud, corrupt, pixels;
+  int fd;
+  volatile bool done;
+} gen;
+
+static uint8_t pattern(uint32_t frame, uint32_t byte)
+{
+  return (uint8_t)(frame * 7 + byte * 13);
+}
+
+static void addNanos(struct timespec &t, long ns)
+{
+  t.tv_nsec += ns;
+  while (t.tv_nsec >= 1000000000L)
+  {
+    t.tv_sec++;
+    t.tv_nsec -= 1000000000L;
+  }
+}
+
+static void *generator(void *)
+{
+  uint32_t len = 6 + gen.pixels * 3;
+  uint8_t *f = (uint8_t *)malloc(len);
+  long chunkNanos = 10L * CHUNK * 1000000000L / gen.baud;
+  struct timespec next, line;
+
+  f[0] = 'A';
+  f[1] = 'd';
+  f[2] = 'a';
+  f[3] = (gen.pixels - 1) >> 8;
+  f[4] = gen.pixels - 1;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  for (uint32_t n = 0; n < gen.frames; n++)
+  {
+    f[5] = f[3] ^ f[4] ^ 0x55;
+    if (gen.corrupt && !((n + 1) % gen.corrupt) && (n < (gen.frames - 1)))
+      f[5] ^= 0x01;
+    for (uint32_t i = 0; i < gen.pixels * 3; i++)
+      f[6 + i] = pattern(n, i);
+    line = next;
+    for (uint32_t i = 0; i < len; i += CHUNK)
+    {
+      uint32_t c = ((len - i) < CHUNK) ? (len - i) : CHUNK;
+      if (write(gen.fd, &f[i], c) < 0)
+        perror("write");
+      addNanos(line, chunkNanos);
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &line, NULL);
+    }
+    addNanos(next, 1000000000L / gen.fps);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+  }
+  // Let the receiver go idle and show the last frame
+  usleep(200000);
+  gen.done = true;
+  free(f);
+  return NULL;
+}
+
+// Stands in for the blocking, interrupts-off bit-bang in show()
+class BlockingOutput : public NeoPixelOutput
+{
+
+  public:
+    BlockingOutput(int fd, uint32_t us, bool lossy) : fd(fd), us(us), lossy(lossy), lost(0), collisions(0) {}
+    void write(const uint8_t *, uint16_t)
+    {
+      int before = 0, after = 0;
+      ioctl(fd, FIONREAD, &before);
+      usleep(us);
+      ioctl(fd, FIONREAD, &after);
+      if (after > before)
+      {
+        collisions++;
+        if (lossy)
+        { // Keep only the last byte, as a UART data register would
+          uint8_t junk[256];
+          int n = after - before - 1;
+          lost += n;
+          if (before)
+            n += before; // Can't drop from the middle; drop the oldest
+          while (n > 0)
+          {
+            ssize_t r = read(fd, junk, (n < (int)sizeof(junk)) ? n : sizeof(junk));
+            if (r <= 0)
+              break;
+            n -= r;
+          }
+        }
+      }
+    }
+    int fd;
+    uint32_t us;
+    bool lossy;
+    uint32_t lost, collisions;
+};
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: adalightbench [-f frames] [-r fps] [-b baud] [-s us] [-i us] [-l]\n"
+                  "                     [-c N] pixels\n");
+  return 2;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t showUs = 0, idleUs = 1000;
+  bool lossy = false;
+  int opt, master, slave;
+
+  gen.frames = 500;
+  gen.fps = 60;
+  gen.baud = 1000000;
+  while ((opt = getopt(argc, argv, "f:r:b:s:i:lc:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'f':
+      gen.frames = strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      gen.fps = strtoul(optarg, NULL, 0);
+      break;
+    case 'b':
+      gen.baud = strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      showUs = strtoul(optarg, NULL, 0);
+      break;
+    case 'i':
+      idleUs = strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      lossy = true;
+      break;
+    case 'c':
+      gen.corrupt = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      return usage();
+    }
+  }
+  if ((argc - optind) != 1)
+    return usage();
+  gen.pixels = strtoul(argv[optind], NULL, 0);
+  if (!gen.pixels || (gen.pixels > 65536) || !gen.frames || !gen.fps || !gen.baud)
+    return usage();
+  if (!showUs)
+    showUs = gen.pixels * 30;
+
+  if (openpty(&master, &slave, NULL, NULL, NULL) < 0)
+  {
+    perror("openpty");
+    return 1;
+  }
+  struct termios t;
+  tcgetattr(slave, &t);
+  cfmakeraw(&t);
+  tcsetattr(slave, TCSANOW, &t);
+  gen.fd = master;
+
+  BlockingOutput out(slave, showUs, lossy);
+  Adafruit_NeoPixel strip(gen.pixels, 0, NEO_GRB);
+  strip.setOutput(&out);
+  strip.setBrightness(BRIGHTNESS - 1); // Stored as BRIGHTNESS
+  strip.begin();
+
+  NeoPixelAdalight ada(strip);
+  if (!ada.begin())
+  {
+    fprintf(stderr, "no memory for buffers\n");
+    return 1;
+  }
+  ada.setIdleTime(idleUs);
+  NeoPixelLinuxSerial serial(slave);
+
+  pthread_t th;
+  pthread_create(&th, NULL, generator, NULL);
+  while (!gen.done)
+  {
+    if (!ada.poll(serial))
+      usleep(20);
+  }
+  pthread_join(th, NULL);
+
+  // Compare the last frame
+  uint32_t bad = 0, last = gen.frames - 1;
+  const uint8_t *p = strip.getPixels();
+  for (uint32_t i = 0; i < gen.pixels; i++)
+  {
+    if ((p[i * 3 + 1] != ((pattern(last, i * 3) * BRIGHTNESS) >> 8)) ||
+        (p[i * 3] != ((pattern(last, i * 3 + 1) * BRIGHTNESS) >> 8)) ||
+        (p[i * 3 + 2] != ((pattern(last, i * 3 + 2) * BRIGHTNESS) >> 8)))
+      bad++;
+  }
+
+  const neoAdalightStats &s = ada.getStats();
+  printf("%u pixels, %u frames at %u fps, %u baud, show() %u us, idle %u us%s\n",
+         gen.pixels, gen.frames, gen.fps, gen.baud, showUs, idleUs,
+         lossy ? ", lossy" : "");
+  printf("received %u, shown %u, skipped %u, bad checksum %u, overruns %u, "
+         "timeouts %u,\n"
+         "discarded %u bytes\n",
+         s.frames, s.shown, s.skipped, s.checksum, s.overruns, s.timeouts, s.discarded);
+  printf("bytes arrived during show() %u times, %u lost\n", out.collisions, out.lost);
+  printf("final frame %s\n", bad ? "CORRUPT" : "intact");
+  close(master);
+  close(slave);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*-------------------------------------------------------------------------
+  blendbench: checks and times NeoPixelCompositor's blend kernels.  A
+  strip gets an opaque base layer and one layer above it in each blend
+  mode, fully opaque and half transparent, with and without strip
+  brightness.  flatten() must produce exactly the bytes of a plain
+  per-channel reference, and is timed against compositing the way
+  sketches did before: reading both colors back with getPixelColor()
+  and writing the mix with setPixelColor().
+
+  The kernel is chosen when the library is built, so build once per
+  kernel to compare them: as below for SSE2, adding -DNEO_BLEND_NO_SIMD
+  for the 32-bit word kernel (normal and add modes; the others fall
+  back to bytes) or -DNEO_BLEND_PORTABLE for bytes only.  The compiler
+  may vectorize the byte loop by itself; add -fno-tree-vectorize to
+  time it as written.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o blendbench \
+        extras/linux/blendbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelCompositor.cpp
+
+  Usage: blendbench [pixels]   (default 1000)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelCompositor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PIXELS_TIMED 4e6 // Pixels composited per measurement
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// x / 255, rounded
+static uint8_t div255(uint32_t x)
+{
+  return (2 * x + 255) / 510;
+}
+
+// One channel of a layer 's' over 'd' in 'mode' at opacity 'a' (1-256)
+static uint8_t reference(uint8_t mode, uint8_t d, uint8_t s, uint16_t a)
+{
+  uint16_t f;
+  switch (mode)
+  {
+  case NEO_BLEND_ADD:
+    f = (d + s > 255) ? 255 : d + s;
+    break;
+  case NEO_BLEND_MULTIPLY:
+    f = div255(d * s);
+    break;
+  case NEO_BLEND_SCREEN:
+    f = 255 - div255((255 - d) * (255 - s));
+    break;
+  case NEO_BLEND_MAX:
+    f = (d > s) ? d : s;
+    break;
+  default:
+    f = s;
+    break;
+  }
+  return (f * a + d * (256 - a)) >> 8;
+}
+
+// Composite the way sketches did: read each color back and write the mix
+static void readBack(Adafruit_NeoPixel &strip, Adafruit_NeoPixel &base, Adafruit_NeoPixel &top,
+                     uint8_t mode, uint16_t a)
+{
+  for (uint16_t i = 0; i < strip.numPixels(); i++)
+  {
+    uint32_t d = base.getPixelColor(i), s = top.getPixelColor(i), c = 0;
+    for (uint8_t k = 0; k < 24; k += 8)
+      c |= (uint32_t)reference(mode, d >> k, s >> k, a) << k;
+    strip.setPixelColor(i, c);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  uint16_t n = (argc > 1) ? atoi(argv[1]) : 1000;
+  static const char *modes[] = {"normal", "add", "multiply", "screen", "max"};
+  uint32_t failed = 0;
+  struct timespec t0, t1;
+
+  if (n < 1)
+  {
+    fprintf(stderr, "Usage: %s [pixels]\n", argv[0]);
+    return 1;
+  }
+  int repeat = PIXELS_TIMED / n;
+
+  printf("%u pixels, ", n);
+#if defined(NEO_BLEND_SSE2)
+  printf("SSE2 kernel");
+#elif defined(NEO_BLEND_SWAR)
+  printf("word kernel");
+#else
+  printf("bytewise");
+#endif
+  printf(", ns/pixel:       read-back  flatten()  speedup\n");
+
+  for (uint8_t mode = NEO_BLEND_NORMAL; mode <= NEO_BLEND_MAX; mode++)
+  {
+    for (uint8_t v = 0; v < 4; v++)
+    {
+      uint8_t opacity = (v & 1) ? 127 : 255, brightness = (v & 2) ? 100 : 0;
+      Adafruit_NeoPixel strip(n, -1, NEO_GRB), ref(n, -1, NEO_GRB);
+      NeoPixelLayer base(strip), top(strip, mode, opacity);
+      NeoPixelCompositor comp(strip);
+      comp.addLayer(base);
+      comp.addLayer(top);
+      if (brightness)
+      {
+        strip.setBrightness(brightness);
+        ref.setBrightness(brightness);
+      }
+      // A spread of byte pairs, different in each channel
+      uint8_t *b = base.getPixels(), *t = top.getPixels(), *r = ref.getPixels();
+      for (uint32_t i = 0; i < n * 3u; i++)
+      {
+        b[i] = i * 7 + (i >> 8);
+        t[i] = i * 13 + (i >> 5);
+      }
+      comp.flatten();
+      for (uint32_t i = 0; i < n * 3u; i++)
+      {
+        r[i] = reference(mode, b[i], t[i], opacity + 1);
+        if (brightness)
+          r[i] = (r[i] * (brightness + 1)) >> 8;
+      }
+      bool bad = memcmp(strip.getPixels(), r, n * 3);
+      if (bad)
+        failed++;
+
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      for (int k = 0; k < repeat; k++)
+        readBack(strip, base, top, mode, opacity + 1);
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      double slow = elapsed(t0, t1) / repeat / n;
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      for (int k = 0; k < repeat; k++)
+      {
+        top.setPixelColor(k % n, k); // So flatten() has something to do
+        comp.flatten();
+      }
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      double fast = elapsed(t0, t1) / repeat / n;
+      printf("%-8s opacity %3u%-14s %9.2f  %9.2f  %6.1fx%s\n", modes[mode], opacity,
+             brightness ? ", brightness" : "", slow, fast, slow / fast, bad ? "  MISMATCH" : "");
+    }
+  }
+
+  printf("%s\n", failed ? "FAILED" : "all modes match reference");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+/*-------------------------------------------------------------------------
+  correctbench: checks and times the color correction pass show() runs
+  with setColorCorrection() / setWhitePoint().  Strips are shown to a
+  NeoPixelOutput that keeps the bytes it's given, which must match a
+  floating-point reference (matrix times white point, rounded) to
+  within 1.  Then times show() on a 1000-pixel strip with no
+  correction, a white point only, a 3x3 matrix (GRB) and a 4x4 matrix
+  (GRBW), against correcting in floating point in sketch code with
+  getPixelColor() and setPixelColor() each frame.
+
+  Runs the same on ARM Linux boards (e.g. Raspberry Pi) for a 32-bit
+  ARM figure.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o correctbench \
+        extras/linux/correctbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define PIXELS 1000
+#define REPEAT 2000 // Frames timed per measurement
+
+// Keeps a copy of the last frame written
+class CaptureOutput : public NeoPixelOutput
+{
+
+  public:
+    uint8_t frame[PIXELS * 4];
+    void write(const uint8_t *pixels, uint16_t numBytes)
+    {
+      memcpy(frame, pixels, numBytes);
+    }
+};
+
+// Sensor crosstalk-style correction: mostly diagonal, small mixes
+static const int16_t matrix3[9] = {240, 20, -4,
+                                   10, 230, 16,
+                                   0, 12, 244};
+static const int16_t matrix4[16] = {240, 20, -4, 0,
+                                    10, 230, 16, 0,
+                                    0, 12, 244, 0,
+                                    8, 8, 8, 230};
+static const uint8_t whitePoint[4] = {0xFF, 0xB0, 0xF0, 0xE0};
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// Channel values of pixel i in R,G,B,W order, from a device-order buffer
+static void channels(const uint8_t *buf, neoPixelType t, uint16_t i, uint8_t *c)
+{
+  uint8_t bpp = ((t >> 6 & 3) == (t >> 4 & 3)) ? 3 : 4;
+  c[0] = buf[i * bpp + (t >> 4 & 3)];
+  c[1] = buf[i * bpp + (t >> 2 & 3)];
+  c[2] = buf[i * bpp + (t & 3)];
+  c[3] = (bpp == 4) ? buf[i * bpp + (t >> 6 & 3)] : 0;
+}
+
+// Largest difference between shown bytes and the float reference
+static int check(neoPixelType t, const int16_t *m, uint8_t size, bool wp)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, t);
+  CaptureOutput out;
+  uint8_t n = size, in[4], got[4];
+  int worst = 0;
+
+  strip.setOutput(&out);
+  strip.fillRainbow(0, 0, 0, 300, 200);
+  for (uint16_t i = 0; i < PIXELS; i += 7)
+    strip.setPixelColor(i, i, 255 - i, i * 3, i * 5);
+  if (m && !strip.setColorCorrection(m, size))
+    return 999;
+  if (wp && !strip.setWhitePoint(whitePoint[0], whitePoint[1], whitePoint[2], whitePoint[3]))
+    return 999;
+  strip.show();
+  for (uint16_t i = 0; i < PIXELS; i++)
+  {
+    channels(strip.getPixels(), t, i, in);
+    channels(out.frame, t, i, got);
+    for (uint8_t r = 0; r < n; r++)
+    {
+      double v = 0;
+      for (uint8_t c = 0; c < n; c++)
+        v += (m ? m[r * size + c] : ((r == c) ? 256 : 0)) / 256.0 * in[c];
+      if (wp)
+        v *= whitePoint[r] / 255.0;
+      int ref = (int)lround(v < 0 ? 0 : (v > 255 ? 255 : v));
+      if (abs(ref - got[r]) > worst)
+        worst = abs(ref - got[r]);
+    }
+  }
+  return worst;
+}
+
+static double timeShow(neoPixelType t, const int16_t *m, uint8_t size, bool wp)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, t);
+  CaptureOutput out;
+  struct timespec t0, t1;
+
+  strip.setOutput(&out);
+  strip.fillRainbow(0, 0, 0, 300, 200);
+  if (m)
+    strip.setColorCorrection(m, size);
+  if (wp)
+    strip.setWhitePoint(whitePoint[0], whitePoint[1], whitePoint[2], whitePoint[3]);
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < REPEAT; r++)
+    strip.show();
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return elapsed(t0, t1) / REPEAT / PIXELS;
+}
+
+// What sketches did before: float math on every pixel, every frame,
+// drawing from a separate source buffer
+static double timeSketch(void)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, NEO_GRB), src(PIXELS, -1, NEO_GRB);
+  CaptureOutput out;
+  struct timespec t0, t1;
+  float f[9];
+
+  for (uint8_t i = 0; i < 9; i++)
+    f[i] = matrix3[i] / 256.0f * whitePoint[i / 3] / 255.0f;
+  strip.setOutput(&out);
+  src.fillRainbow(0, 0, 0, 300, 200);
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < REPEAT; r++)
+  {
+    for (uint16_t i = 0; i < PIXELS; i++)
+    {
+      uint32_t c = src.getPixelColor(i);
+      float in[3] = {(float)(uint8_t)(c >> 16), (float)(uint8_t)(c >> 8), (float)(uint8_t)c}, o[3];
+      for (uint8_t k = 0; k < 3; k++)
+      {
+        o[k] = f[k * 3] * in[0] + f[k * 3 + 1] * in[1] + f[k * 3 + 2] * in[2] + 0.5f;
+        o[k] = (o[k] < 0) ? 0 : (o[k] > 255) ? 255 : o[k];
+      }
+      strip.setPixelColor(i, (uint8_t)o[0], (uint8_t)o[1], (uint8_t)o[2]);
+    }
+    strip.show();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return elapsed(t0, t1) / REPEAT / PIXELS;
+}
+
+int main(void)
+{
+  static const struct
+  {
+    const char *name;
+    neoPixelType type;
+    const int16_t *matrix;
+    uint8_t size;
+    bool wp;
+  } cases[] = {{"GRB, no correction", NEO_GRB, NULL, 3, false},
+               {"GRB, white point", NEO_GRB, NULL, 3, true},
+               {"GRB, 3x3", NEO_GRB, matrix3, 3, false},
+               {"GRB, 3x3 + white point", NEO_GRB, matrix3, 3, true},
+               {"BGR, 3x3 + white point", NEO_BGR, matrix3, 3, true},
+               {"GRBW, white point", NEO_GRBW, NULL, 4, true},
+               {"GRBW, 4x4 + white point", NEO_GRBW, matrix4, 4, true},
+               {"WRGB, 4x4", NEO_WRGB, matrix4, 4, false}};
+  uint32_t failed = 0;
+
+  printf("%u pixels                 ns/pixel  max error\n", PIXELS);
+  for (uint8_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    int e = check(cases[i].type, cases[i].matrix, cases[i].size, cases[i].wp);
+    if (e > 1)
+      failed++;
+    printf("%-24s %8.2f  %9d%s\n", cases[i].name,
+           timeShow(cases[i].type, cases[i].matrix, cases[i].size, cases[i].wp),
+           e, (e > 1) ? "  FAILED" : "");
+  }
+  printf("%-24s %8.2f\n", "GRB, float in sketch", timeSketch());
+  printf("%s\n", failed ? "FAILED" : "all corrected frames within 1 of reference");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/*-------------------------------------------------------------------------
+  ddpbench: loopback test and benchmark for NeoPixelDDP.  A generator
+  thread sends frames over UDP to 127.0.0.1, split into packets with
+  the push flag on each frame's last packet.  The main thread receives
+  them through NeoPixelDDP::poll() into two strips -- an RGB strip
+  (payload read straight into the buffer) followed by a GRB strip with
+  brightness set (bounce-buffer path) -- and reports packets per second,
+  latency from a frame's first packet to show(), loss and reordering,
+  and whether the final frame arrived intact.  Packets can be dropped
+  or swapped on purpose to exercise the statistics.
+
+  Build (from the library directory):
+    g++ -O2 -pthread -DARDUINO=100 -Iextras/linux -I. -o ddpbench \
+        extras/linux/ddpbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelDDP.cpp
+
+  Usage: ddpbench [-f frames] [-r fps] [-p bytes] [-d N] [-x N] pixels
+
+  -f frames  frames to send (default 1000)
+  -r fps     generator frame rate (default 0 = as fast as possible)
+  -p bytes   payload bytes per packet (default 1440)
+  -d N       drop every Nth packet
+  -x N       swap every Nth packet with the one after it
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelDDP.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define BRIGHTNESS 128 // Second strip
+
+static struct
+{
+  uint32_t frames, fps, payload, drop, swap, pixels;
+  volatile uint64_t sent;
+  volatile bool done;
+} gen;
+
+static uint8_t pattern(uint32_t frame, uint32_t byte)
+{
+  return (uint8_t)(frame * 7 + byte * 13);
+}
+
+static void *generator(void *)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in a;
+  uint32_t frameBytes = gen.pixels * 3, packet = 0;
+  uint8_t p[2][10 + 1500], seq = 1;
+  uint16_t held = 0; // Length of packet held back for swapping
+  struct timespec next;
+
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(NEO_DDP_PORT);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  clock_gettime(CLOCK_MONOTONIC, &next);
+
+  for (uint32_t f = 0; f < gen.frames; f++)
+  {
+    for (uint32_t off = 0; off < frameBytes; off += gen.payload)
+    {
+      uint16_t n = ((frameBytes - off) < gen.payload) ? (frameBytes - off) : gen.payload;
+      uint8_t *h = p[held ? 1 : 0];
+      bool last = (off + n) >= frameBytes;
+      h[0] = 0x40 | (last ? 0x01 : 0);
+      h[1] = seq;
+      h[2] = 0x0B; // RGB, 8 bits per channel
+      h[3] = 1;
+      h[4] = off >> 24;
+      h[5] = off >> 16;
+      h[6] = off >> 8;
+      h[7] = off;
+      h[8] = n >> 8;
+      h[9] = n;
+      for (uint16_t i = 0; i < n; i++)
+        h[10 + i] = pattern(f, off + i);
+      seq = (seq % 15) + 1;
+      packet++;
+
+      if (gen.drop && !(packet % gen.drop) && !last)
+        continue; // Never drop a push, so every frame is shown
+      if (gen.swap && !(packet % gen.swap) && !last && !held)
+      {
+        held = 10 + n; // Send after the next one
+        continue;
+      }
+      if (sendto(fd, h, 10 + n, 0, (struct sockaddr *)&a, sizeof(a)) == 10 + n)
+        gen.sent++;
+      if (held)
+      {
+        if (sendto(fd, p[0], held, 0, (struct sockaddr *)&a, sizeof(a)) == held)
+          gen.sent++;
+        held = 0;
+      }
+    }
+    if (gen.fps)
+    {
+      next.tv_nsec += 1000000000L / gen.fps;
+      if (next.tv_nsec >= 1000000000L)
+      {
+        next.tv_sec++;
+        next.tv_nsec -= 1000000000L;
+      }
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+  }
+  gen.done = true;
+  close(fd);
+  return NULL;
+}
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: ddpbench [-f frames] [-r fps] [-p bytes] [-d N] [-x N] pixels\n");
+  return 2;
+}
+
+int main(int argc, char **argv)
+{
+  int opt;
+
+  gen.frames = 1000;
+  gen.payload = 1440;
+  while ((opt = getopt(argc, argv, "f:r:p:d:x:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'f':
+      gen.frames = strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      gen.fps = strtoul(optarg, NULL, 0);
+      break;
+    case 'p':
+      gen.payload = strtoul(optarg, NULL, 0);
+      break;
+    case 'd':
+      gen.drop = strtoul(optarg, NULL, 0);
+      break;
+    case 'x':
+      gen.swap = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      return usage();
+    }
+  }
+  if ((argc - optind) != 1)
+    return usage();
+  gen.pixels = strtoul(argv[optind], NULL, 0);
+  if ((gen.pixels < 2) || (gen.pixels > 2 * 21845) || !gen.frames ||
+      !gen.payload || (gen.payload > 1440))
+    return usage();
+
+  // Two strips sharing the address space, split unevenly so packets
+  // straddle the boundary
+  uint16_t n1 = gen.pixels / 3, n2 = gen.pixels - n1;
+  int devnull = open("/dev/null", O_WRONLY);
+  NeoPixelFileOutput out(devnull);
+  Adafruit_NeoPixel a(n1, 0, NEO_RGB), b(n2, 0, NEO_GRB);
+  a.setOutput(&out);
+  b.setOutput(&out);
+  b.setBrightness(BRIGHTNESS - 1); // Stored as BRIGHTNESS
+  a.begin();
+  b.begin();
+
+  NeoPixelDDP ddp(2);
+  ddp.addStrip(a);
+  ddp.addStrip(b);
+
+  NeoPixelLinuxUDP udp;
+  if (!udp.begin(NEO_DDP_PORT, 200))
+  {
+    perror("bind");
+    return 1;
+  }
+
+  pthread_t t;
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  t1 = t0;
+  pthread_create(&t, NULL, generator, NULL);
+  uint32_t idle = 0;
+  while (!gen.done || (idle < 2))
+  {
+    if (ddp.poll(udp))
+    {
+      idle = 0;
+      clock_gettime(CLOCK_MONOTONIC, &t1); // Time of last packet
+    }
+    else if (gen.done)
+    {
+      idle++; // Receive timed out after generator finished
+    }
+  }
+  pthread_join(t, NULL);
+
+  // Compare the last frame (unless packets were dropped from it)
+  uint32_t bad = 0, last = gen.frames - 1;
+  const uint8_t *pa = a.getPixels(), *pb = b.getPixels();
+  for (uint32_t i = 0; i < (uint32_t)n1 * 3; i++)
+    if (pa[i] != pattern(last, i))
+      bad++;
+  for (uint32_t i = 0; i < (uint32_t)n2; i++)
+  {
+    uint32_t o = (n1 + i) * 3;
+    if ((pb[i * 3 + 1] != ((pattern(last, o) * BRIGHTNESS) >> 8)) ||
+        (pb[i * 3] != ((pattern(last, o + 1) * BRIGHTNESS) >> 8)) ||
+        (pb[i * 3 + 2] != ((pattern(last, o + 2) * BRIGHTNESS) >> 8)))
+      bad++;
+  }
+
+  const neoDDPStats &s = ddp.getStats();
+  double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  printf("%u pixels (%u RGB + %u GRB), %u frames, %u-byte packets\n",
+         gen.pixels, n1, n2, gen.frames, gen.payload);
+  printf("sent %llu, received %u (%.0f packets/s), lost %u, reordered %u, ignored %u\n",
+         (unsigned long long)gen.sent, s.packets, s.packets / secs,
+         s.lost, s.reordered, s.ignored);
+  printf("pushes %u (%.0f fps), latency to show() avg %.1f us, max %u us\n",
+         s.pushes, s.pushes / secs, s.pushes ? (double)s.totalLatency / s.pushes : 0.0,
+         s.maxLatency);
+  if (gen.drop)
+    printf("final frame not checked (packets dropped)\n");
+  else
+    printf("final frame %s\n", bad ? "CORRUPT" : "intact");
+  close(devnull);
+  return (bad && !gen.drop) ? 1 : 0;
+}
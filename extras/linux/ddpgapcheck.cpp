@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------
+  ddpgapcheck: checks where NeoPixelDDP puts payload bytes when a strip
+  in the middle of its address space has been shortened after
+  addStrip().  Strips keep the base offsets they were added with, so
+  the shortened strip leaves a gap; bytes addressed to the gap must be
+  skipped and everything after it must still land in the next strip
+  (at the same place as before the resize), including packets that
+  start in, end in, or exactly cover the gap.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o ddpgapcheck \
+        extras/linux/ddpgapcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelDDP.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelDDP.h"
+
+#include <stdio.h>
+
+#define PIXELS 10 // Per strip, as added
+#define SHORT 5   // Middle strip after updateLength()
+
+static uint32_t failures;
+
+// Send 'n' payload bytes for address space offset 'off'; byte i of the
+// space always carries value i + 1, so any misplaced byte shows
+static bool send(NeoPixelDDP &ddp, uint32_t off, uint16_t n)
+{
+  uint8_t pkt[10 + 255];
+  pkt[0] = 0x41; // Version 1, push
+  pkt[1] = 0;
+  pkt[2] = 0x0B;
+  pkt[3] = 1;
+  pkt[4] = off >> 24;
+  pkt[5] = off >> 16;
+  pkt[6] = off >> 8;
+  pkt[7] = off;
+  pkt[8] = n >> 8;
+  pkt[9] = n;
+  for (uint16_t i = 0; i < n; i++)
+    pkt[10 + i] = off + i + 1;
+  return ddp.handlePacket(pkt, 10 + n);
+}
+
+// Pixel 'px' of 'strip' should hold address space bytes from 'off' on
+// (-1 = left unwritten)
+static void expect(const char *test, Adafruit_NeoPixel &strip, const char *name, uint16_t px,
+                   int32_t off)
+{
+  uint32_t want = (off >= 0) ? strip.Color(off + 1, off + 2, off + 3) : 0,
+           got = strip.getPixelColor(px);
+  if (got != want)
+  {
+    printf("%s: strip %s pixel %u is %06X, expected %06X\n", test, name, px, got, want);
+    failures++;
+  }
+}
+
+int main(void)
+{
+  // A is RGB (payload read straight in), B and C are GRB (reordered)
+  Adafruit_NeoPixel a(PIXELS, -1, NEO_RGB), b(PIXELS, -1, NEO_GRB), c(PIXELS, -1, NEO_GRB);
+  NeoPixelDDP ddp(3);
+  ddp.addStrip(a); // Bytes 0-29
+  ddp.addStrip(b); // Bytes 30-59, then 30-44 after the resize
+  ddp.addStrip(c); // Bytes 60-89
+  b.updateLength(SHORT);
+
+  static const struct
+  {
+    const char *name;
+    uint32_t off;
+    uint16_t n;
+  } tests[] = {{"whole space", 0, 90},
+               {"gap only", 45, 15},
+               {"from gap", 50, 19},
+               {"across gap", 39, 30},
+               {"into gap", 36, 12}};
+
+  for (uint8_t t = 0; t < sizeof(tests) / sizeof(tests[0]); t++)
+  {
+    uint32_t from = tests[t].off, to = from + tests[t].n;
+    a.clear();
+    b.clear();
+    c.clear();
+    if (!send(ddp, from, tests[t].n))
+    {
+      printf("%s: packet rejected\n", tests[t].name);
+      failures++;
+    }
+    // A pixel is only fully written if all three of its bytes were sent
+    for (uint16_t i = 0; i < PIXELS; i++)
+    {
+      uint32_t o = i * 3;
+      expect(tests[t].name, a, "A", i, (o >= from && o + 3 <= to) ? (int32_t)o : -1);
+      if (i < SHORT)
+      {
+        o = 30 + i * 3;
+        expect(tests[t].name, b, "B", i, (o >= from && o + 3 <= to) ? (int32_t)o : -1);
+      }
+      o = 60 + i * 3;
+      expect(tests[t].name, c, "C", i, (o >= from && o + 3 <= to) ? (int32_t)o : -1);
+    }
+  }
+
+  printf("%s\n", failures ? "FAILED" : "all bytes where expected");
+  return failures ? 1 : 0;
+}
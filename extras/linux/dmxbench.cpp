@@ -0,0 +1,297 @@
+/*-------------------------------------------------------------------------
+  dmxbench: loopback test and throughput benchmark for NeoPixelDMX.  A
+  generator thread sends E1.31 or Art-Net frames over UDP to 127.0.0.1;
+  the main thread receives them through NeoPixelDMX::poll() into GRB
+  strips (exercising the swizzle path) and reports packets and frames
+  per second, loss, and whether the final frame arrived intact.
+
+  Build (from the library directory):
+    g++ -O2 -pthread -DARDUINO=100 -Iextras/linux -I. -o dmxbench \
+        extras/linux/dmxbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelDMX.cpp
+
+  Usage: dmxbench [-a] [-s] [-f frames] [-r fps] pixels
+
+  -a         Art-Net (default E1.31)
+  -s         synchronized: send a sync packet after each frame
+  -f frames  frames to send (default 1000)
+  -r fps     generator frame rate (default 0 = as fast as possible)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelDMX.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PIXELS_PER_UNIVERSE 170
+#define MAX_UNIVERSES 64
+
+static struct
+{
+  bool artnet, synced;
+  uint32_t frames, fps;
+  uint16_t pixels, universes, port;
+  volatile uint64_t sent;
+  volatile bool done;
+} gen;
+
+static uint8_t pattern(uint32_t frame, uint32_t channel)
+{
+  return (uint8_t)(frame * 7 + channel * 13);
+}
+
+static uint16_t buildE131(uint8_t *p, uint16_t universe, uint8_t seq, uint16_t syncAddr,
+                          const uint8_t *ch, uint16_t n)
+{
+  static const uint8_t id[12] = {0x41, 0x53, 0x43, 0x2D, 0x45, 0x31, 0x2E, 0x31, 0x37, 0, 0, 0};
+  uint16_t len = 126 + n;
+  memset(p, 0, 126);
+  p[1] = 0x10;
+  memcpy(&p[4], id, 12);
+  p[16] = 0x70 | ((len - 16) >> 8);
+  p[17] = len - 16;
+  p[21] = 0x04;
+  p[38] = 0x70 | ((len - 38) >> 8);
+  p[39] = len - 38;
+  p[43] = 0x02;
+  strcpy((char *)&p[44], "dmxbench");
+  p[108] = 100;
+  p[109] = syncAddr >> 8;
+  p[110] = syncAddr;
+  p[111] = seq;
+  p[113] = universe >> 8;
+  p[114] = universe;
+  p[115] = 0x70 | ((len - 115) >> 8);
+  p[116] = len - 115;
+  p[117] = 0x02;
+  p[118] = 0xA1;
+  p[122] = 1;
+  p[123] = (n + 1) >> 8;
+  p[124] = n + 1;
+  memcpy(&p[126], ch, n);
+  return len;
+}
+
+static uint16_t buildE131Sync(uint8_t *p, uint8_t seq, uint16_t syncAddr)
+{
+  static const uint8_t id[12] = {0x41, 0x53, 0x43, 0x2D, 0x45, 0x31, 0x2E, 0x31, 0x37, 0, 0, 0};
+  memset(p, 0, 49);
+  p[1] = 0x10;
+  memcpy(&p[4], id, 12);
+  p[16] = 0x70;
+  p[17] = 49 - 16;
+  p[21] = 0x08;
+  p[38] = 0x70;
+  p[39] = 49 - 38;
+  p[43] = 0x01;
+  p[44] = seq;
+  p[45] = syncAddr >> 8;
+  p[46] = syncAddr;
+  return 49;
+}
+
+static uint16_t buildArtDmx(uint8_t *p, uint16_t universe, uint8_t seq,
+                            const uint8_t *ch, uint16_t n)
+{
+  memcpy(p, "Art-Net", 8);
+  p[8] = 0x00;
+  p[9] = 0x50;
+  p[10] = 0;
+  p[11] = 14;
+  p[12] = seq;
+  p[13] = 0;
+  p[14] = universe;
+  p[15] = universe >> 8;
+  p[16] = n >> 8;
+  p[17] = n;
+  memcpy(&p[18], ch, n);
+  return 18 + n;
+}
+
+static uint16_t buildArtSync(uint8_t *p)
+{
+  memcpy(p, "Art-Net", 8);
+  p[8] = 0x00;
+  p[9] = 0x52;
+  p[10] = 0;
+  p[11] = 14;
+  p[12] = p[13] = 0;
+  return 14;
+}
+
+static void *generator(void *)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in a;
+  uint8_t p[NEO_DMX_MAX_PACKET], ch[NEO_DMX_CHANNELS];
+  uint8_t seq = 1;
+  struct timespec next;
+
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(gen.port);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  clock_gettime(CLOCK_MONOTONIC, &next);
+
+  for (uint32_t f = 0; f < gen.frames; f++)
+  {
+    for (uint16_t u = 0; u < gen.universes; u++)
+    {
+      uint16_t px = gen.pixels - u * PIXELS_PER_UNIVERSE, n, len;
+      if (px > PIXELS_PER_UNIVERSE)
+        px = PIXELS_PER_UNIVERSE;
+      n = px * 3;
+      for (uint16_t c = 0; c < n; c++)
+        ch[c] = pattern(f, u * PIXELS_PER_UNIVERSE * 3 + c);
+      if (gen.artnet)
+        len = buildArtDmx(p, u, seq, ch, n);
+      else
+        len = buildE131(p, u + 1, seq, gen.synced ? 999 : 0, ch, n);
+      if (sendto(fd, p, len, 0, (struct sockaddr *)&a, sizeof(a)) == len)
+        gen.sent++;
+    }
+    if (gen.synced)
+    {
+      uint16_t len = gen.artnet ? buildArtSync(p) : buildE131Sync(p, seq, 999);
+      if (sendto(fd, p, len, 0, (struct sockaddr *)&a, sizeof(a)) == len)
+        gen.sent++;
+    }
+    if (!++seq)
+      seq = 1;
+    if (gen.fps)
+    {
+      next.tv_nsec += 1000000000L / gen.fps;
+      if (next.tv_nsec >= 1000000000L)
+      {
+        next.tv_sec++;
+        next.tv_nsec -= 1000000000L;
+      }
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+  }
+  gen.done = true;
+  close(fd);
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  int opt;
+
+  gen.frames = 1000;
+  while ((opt = getopt(argc, argv, "asf:r:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'a':
+      gen.artnet = true;
+      break;
+    case 's':
+      gen.synced = true;
+      break;
+    case 'f':
+      gen.frames = strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      gen.fps = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      fprintf(stderr, "usage: dmxbench [-a] [-s] [-f frames] [-r fps] pixels\n");
+      return 2;
+    }
+  }
+  if ((argc - optind) != 1)
+  {
+    fprintf(stderr, "usage: dmxbench [-a] [-s] [-f frames] [-r fps] pixels\n");
+    return 2;
+  }
+  gen.pixels = strtoul(argv[optind], NULL, 0);
+  gen.universes = (gen.pixels + PIXELS_PER_UNIVERSE - 1) / PIXELS_PER_UNIVERSE;
+  gen.port = gen.artnet ? NEO_DMX_ARTNET_PORT : NEO_DMX_E131_PORT;
+  if (!gen.pixels || (gen.universes > MAX_UNIVERSES))
+  {
+    fprintf(stderr, "dmxbench: pixels must be 1-%u\n", MAX_UNIVERSES * PIXELS_PER_UNIVERSE);
+    return 2;
+  }
+
+  int devnull = open("/dev/null", O_WRONLY);
+  NeoPixelFileOutput out(devnull);
+  Adafruit_NeoPixel strip(gen.pixels, 0, NEO_GRB);
+  strip.setOutput(&out);
+  strip.begin();
+
+  NeoPixelDMX dmx(gen.universes);
+  for (uint16_t u = 0; u < gen.universes; u++)
+    dmx.addUniverse(gen.artnet ? u : u + 1, strip, u * PIXELS_PER_UNIVERSE);
+
+  NeoPixelLinuxUDP udp;
+  if (!udp.begin(gen.port, 200))
+  {
+    perror("bind");
+    return 1;
+  }
+
+  pthread_t t;
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  pthread_create(&t, NULL, generator, NULL);
+  uint32_t idle = 0;
+  while (!gen.done || (idle < 2))
+  {
+    if (dmx.poll(udp))
+    {
+      idle = 0;
+      clock_gettime(CLOCK_MONOTONIC, &t1); // Time of last packet
+    }
+    else if (gen.done)
+    {
+      idle++; // Receive timed out after generator finished
+    }
+  }
+  pthread_join(t, NULL);
+
+  // Last frame, as sent in RGB order, should now be in the GRB strip
+  uint32_t bad = 0, last = gen.frames - 1;
+  for (uint16_t i = 0; i < gen.pixels; i++)
+  {
+    uint32_t c = strip.getPixelColor(i);
+    uint8_t r = pattern(last, i * 3), g = pattern(last, i * 3 + 1), b = pattern(last, i * 3 + 2);
+    if (c != Adafruit_NeoPixel::Color(r, g, b))
+      bad++;
+  }
+
+  const neoDMXStats &s = dmx.getStats();
+  double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  printf("%s%s, %u pixels in %u universes, %u frames\n",
+         gen.artnet ? "Art-Net" : "E1.31", gen.synced ? " (synced)" : "",
+         gen.pixels, gen.universes, gen.frames);
+  printf("sent %llu, received %u (%.0f packets/s), lost %llu, out of sequence %u\n",
+         (unsigned long long)gen.sent, s.packets, s.packets / secs,
+         (unsigned long long)(gen.sent - s.packets), s.sequence);
+  printf("shown %u frames (%.0f fps), syncs %u, ignored %u, final frame %s\n",
+         s.frames, s.frames / secs, s.syncs, s.ignored, bad ? "CORRUPT" : "intact");
+  close(devnull);
+  return bad ? 1 : 0;
+}
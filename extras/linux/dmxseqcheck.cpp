@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------
+  dmxseqcheck: checks NeoPixelDMX's sequence-number filtering when one
+  universe maps onto several strips.  Each mapping tracks the sequence
+  itself, so a packet can be stale for one mapping (strip A, mapped
+  first) but new to another (strip B, mapped after A's first packet).
+  Only the stale mapping may drop it: the others must still be written
+  and shown.  A packet stale for every mapping must change nothing.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o dmxseqcheck \
+        extras/linux/dmxseqcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelDMX.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelDMX.h"
+
+#include <stdio.h>
+
+#define PIXELS 10 // Per strip
+
+static uint32_t failures;
+
+// An ArtDmx packet for universe 1: every channel 'value'
+static bool send(NeoPixelDMX &dmx, uint8_t seq, uint8_t value)
+{
+  uint8_t pkt[18 + PIXELS * 3] = {'A', 'r', 't', '-', 'N', 'e', 't', 0, 0x00, 0x50, 0, 14, seq,
+                                  0,   1,   0,   0,   PIXELS * 3};
+  memset(&pkt[18], value, PIXELS * 3);
+  return dmx.handlePacket(pkt, sizeof(pkt));
+}
+
+static void expect(const char *test, const char *what, uint32_t got, uint32_t want)
+{
+  if (got != want)
+  {
+    printf("%s: %s is %X, expected %X\n", test, what, got, want);
+    failures++;
+  }
+}
+
+int main(void)
+{
+  Adafruit_NeoPixel a(PIXELS, -1, NEO_RGB), b(PIXELS, -1, NEO_RGB);
+  NeoPixelDMX dmx(2);
+
+  dmx.addUniverse(1, a);
+  send(dmx, 5, 0x11);
+  dmx.addUniverse(1, b); // Has seen no sequence number yet
+
+  static const struct
+  {
+    const char *name;
+    uint8_t seq, value;
+    uint32_t a, b, data, sequence, frames; // Afterward
+  } tests[] = {{"stale for A only", 5, 0x22, 0x111111, 0x222222, 2, 1, 2},
+               {"new for both", 6, 0x33, 0x333333, 0x333333, 3, 1, 4},
+               {"stale for both", 6, 0x44, 0x333333, 0x333333, 3, 2, 4}};
+
+  for (uint8_t t = 0; t < sizeof(tests) / sizeof(tests[0]); t++)
+  {
+    send(dmx, tests[t].seq, tests[t].value);
+    const neoDMXStats &s = dmx.getStats();
+    expect(tests[t].name, "strip A", a.getPixelColor(PIXELS - 1), tests[t].a);
+    expect(tests[t].name, "strip B", b.getPixelColor(PIXELS - 1), tests[t].b);
+    expect(tests[t].name, "data packets", s.data, tests[t].data);
+    expect(tests[t].name, "sequence drops", s.sequence, tests[t].sequence);
+    expect(tests[t].name, "frames", s.frames, tests[t].frames);
+  }
+
+  printf("%s\n", failures ? "FAILED" : "all mappings filtered as expected");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+/*-------------------------------------------------------------------------
+  dotstarcheck: checks the frames NeoPixelDotStar sends, using the mock
+  SPI library in this directory.  Strips of several lengths and color
+  orders (RGBW and RGBWW too) are drawn through the normal
+  Adafruit_NeoPixel calls and shown; the captured bytes must hold a
+  32-bit zero start frame, one 0xE0+brightness / blue / green / red
+  word per LED and an end frame of 4 + n/16 zero bytes, inside a
+  single mode 0 transaction.
+
+  In 16-bit mode, every gray level 0-65535 (and random colors) at
+  several global brightness settings is decoded back from the level
+  and PWM values sent, and checked against a floating-point reference:
+  output must never decrease as the input rises, and must be within
+  half a step of the level used.  Prints the worst error found and
+  the time taken to build frames of the largest size.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o dotstarcheck \
+        extras/linux/dotstarcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelDotStar.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelDotStar.h"
+
+#include <math.h>
+#include <stdio.h>
+
+static uint32_t color(uint16_t i)
+{
+  return ((uint32_t)(uint8_t)(i * 3) << 16) | ((uint32_t)(uint8_t)(i * 5) << 8) | (uint8_t)(i * 7);
+}
+
+// Show 'n' pixels with the strip in format 'f'; returns errors found
+static uint32_t check(uint16_t n, const neoPixelFormat &f, uint8_t global)
+{
+  Adafruit_NeoPixel strip(n, -1, f);
+  NeoPixelDotStar dots(strip);
+  uint32_t errors = 0;
+
+  dots.setGlobalBrightness(global);
+  strip.begin();
+  for (uint16_t i = 0; i < n; i++)
+    strip.setPixelColor(i, color(i));
+  SPI.clearCapture();
+  strip.show();
+
+  const uint8_t *d = SPI.captured();
+  size_t len = SPI.capturedLength(), expect = 4 + n * 4 + 4 + (n + 15) / 16;
+  if (!SPI.begun || SPI.open || (SPI.settings.mode != SPI_MODE0) ||
+      (SPI.settings.bitOrder != MSBFIRST) || (SPI.settings.hz != NEO_DOTSTAR_HZ))
+    errors++;
+  if (len != expect)
+    return errors + 1;
+  for (size_t i = 0; i < 4; i++)
+    if (d[i])
+      errors++;
+  for (uint16_t i = 0; i < n; i++)
+  {
+    const uint8_t *p = &d[4 + i * 4];
+    uint32_t c = color(i);
+    if ((p[0] != (0xE0 | ((global > 31) ? 31 : global))) || (p[1] != (uint8_t)c) ||
+        (p[2] != (uint8_t)(c >> 8)) || (p[3] != (uint8_t)(c >> 16)))
+      errors++;
+  }
+  for (size_t i = 4 + n * 4; i < len; i++)
+    if (d[i])
+      errors++;
+  return errors;
+}
+
+// Light output of one LED word channel, as a fraction of full scale
+static double decode(uint8_t head, uint8_t pwm, uint8_t global)
+{
+  return (double)(head & 0x1F) * pwm / (global * 255.0);
+}
+
+// 16-bit gray ramp and random colors at 'global'; returns errors found
+static uint32_t check16(uint8_t global, double &worst)
+{
+  Adafruit_NeoPixel strip(1024, -1, NEO_BGR);
+  NeoPixelDotStar dots(strip);
+  uint32_t errors = 0;
+  double last = -1, step = 1.0 / (global * 255.0);
+
+  dots.setGlobalBrightness(global);
+  strip.begin();
+  if (!dots.enable16())
+    return 1;
+  for (uint32_t v0 = 0; v0 < 65536; v0 += 1024)
+  {
+    for (uint16_t i = 0; i < 1024; i++)
+      dots.setPixelColor16(i, v0 + i, v0 + i, v0 + i);
+    SPI.clearCapture();
+    strip.show();
+    const uint8_t *d = SPI.captured() + 4;
+    for (uint16_t i = 0; i < 1024; i++, d += 4)
+    {
+      double out = decode(d[0], d[1], global), ref = (v0 + i) / 65535.0,
+             err = fabs(out - ref);
+      if ((d[1] != d[2]) || (d[2] != d[3]) || (out < last) ||
+          (err > ((d[0] & 0x1F) * 0.5 + 0.01) * step))
+        errors++;
+      if ((d[0] & 0x1F) && ((err / ((d[0] & 0x1F) * step)) > worst))
+        worst = err / ((d[0] & 0x1F) * step);
+      last = out;
+    }
+  }
+
+  // Random colors: channels share a level, each within half a step
+  srand(1);
+  uint16_t c[1024][3];
+  for (uint16_t i = 0; i < 1024; i++)
+  {
+    c[i][0] = rand();
+    c[i][1] = rand() >> 4;
+    c[i][2] = rand() >> 8;
+    dots.setPixelColor16(i, c[i][0], c[i][1], c[i][2]);
+  }
+  SPI.clearCapture();
+  strip.show();
+  const uint8_t *d = SPI.captured() + 4;
+  for (uint16_t i = 0; i < 1024; i++, d += 4)
+  {
+    for (uint8_t k = 0; k < 3; k++)
+    { // BGR on the wire
+      double err = fabs(decode(d[0], d[3 - k], global) - c[i][k] / 65535.0);
+      if (err > ((d[0] & 0x1F) * 0.5 + 0.01) * step)
+        errors++;
+    }
+  }
+  return errors;
+}
+
+// HD108: 16 zero start bytes, then per LED a 2-byte header (1, three
+// 5-bit gains) and three 16-bit big-endian channels in RGB order.
+// Checks a NEO_16BIT strip (with brightness) and a widened 8-bit one.
+static uint32_t checkHD108(uint16_t n, const neoPixelFormat &f, uint8_t brightness)
+{
+  Adafruit_NeoPixel strip(n, -1, f);
+  NeoPixelDotStar dots(strip, SPI, NEO_DOTSTAR_HZ, NEO_RGB);
+  uint32_t errors = 0;
+  uint16_t c[3];
+
+  dots.setChip(NEO_DOTSTAR_HD108);
+  dots.setGains(31, 20, 7);
+  strip.begin();
+  if (brightness) // 0 = leave at full brightness
+    strip.setBrightness(brightness);
+  for (uint16_t i = 0; i < n; i++)
+  {
+    if (strip.is16Bit())
+      strip.setPixelColor16(i, i * 61, i * 999, 65535 - i);
+    else
+      strip.setPixelColor(i, i, i * 3, 255 - i);
+  }
+  SPI.clearCapture();
+  strip.show();
+  if (SPI.capturedLength() != (16u + n * 8 + 4 + (n + 15) / 16))
+    return 1;
+  const uint8_t *d = SPI.captured();
+  for (uint8_t i = 0; i < 16; i++)
+    if (d[i])
+      errors++;
+  d += 16;
+  for (uint16_t i = 0; i < n; i++, d += 8)
+  {
+    if ((d[0] != (0x80 | (31 << 2) | (20 >> 3))) || (d[1] != (uint8_t)((20 << 5) | 7)))
+      errors++;
+    if (strip.is16Bit())
+    {
+      c[0] = i * 61;
+      c[1] = i * 999;
+      c[2] = 65535 - i;
+      for (uint8_t k = 0; k < 3; k++)
+        if (brightness)
+          c[k] = ((uint32_t)c[k] * (brightness + 1)) >> 8;
+    }
+    else
+    { // 8-bit strip stores scaled bytes; widened by x257
+      uint8_t r = (uint8_t)i, g = (uint8_t)(i * 3), b = (uint8_t)(255 - i);
+      if (brightness)
+      {
+        r = (r * (brightness + 1)) >> 8;
+        g = (g * (brightness + 1)) >> 8;
+        b = (b * (brightness + 1)) >> 8;
+      }
+      c[0] = r * 257;
+      c[1] = g * 257;
+      c[2] = b * 257;
+    }
+    for (uint8_t k = 0; k < 3; k++)
+      if (((d[2 + k * 2] << 8) | d[3 + k * 2]) != c[k])
+        errors++;
+  }
+  return errors;
+}
+
+int main(void)
+{
+  static const struct
+  {
+    neoPixelFormat format;
+    const char *name;
+  } types[] = {{NEO_FORMAT_RGB, "RGB"},   {NEO_FORMAT_GRB, "GRB"},     {NEO_FORMAT_BGR, "BGR"},
+               {NEO_FORMAT_GRBW, "GRBW"}, {NEO_FORMAT_GRBWW, "GRBWW"}, {NEO_FORMAT_RGBWW, "RGBWW"}};
+  static const uint16_t lengths[] = {1, 15, 16, 17, 144, 1000};
+  uint32_t failed = 0;
+
+  for (uint8_t t = 0; t < (sizeof(types) / sizeof(types[0])); t++)
+  {
+    for (uint8_t l = 0; l < (sizeof(lengths) / sizeof(lengths[0])); l++)
+    {
+      uint32_t e = check(lengths[l], types[t].format, (l * 7) % 40);
+      if (e)
+      {
+        printf("%s x %u: %u errors\n", types[t].name, lengths[l], e);
+        failed++;
+      }
+    }
+  }
+
+  static const uint8_t levels[] = {31, 16, 5, 1};
+  for (uint8_t l = 0; l < sizeof(levels); l++)
+  {
+    double worst = 0;
+    uint32_t e = check16(levels[l], worst);
+    double finest = 65535.0 / (levels[l] * 255.0); // 16-bit LSBs
+    printf("16-bit, global %2u: finest step %.2f LSB (%.1f bits), worst error %.3f step%s\n",
+           levels[l], finest, 16 - log2(finest), worst, e ? ", FAILED" : "");
+    if (e)
+      failed++;
+  }
+
+  for (uint8_t l = 0; l < 3; l++)
+  {
+    uint32_t e = checkHD108(lengths[l + 2], neoFormat(NEO_RGB + NEO_16BIT), 0) +
+                 checkHD108(lengths[l + 2], neoFormat(NEO_RGB + NEO_16BIT), 99) +
+                 checkHD108(lengths[l + 2], NEO_FORMAT_GRB, 0) +
+                 checkHD108(lengths[l + 2], NEO_FORMAT_GRB, 99) +
+                 checkHD108(lengths[l + 2], NEO_FORMAT_GRBWW, 99);
+    if (e)
+    {
+      printf("HD108 x %u: %u errors\n", lengths[l + 2], e);
+      failed++;
+    }
+  }
+
+  Adafruit_NeoPixel strip(1000, -1, NEO_GRB);
+  NeoPixelDotStar dots(strip);
+  strip.begin();
+  strip.fillRainbow(0, 0, 0, 65);
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int i = 0; i < 1000; i++)
+  {
+    SPI.clearCapture();
+    strip.show();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  printf("1000-LED frame built in %.1f us (%.1f ms on the wire at %lu Hz)\n",
+         ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e3 / 1000,
+         SPI.capturedLength() * 8 * 1e3 / NEO_DOTSTAR_HZ, (unsigned long)NEO_DOTSTAR_HZ);
+  dots.enable16();
+  for (uint16_t i = 0; i < 1000; i++)
+    dots.setPixelColor16(i, i * 65, i * 33, i * 7);
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int i = 0; i < 1000; i++)
+  {
+    SPI.clearCapture();
+    strip.show();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  printf("1000-LED 16-bit frame built in %.1f us\n",
+         ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e3 / 1000);
+  printf("%s\n", failed ? "FAILED" : "all frames correct");
+  return failed ? 1 : 0;
+}
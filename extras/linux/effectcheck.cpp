@@ -0,0 +1,244 @@
+/*-------------------------------------------------------------------------
+  effectcheck: steps the NeoPixelEffect engine through simulated time
+  and checks the frames it shows.  micros() is a variable here (the
+  Arduino.h shim built with NEO_LINUX_SIMTIME), so every run is exact
+  and repeatable: frames must appear on their schedule when update()
+  is called often, stay on the schedule when calls come late, resync
+  (counting an overrun) when a whole frame is missed, wait out the
+  strip's latch time via canShow(), and survive micros() wrapping.
+  Each ported strandtest effect's frames are checked against the same
+  drawing done directly, along with its frame count and loop mode.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -DNEO_LINUX_SIMTIME -Iextras/linux -I. \
+        -o effectcheck extras/linux/effectcheck.cpp \
+        extras/linux/NeoPixelLinux.cpp Adafruit_NeoPixel.cpp \
+        NeoPixelEffect.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelEffect.h"
+
+#include <stdio.h>
+
+#ifndef NEO_LINUX_SIMTIME
+#error "Build with -DNEO_LINUX_SIMTIME (see the build line above)"
+#endif
+
+uint32_t neoSimMicros;
+
+#define PIXELS 12
+#define MAX_FRAMES 1024
+
+// Records the time and contents of every frame shown
+class FrameLog : public NeoPixelOutput
+{
+
+  public:
+    uint16_t count;
+    uint32_t when[MAX_FRAMES];
+    uint8_t frame[MAX_FRAMES][PIXELS * 4];
+    void write(const uint8_t *pixels, uint16_t numBytes)
+    {
+      if (count < MAX_FRAMES)
+      {
+        when[count] = micros();
+        memcpy(frame[count], pixels, numBytes);
+      }
+      count++;
+    }
+};
+
+static FrameLog out;
+static uint32_t failures;
+
+static void fail(const char *test, const char *what, uint32_t a, uint32_t b)
+{
+  printf("%s: %s (%u, expected %u)\n", test, what, a, b);
+  failures++;
+}
+
+// Call update() every 'tick' microseconds from 'start' for 'span'
+static void run(NeoPixelEffect &e, uint32_t start, uint32_t span, uint32_t tick)
+{
+  for (uint32_t t = 0; t <= span; t += tick)
+  {
+    neoSimMicros = start + t;
+    e.update();
+  }
+}
+
+// Frame 'f' of the log must match 'ref''s (RGB-type) buffer
+static void expectFrame(const char *test, uint16_t f, Adafruit_NeoPixel &ref)
+{
+  if ((f >= out.count) || memcmp(out.frame[f], ref.getPixels(), ref.numPixels() * 3))
+    fail(test, "frame contents differ at frame", f, f);
+}
+
+static void checkSchedule(void)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, NEO_GRB);
+  strip.setOutput(&out);
+
+  // Called every 100 us: one frame per 1000 us interval, on the grid
+  {
+    NeoPixelColorWipe wipe(strip, 0x123456, 1000);
+    out.count = 0;
+    run(wipe, 5000, 30000, 100);
+    if (out.count != PIXELS)
+      fail("schedule", "frames shown", out.count, PIXELS);
+    for (uint16_t f = 0; (f < out.count) && (f < PIXELS); f++)
+      if (out.when[f] != 5000 + f * 1000u)
+        fail("schedule", "frame time", out.when[f], 5000 + f * 1000u);
+    if (!wipe.isDone() || wipe.getOverruns())
+      fail("schedule", "done / overruns", wipe.isDone(), 1);
+  }
+
+  // Late calls keep the schedule (1500 is due at 1000, so the next is
+  // still 2000); a whole missed frame resyncs (4200: next is 5200)
+  {
+    NeoPixelColorWipe wipe(strip, 0x123456, 1000);
+    static const uint32_t calls[] = {0, 1500, 1900, 2000, 4200, 5100, 5200, 6300, 7100};
+    static const bool shown[] = {1, 1, 0, 1, 1, 0, 1, 1, 0};
+    out.count = 0;
+    for (uint8_t i = 0; i < sizeof(calls) / sizeof(calls[0]); i++)
+    {
+      neoSimMicros = 100000 + calls[i];
+      if (wipe.update() != shown[i])
+        fail("late calls", "frame shown at call", calls[i], shown[i]);
+    }
+    if (wipe.getOverruns() != 1)
+      fail("late calls", "overruns", wipe.getOverruns(), 1);
+  }
+
+  // Interval shorter than the latch: canShow() holds frames back
+  {
+    NeoPixelColorWipe wipe(strip, 0x123456, 20);
+    out.count = 0;
+    run(wipe, 200000, 200, 10);
+    for (uint16_t f = 1; f < out.count; f++)
+      if ((out.when[f] - out.when[f - 1]) < 50)
+        fail("latch", "gap between frames", out.when[f] - out.when[f - 1], 50);
+    if (out.count != 5) // 0, 50, 100, 150, 200
+      fail("latch", "frames shown", out.count, 5);
+  }
+
+  // micros() wrapping through zero mid-animation
+  {
+    NeoPixelColorWipe wipe(strip, 0x123456, 1000);
+    out.count = 0;
+    run(wipe, 0xFFFFFFFFu - 4321, 20000, 100);
+    if (out.count != PIXELS)
+      fail("wrap", "frames shown", out.count, PIXELS);
+    for (uint16_t f = 0; (f < out.count) && (f < PIXELS); f++)
+      if (out.when[f] != (uint32_t)(0xFFFFFFFFu - 4321 + f * 1000u))
+        fail("wrap", "frame time", out.when[f], 0xFFFFFFFFu - 4321 + f * 1000u);
+  }
+}
+
+static void checkEffects(void)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, NEO_GRB), ref(PIXELS, -1, NEO_GRB);
+  strip.setOutput(&out);
+
+  { // colorWipe: frame k has pixels 0-k lit
+    NeoPixelColorWipe wipe(strip, 0xFF8000, 1000);
+    out.count = 0;
+    run(wipe, 0, 100000, 500);
+    ref.clear();
+    for (uint16_t k = 0; k < PIXELS; k++)
+    {
+      ref.setPixelColor(k, 0xFF8000);
+      expectFrame("colorWipe", k, ref);
+    }
+    if (out.count != PIXELS)
+      fail("colorWipe", "frames", out.count, PIXELS);
+  }
+
+  { // rainbow: frame k is the wheel turned by k/256, one turn in all
+    NeoPixelRainbow rainbow(strip, 1000);
+    out.count = 0;
+    run(rainbow, 0, 300000, 1000);
+    for (uint16_t k = 0; k < 256; k += 17)
+    {
+      ref.fillRainbow(0, 0, k << 8, 256);
+      expectFrame("rainbow", k, ref);
+    }
+    if (out.count != 256)
+      fail("rainbow", "frames", out.count, 256);
+  }
+
+  { // rainbowCycle, looping: frame 256 starts the wheel over
+    NeoPixelRainbow cycle(strip, 1000, true);
+    cycle.setLoop(true);
+    out.count = 0;
+    run(cycle, 0, 300000, 1000);
+    ref.fillRainbow(0, 0, 0, 65536 / PIXELS);
+    expectFrame("rainbowCycle", 0, ref);
+    expectFrame("rainbowCycle", 256, ref);
+    if (cycle.isDone() || (out.count != 301))
+      fail("rainbowCycle", "frames while looping", out.count, 301);
+  }
+
+  { // theaterChase: every third pixel from offset k % 3
+    NeoPixelTheaterChase chase(strip, 0x00FF00, 1000, 2);
+    out.count = 0;
+    run(chase, 0, 100000, 250);
+    for (uint16_t k = 0; k < 6; k++)
+    {
+      ref.clear();
+      for (uint16_t i = k % 3; i < PIXELS; i += 3)
+        ref.setPixelColor(i, 0x00FF00);
+      expectFrame("theaterChase", k, ref);
+    }
+    if (out.count != 6)
+      fail("theaterChase", "frames", out.count, 6);
+  }
+
+  { // pulseWhite on GRBW: W rises along the gamma curve and falls back
+    Adafruit_NeoPixel w(PIXELS, -1, NEO_GRBW);
+    w.setOutput(&out);
+    NeoPixelPulseWhite pulse(w, 1000);
+    out.count = 0;
+    run(pulse, 0, 600000, 1000);
+    if (out.count != 512)
+      fail("pulseWhite", "frames", out.count, 512);
+    static const uint16_t steps[] = {0, 100, 255, 256, 400, 511};
+    for (uint8_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+    {
+      uint16_t s = steps[i];
+      uint8_t v = Adafruit_NeoPixel::gamma8((s < 256) ? s : (511 - s));
+      for (uint16_t p = 0; p < PIXELS; p++)
+      {
+        const uint8_t *px = &out.frame[s][p * 4];
+        if ((px[3] != v) || px[0] || px[1] || px[2]) // GRBW: W is byte 3
+          fail("pulseWhite", "white at step", px[3], v);
+      }
+    }
+  }
+}
+
+int main(void)
+{
+  checkSchedule();
+  checkEffects();
+  printf("%s\n", failures ? "FAILED" : "all frames on time and correct");
+  return failures ? 1 : 0;
+}
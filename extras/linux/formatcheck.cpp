@@ -0,0 +1,351 @@
+/*-------------------------------------------------------------------------
+  formatcheck: checks the helper classes on strips other than plain
+  RGB and RGBW -- five-channel (RGBWW, GRBWW) and NEO_16BIT ones.
+  NeoPixelMatrix, NeoPixelSegments, NeoPixelDDP and NeoPixelAdalight
+  must place R, G, B (and W, W2 where they carry them) at the strip's
+  offsets, clearing white channels that RGB-only input doesn't set,
+  and NeoPixelCompositor must flatten layers of every format (refusing
+  a layer made for a different strip).  NeoPixelMatrix must also draw
+  on 16-bit strips (drawBitmap() giving the same colors as on an 8-bit
+  strip, opaque and blended), while NeoPixelSegments, NeoPixelDDP,
+  NeoPixelDMX, NeoPixelAdalight, NeoPixelSequence, NeoPixelCompositor
+  and NeoPixelTween must refuse the strips they can't handle rather
+  than write past or misread their pixels.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o formatcheck \
+        extras/linux/formatcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelMatrix.cpp NeoPixelSegments.cpp \
+        NeoPixelDDP.cpp NeoPixelDMX.cpp NeoPixelAdalight.cpp \
+        NeoPixelSequence.cpp NeoPixelCompositor.cpp NeoPixelTween.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelMatrix.h"
+#include "NeoPixelSegments.h"
+#include "NeoPixelDDP.h"
+#include "NeoPixelDMX.h"
+#include "NeoPixelAdalight.h"
+#include "NeoPixelSequence.h"
+#include "NeoPixelCompositor.h"
+#include "NeoPixelTween.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#define SIZE 8 // Matrix is SIZE x SIZE
+#define PIXELS (SIZE * SIZE)
+
+static uint32_t failures;
+
+static void check(const char *format, const char *what, bool ok)
+{
+  printf("%-7s %-44s %s\n", format, what, ok ? "ok" : "FAILED");
+  if (!ok)
+    failures++;
+}
+
+static uint32_t pattern(uint16_t i)
+{
+  return ((uint32_t)(uint8_t)(i * 7 + 1) << 16) | ((uint32_t)(uint8_t)(i * 5 + 2) << 8) |
+         (uint8_t)(i * 3 + 3);
+}
+
+// Every pixel of 'strip' is pattern(i) and its white channels are 'w'
+static bool holds(Adafruit_NeoPixel &strip, uint8_t w, const neoPixelFormat &f)
+{
+  const uint8_t *p = strip.getPixels();
+  for (uint16_t i = 0; i < strip.numPixels(); i++, p += f.channels)
+  {
+    if ((strip.getPixelColor(i) & 0xFFFFFF) != pattern(i))
+      return false;
+    if (((f.channels >= 4) && (p[f.w] != w)) || ((f.channels == 5) && (p[f.w2] != w)))
+      return false;
+  }
+  return true;
+}
+
+static void matrix(const char *name, const neoPixelFormat &f)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f), ref(PIXELS, -1, f);
+  NeoPixelMatrix m(strip, SIZE, SIZE), r(ref, SIZE, SIZE);
+  uint8_t rgb[PIXELS * 3];
+  neoBitmap bmp = {rgb, NULL, SIZE, SIZE, NEO_BITMAP_RGB888};
+  uint16_t bytes = PIXELS * neoFormatBytes(f);
+
+  for (uint16_t i = 0; i < PIXELS; i++)
+  {
+    rgb[i * 3] = pattern(i) >> 16;
+    rgb[i * 3 + 1] = pattern(i) >> 8;
+    rgb[i * 3 + 2] = pattern(i);
+    r.drawPixel(i % SIZE, i / SIZE, pattern(i));
+  }
+  memset(strip.getPixels(), 0xFF, bytes);
+  m.drawBitmap(0, 0, bmp);
+  check(name, "Matrix drawBitmap() == drawPixel()",
+        !memcmp(strip.getPixels(), ref.getPixels(), bytes));
+
+  // Half transparent over white: R,G,B blend, W and W2 fade
+  bool ok = true;
+  memset(strip.getPixels(), 0xFF, bytes);
+  m.drawBitmap(0, 0, bmp, 127);
+  const uint8_t *p = strip.getPixels();
+  for (uint16_t i = 0; i < PIXELS; i++, p += f.channels)
+  {
+    if ((p[f.r] != ((rgb[i * 3] * 128 + 255 * 128) >> 8)) ||
+        (p[f.b] != ((rgb[i * 3 + 2] * 128 + 255 * 128) >> 8)))
+      ok = false;
+    if (((f.channels >= 4) && (p[f.w] != 127)) || ((f.channels == 5) && (p[f.w2] != 127)))
+      ok = false;
+  }
+  check(name, "Matrix drawBitmap() blended", ok);
+}
+
+#ifdef NEO_16BIT
+// On a 16-bit strip, drawBitmap() must give an 8-bit strip's colors
+static void matrix16(void)
+{
+  Adafruit_NeoPixel wide(PIXELS, -1, NEO_RGB + NEO_16BIT), narrow(PIXELS, -1, NEO_RGB);
+  NeoPixelMatrix mw(wide, SIZE, SIZE), mn(narrow, SIZE, SIZE);
+  uint8_t rgb[PIXELS * 3];
+  neoBitmap bmp = {rgb, NULL, SIZE, SIZE, NEO_BITMAP_RGB888};
+
+  for (uint16_t i = 0; i < PIXELS * 3; i++)
+    rgb[i] = i * 11;
+  for (uint8_t alpha = 127; alpha; alpha = (alpha == 127) ? 255 : 0)
+  {
+    bool ok = true;
+    wide.fill(0x406080);
+    narrow.fill(0x406080);
+    mw.drawBitmap(0, 0, bmp, alpha);
+    mn.drawBitmap(0, 0, bmp, alpha);
+    for (uint16_t i = 0; i < PIXELS; i++)
+      if (wide.getPixelColor(i) != narrow.getPixelColor(i))
+        ok = false;
+    check("16-bit", (alpha == 255) ? "Matrix drawBitmap() as 8-bit" : "Matrix blended as 8-bit",
+          ok);
+  }
+  // A matrix bigger than the strip: nothing past the end of the buffer
+  Adafruit_NeoPixel half(PIXELS / 2, -1, NEO_RGB + NEO_16BIT);
+  NeoPixelMatrix mh(half, SIZE, SIZE);
+  mh.drawBitmap(0, 0, bmp);
+  check("16-bit", "Matrix drawBitmap() clipped to strip", half.getPixelColor(PIXELS / 2 - 1) != 0);
+}
+#endif
+
+// A 'canvas' format canvas gathered onto 'strip' (forward and reversed halves)
+static void segments(const char *name, const neoPixelFormat &canvas, const neoPixelFormat &f)
+{
+  NeoPixelSegments seg(PIXELS);
+  Adafruit_NeoPixel strip(PIXELS, -1, f);
+  char what[48];
+
+  seg.updateFormat(canvas);
+  seg.addSegment(0, PIXELS / 2, strip);
+  seg.addSegment(PIXELS / 2, PIXELS / 2, strip, PIXELS / 2, true);
+  for (uint16_t i = 0; i < PIXELS; i++)
+  {
+    uint16_t j = (i < PIXELS / 2) ? i : (PIXELS * 3 / 2 - 1 - i);
+    seg.setPixelColor(i, pattern(j) | 0x55000000); // W, if the canvas has it
+  }
+  if (canvas.channels == 5)
+    for (uint16_t i = 0; i < PIXELS; i++)
+      seg.getPixels()[i * 5 + canvas.w2] = 0x55;
+  memset(strip.getPixels(), 0xFF, PIXELS * f.channels);
+  seg.gather();
+  snprintf(what, sizeof(what), "Segments gather from %u-channel canvas", canvas.channels);
+  // White the canvas doesn't have is cleared
+  bool ok = holds(strip, (canvas.channels >= 4) ? 0x55 : 0, f);
+  if ((f.channels == 5) && (canvas.channels == 4))
+  {
+    const uint8_t *p = strip.getPixels();
+    ok = true;
+    for (uint16_t i = 0; i < PIXELS; i++, p += 5)
+      if (((strip.getPixelColor(i) & 0xFFFFFF) != pattern(i)) || (p[f.w] != 0x55) || p[f.w2])
+        ok = false;
+  }
+  check(name, what, ok);
+}
+
+// The whole strip in one DDP packet, payload R,G,B(,W(,W2))
+static void ddp(const char *name, const neoPixelFormat &f, uint8_t brightness)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f);
+  NeoPixelDDP d(1);
+  uint8_t pkt[10 + PIXELS * 5], *q = &pkt[10];
+  uint16_t n = PIXELS * f.channels;
+
+  d.addStrip(strip);
+  if (brightness)
+    strip.setBrightness(brightness);
+  memcpy(pkt, "\x41\x00\x0B\x01\x00\x00\x00\x00", 8);
+  pkt[8] = n >> 8;
+  pkt[9] = n;
+  for (uint16_t i = 0; i < PIXELS; i++)
+  {
+    *q++ = pattern(i) >> 16;
+    *q++ = pattern(i) >> 8;
+    *q++ = pattern(i);
+    for (uint8_t k = 3; k < f.channels; k++)
+      *q++ = 0x60 + k;
+  }
+  bool ok = d.handlePacket(pkt, 10 + n);
+  const uint8_t *p = strip.getPixels();
+  for (uint16_t i = 0; ok && (i < PIXELS); i++, p += f.channels)
+  {
+    const uint8_t *in = &pkt[10 + i * f.channels];
+    for (uint8_t k = 0; k < f.channels; k++)
+    {
+      uint8_t off = (k == 0) ? f.r : (k == 1) ? f.g : (k == 2) ? f.b : (k == 3) ? f.w : f.w2,
+              want = brightness ? ((in[k] * (brightness + 1)) >> 8) : in[k];
+      if (p[off] != want)
+        ok = false;
+    }
+  }
+  check(name, brightness ? "DDP packet, brightness" : "DDP packet", ok);
+}
+
+// An Adalight frame through a pipe
+static void adalight(const char *name, const neoPixelFormat &f)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f);
+  NeoPixelAdalight ada(strip);
+  uint8_t frame[6 + PIXELS * 3] = {'A', 'd', 'a', 0, PIXELS - 1, (PIXELS - 1) ^ 0x55};
+  int fd[2];
+
+  if (!ada.begin() || pipe(fd))
+  {
+    check(name, "Adalight frame", false);
+    return;
+  }
+  for (uint16_t i = 0; i < PIXELS; i++)
+  {
+    frame[6 + i * 3] = pattern(i) >> 16;
+    frame[7 + i * 3] = pattern(i) >> 8;
+    frame[8 + i * 3] = pattern(i);
+  }
+  NeoPixelLinuxSerial s(fd[0]);
+  bool ok = write(fd[1], frame, sizeof(frame)) == (ssize_t)sizeof(frame);
+  ada.poll(s, 0);
+  ok = ok && ada.poll(s, 1000000); // Line idle: shown
+  check(name, "Adalight frame", ok && holds(strip, 0, f));
+  close(fd[0]);
+  close(fd[1]);
+}
+
+// An opaque base layer under a clear half-transparent one: flatten()
+// must leave the base layer's bytes, W and W2 included
+static void compositor(const char *name, const neoPixelFormat &f)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f), other(PIXELS, -1, (f.channels == 3) ? NEO_FORMAT_GRBW
+                                                                               : NEO_FORMAT_GRB);
+  NeoPixelLayer base(strip), top(strip, NEO_BLEND_MAX, 127), wrong(other);
+  NeoPixelCompositor comp(strip);
+  uint16_t bytes = PIXELS * f.channels;
+
+  check(name, "Compositor layer for another strip refused", !comp.addLayer(wrong));
+  comp.addLayer(base);
+  comp.addLayer(top);
+  for (uint16_t i = 0; i < PIXELS; i++)
+    base.setPixelColor(i, pattern(i) | 0x55000000);
+  if (f.channels == 5)
+    for (uint16_t i = 0; i < PIXELS; i++)
+      base.getPixels()[i * 5 + f.w2] = 0x55;
+  bool ok = comp.flatten() && holds(strip, (f.channels >= 4) ? 0x55 : 0, f);
+  check(name, "Compositor flatten()", ok && !memcmp(strip.getPixels(), base.getPixels(), bytes));
+  // Strip resized under the layers: refused, strip left as it was
+  strip.updateLength(PIXELS / 2);
+  strip.fill(0x123456);
+  base.setPixelColor(0, 0);
+  check(name, "Compositor resized strip left alone",
+        !comp.flatten() && (strip.getPixelColor(0) == 0x123456));
+}
+
+// Those that can't handle 'f' must say so
+static void refusals(const char *name, const neoPixelFormat &f, bool dmxOk, bool wide)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f);
+  NeoPixelDMX dmx(1);
+  NeoPixelSequence seq(strip);
+  // A one-frame sequence header for this strip's bytes per pixel
+  uint8_t h[NEOSEQ_HEADER_SIZE] = {'N', 'P', 'S', 'Q', NEOSEQ_VERSION, neoFormatBytes(f),
+                                   PIXELS, 0, 1};
+
+  check(name, dmxOk ? "DMX universe mapped" : "DMX universe refused",
+        dmx.addUniverse(1, strip) == dmxOk);
+  check(name, (h[5] <= 4) ? "Sequence header accepted" : "Sequence header refused",
+        seq.begin(h, sizeof(h)) == (h[5] <= 4));
+  if (wide)
+  {
+    NeoPixelSegments seg(PIXELS);
+    NeoPixelDDP d(1);
+    NeoPixelAdalight ada(strip);
+    check(name, "Segments strip refused", !seg.addSegment(0, PIXELS, strip));
+    check(name, "DDP strip refused", !d.addStrip(strip));
+    check(name, "Adalight refused", !ada.begin());
+    NeoPixelLayer layer(strip);
+    NeoPixelCompositor comp(strip);
+    strip.fill(0x123456);
+    check(name, "Compositor layer refused", !comp.addLayer(layer));
+    check(name, "Compositor strip left alone",
+          !comp.flatten() && (strip.getPixelColor(0) == 0x123456));
+    Adafruit_NeoPixel canvas(PIXELS, -1, f), narrow(PIXELS * 2, -1, NEO_FORMAT_RGB);
+    NeoPixelTween tween(strip), narrowTween(narrow);
+    check(name, "Tween from strip refused", !tween.begin(canvas, 1000));
+    check(name, "Tween between canvases refused", !tween.begin(canvas, canvas, 1000));
+    check(name, "Tween to 16-bit canvas refused", !narrowTween.begin(canvas, 1000));
+  }
+}
+
+int main(void)
+{
+  static const struct
+  {
+    const char *name;
+    neoPixelFormat f;
+  } formats[] = {{"GRB", NEO_FORMAT_GRB},
+                 {"RGBW", NEO_FORMAT_RGBW},
+                 {"GRBW", NEO_FORMAT_GRBW},
+                 {"RGBWW", NEO_FORMAT_RGBWW},
+                 {"GRBWW", NEO_FORMAT_GRBWW}};
+
+  for (uint8_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+  {
+    const char *name = formats[i].name;
+    const neoPixelFormat &f = formats[i].f;
+    matrix(name, f);
+    segments(name, NEO_FORMAT_GRB, f);
+    segments(name, NEO_FORMAT_GRBW, f);
+    if (f.channels == 5)
+      segments(name, NEO_FORMAT_RGBWW, f);
+    ddp(name, f, 0);
+    ddp(name, f, 100);
+    adalight(name, f);
+    compositor(name, f);
+    refusals(name, f, f.channels < 5, false);
+  }
+#ifdef NEO_16BIT
+  matrix16();
+  refusals("16-bit", neoFormat(NEO_RGB + NEO_16BIT), false, true);
+#endif
+
+  printf("%s\n", failures ? "FAILED" : "all formats handled");
+  return failures ? 1 : 0;
+}
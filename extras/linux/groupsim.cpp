@@ -0,0 +1,248 @@
+/*-------------------------------------------------------------------------
+  groupsim: simulates a NeoPixelGroup driving many virtual strips, for
+  sizing installations.  Time is simulated (the Arduino.h shim built
+  with NEO_LINUX_SIMTIME): each strip's output takes as long as its
+  data would at 800 KHz (10 us per byte) and first waits out the rest
+  of that strip's 50 us latch, as show() does on a real pin.  The loop
+  calls update() every 20 us, redraws each strip every so many frames
+  and, after a simulated run, prints the group's per-strip frame, skip
+  and defer counts and show() times, plus the latch time spent waiting.
+
+  With no arguments, a sample installation (2 strips redrawn every
+  frame at high priority, 4 every other frame, 6 every fourth frame;
+  120 RGB pixels each) runs at 30 fps, 60 fps and unpaced, and the
+  results are checked: frames are issued on schedule, every redraw is
+  shown when the budget allows, the highest priority strips are never
+  deferred, and every strip is accounted for in every frame.  With
+  arguments, a uniform installation of 'strips' strips of 'pixels'
+  pixels, all redrawn every frame, runs at 'fps' (0 = unpaced).
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -DNEO_LINUX_SIMTIME -Iextras/linux -I. \
+        -o groupsim extras/linux/groupsim.cpp \
+        extras/linux/NeoPixelLinux.cpp Adafruit_NeoPixel.cpp \
+        NeoPixelGroup.cpp
+
+  Usage: groupsim [strips pixels fps]
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelGroup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef NEO_LINUX_SIMTIME
+#error "Build with -DNEO_LINUX_SIMTIME (see the build line above)"
+#endif
+
+uint32_t neoSimMicros;
+
+#define MAX_STRIPS 64
+#define SECONDS 10 // Simulated run length
+#define TICK 20    // Microseconds between update() calls
+#define LATCH 50   // Microseconds
+
+// A strip's data line: takes the strip's data time, after its latch
+static uint32_t latchWait; // Total microseconds spent waiting to latch
+
+class VirtualWire : public NeoPixelOutput
+{
+
+  public:
+    VirtualWire() : shown(false) {}
+    void write(const uint8_t *pixels, uint16_t numBytes)
+    {
+      (void)pixels;
+      if (shown && ((neoSimMicros - lastEnd) < LATCH))
+      {
+        latchWait += LATCH - (neoSimMicros - lastEnd);
+        neoSimMicros = lastEnd + LATCH;
+      }
+      neoSimMicros += numBytes * 10;
+      lastEnd = neoSimMicros;
+      shown = true;
+    }
+
+  private:
+    bool shown;
+    uint32_t lastEnd;
+};
+
+typedef struct
+{
+  uint16_t pixels;
+  uint8_t priority, every; // Redrawn every 'every' frames
+} stripSpec;
+
+static Adafruit_NeoPixel *strips[MAX_STRIPS];
+static VirtualWire wires[MAX_STRIPS];
+static uint32_t redraws[MAX_STRIPS];
+static uint32_t failures;
+
+static void fail(const char *test, const char *what, uint32_t a, uint32_t b)
+{
+  printf("  %s: %s (%u, expected %u)\n", test, what, a, b);
+  failures++;
+}
+
+// Index in 'strips' of the group's i-th strip
+static uint8_t which(NeoPixelGroup &group, uint8_t i)
+{
+  Adafruit_NeoPixel *s = group.getStrip(i);
+  uint8_t k = 0;
+  while (strips[k] != s)
+    k++;
+  return k;
+}
+
+// Run 'n' strips of 'spec' at 'fps' for SECONDS; prints the results
+// and leaves them in 'group'
+static void simulate(NeoPixelGroup &group, const stripSpec *spec, uint8_t n, uint16_t fps)
+{
+  uint32_t last = 0, pixels = 0;
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    strips[i] = new Adafruit_NeoPixel(spec[i].pixels, -1, NEO_GRB);
+    strips[i]->setOutput(&wires[i]);
+    wires[i] = VirtualWire();
+    redraws[i] = 0;
+    group.add(*strips[i], spec[i].priority);
+    pixels += spec[i].pixels;
+  }
+  neoSimMicros = 1000;
+  latchWait = 0;
+  group.setFrameRate(fps);
+
+  for (bool first = true; (neoSimMicros - 1000) < SECONDS * 1000000UL; first = false)
+  {
+    // Redraw before the first frame and after each one
+    if ((group.getFrames() != last) || first)
+    {
+      last = group.getFrames();
+      for (uint8_t i = 0; i < n; i++)
+      {
+        if (!(last % spec[i].every))
+        {
+          strips[i]->setPixelColor(0, last);
+          redraws[i]++;
+        }
+      }
+    }
+    group.update(); // Moves time on by whatever it shows
+    neoSimMicros += TICK;
+  }
+
+  printf("%u strips, %u pixels, ", n, pixels);
+  if (fps)
+    printf("%u fps", fps);
+  else
+    printf("unpaced");
+  printf(": %u frames in %u s (%.1f fps), %u overruns, %u us waiting to latch\n",
+         group.getFrames(), SECONDS, group.getFrames() / (double)SECONDS, group.getOverruns(),
+         latchWait);
+  printf("  strip  pixels  priority  every   frames  skipped  deferred  avg us  max us\n");
+  for (uint8_t i = 0; i < n; i++)
+  {
+    const neoGroupStats *s = group.getStats(i);
+    uint8_t k = which(group, i);
+    printf("  %5u  %6u  %8u  %5u  %7u  %7u  %8u  %6u  %6u\n", k, spec[k].pixels,
+           spec[k].priority, spec[k].every, s->frames, s->skipped, s->deferred,
+           s->frames ? s->totalTime / s->frames : 0, s->maxTime);
+  }
+}
+
+static void cleanup(uint8_t n)
+{
+  for (uint8_t i = 0; i < n; i++)
+    delete strips[i];
+}
+
+// The sample installation at 'fps', with its results checked
+static void sample(uint16_t fps)
+{
+  static const stripSpec spec[] = {{120, 2, 1}, {120, 2, 1}, {120, 1, 2}, {120, 1, 2},
+                                   {120, 1, 2}, {120, 1, 2}, {120, 0, 4}, {120, 0, 4},
+                                   {120, 0, 4}, {120, 0, 4}, {120, 0, 4}, {120, 0, 4}};
+  const uint8_t n = sizeof(spec) / sizeof(spec[0]);
+  NeoPixelGroup group(n);
+  char test[16];
+
+  simulate(group, spec, n, fps);
+  snprintf(test, sizeof(test), "%u fps", fps);
+  uint32_t due = fps * SECONDS;
+  if (fps && ((group.getFrames() < due) || (group.getFrames() > due + 1)))
+    fail(test, "frames issued", group.getFrames(), due);
+  if (group.getOverruns())
+    fail(test, "overruns", group.getOverruns(), 0);
+  for (uint8_t i = 0; i < n; i++)
+  {
+    const neoGroupStats *s = group.getStats(i);
+    uint8_t k = which(group, i);
+    // Each frame, each strip is issued, skipped (clean) or deferred
+    if (s->frames + s->skipped + s->deferred != group.getFrames())
+      fail(test, "frames + skipped + deferred", s->frames + s->skipped + s->deferred,
+           group.getFrames());
+    if ((spec[k].priority == 2) && s->deferred)
+      fail(test, "top priority strip deferred", s->deferred, 0);
+    // At 30 fps, strips that don't fit when all 12 are redrawn (43 ms
+    // of data) catch up the next frame, so no redraw is lost (the last
+    // may still be waiting when the run ends)
+    if ((fps == 30) && (s->frames + 1 < redraws[k]))
+      fail(test, "redraws shown", s->frames, redraws[k]);
+  }
+  cleanup(n);
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc == 4)
+  {
+    uint8_t n = atoi(argv[1]);
+    stripSpec spec[MAX_STRIPS];
+    if (!n || (n > MAX_STRIPS))
+    {
+      fprintf(stderr, "1 to %u strips\n", MAX_STRIPS);
+      return 1;
+    }
+    for (uint8_t i = 0; i < n; i++)
+    {
+      spec[i].pixels = atoi(argv[2]);
+      spec[i].priority = 0;
+      spec[i].every = 1;
+    }
+    NeoPixelGroup group(n);
+    simulate(group, spec, n, atoi(argv[3]));
+    cleanup(n);
+    return 0;
+  }
+  if (argc != 1)
+  {
+    fprintf(stderr, "Usage: %s [strips pixels fps]\n", argv[0]);
+    return 1;
+  }
+
+  sample(30);
+  sample(60);
+  sample(0);
+  printf("%s\n", failures ? "FAILED" : "all frames scheduled as expected");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+/*-------------------------------------------------------------------------
+  hsvbench: checks and times the library's rainbow drawing against the
+  examples' Wheel().  Each frame of a rainbowCycle() is drawn four ways:
+  Wheel() per pixel (as in strandtest), ColorHSV() per pixel,
+  fillRainbow(), and both of the last with gamma.  fillRainbow() must
+  leave the same buffer as setPixelColor(i, r, g, b) of ColorHSV(...)
+  (and gamma32() of it) for RGB, RGBW and RGBWW strips, with and
+  without white extraction and brightness, across assorted start hues
+  and steps.  Prints nanoseconds per pixel.
+
+  These are host figures only; AVR cycle counts need a target (or a
+  simulator such as simavr) and aren't produced here.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o hsvbench \
+        extras/linux/hsvbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  Usage: hsvbench [pixels]   (default 1000)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PIXELS_TIMED 4e6 // Pixels drawn per measurement
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// The examples' color wheel, as in strandtest
+static uint32_t Wheel(uint8_t WheelPos)
+{
+  WheelPos = 255 - WheelPos;
+  if (WheelPos < 85)
+    return Adafruit_NeoPixel::Color(255 - WheelPos * 3, 0, WheelPos * 3);
+  if (WheelPos < 170)
+  {
+    WheelPos -= 85;
+    return Adafruit_NeoPixel::Color(0, WheelPos * 3, 255 - WheelPos * 3);
+  }
+  WheelPos -= 170;
+  return Adafruit_NeoPixel::Color(WheelPos * 3, 255 - WheelPos * 3, 0);
+}
+
+// fillRainbow() must match ColorHSV() per pixel
+static uint32_t check(const neoPixelFormat &f, uint8_t white, uint8_t brightness, bool gammify)
+{
+  static const uint16_t hues[] = {0, 1, 10922, 32768, 65535},
+                        steps[] = {0, 1, 257, 4096, 65535};
+  static const uint8_t sats[] = {255, 100, 0}, vals[] = {255, 128, 1};
+  Adafruit_NeoPixel a(300, -1, f), b(300, -1, f);
+  uint16_t bytes = 300 * neoFormatBytes(f);
+  uint32_t errors = 0;
+
+  a.setWhiteExtraction(white);
+  b.setWhiteExtraction(white);
+  if (brightness)
+  {
+    a.setBrightness(brightness);
+    b.setBrightness(brightness);
+  }
+  for (uint8_t h = 0; h < sizeof(hues) / sizeof(hues[0]); h++)
+  {
+    for (uint8_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++)
+    {
+      for (uint8_t v = 0; v < sizeof(sats) / sizeof(sats[0]); v++)
+      {
+        a.fillRainbow(0, 0, hues[h], steps[s], sats[v], vals[v], gammify);
+        for (uint16_t i = 0; i < 300; i++)
+        {
+          uint32_t c = Adafruit_NeoPixel::ColorHSV(hues[h] + i * steps[s], sats[v], vals[v]);
+          if (gammify)
+            c = Adafruit_NeoPixel::gamma32(c);
+          b.setPixelColor(i, c >> 16, c >> 8, c);
+        }
+        if (memcmp(a.getPixels(), b.getPixels(), bytes))
+          errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char *argv[])
+{
+  uint16_t n = (argc > 1) ? atoi(argv[1]) : 1000;
+  uint32_t failed = 0;
+  struct timespec t0, t1;
+  volatile uint16_t step = 65536 / (n ? n : 1); // As a sketch would have it
+
+  if (n < 1)
+  {
+    fprintf(stderr, "Usage: %s [pixels]\n", argv[0]);
+    return 1;
+  }
+  int repeat = PIXELS_TIMED / n;
+
+  static const struct
+  {
+    const char *name;
+    neoPixelFormat f;
+    uint8_t white;
+  } types[] = {{"GRB", NEO_FORMAT_GRB, NEO_WHITE_OFF},
+               {"GRBW", NEO_FORMAT_GRBW, NEO_WHITE_OFF},
+               {"GRBW white", NEO_FORMAT_GRBW, NEO_WHITE_ACCURATE},
+               {"RGBWW", NEO_FORMAT_RGBWW, NEO_WHITE_OFF},
+               {"RGBWW white", NEO_FORMAT_RGBWW, NEO_WHITE_ACCURATE}};
+  for (uint8_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+  {
+    for (uint8_t v = 0; v < 4; v++)
+    {
+      uint32_t e = check(types[t].f, types[t].white, (v & 1) ? 100 : 0, v & 2);
+      if (e)
+        failed++;
+      char name[40];
+      snprintf(name, sizeof(name), "%s%s%s", types[t].name, (v & 1) ? ", brightness" : "",
+               (v & 2) ? ", gamma" : "");
+      printf("%-31s %s\n", name, e ? "MISMATCH" : "ok");
+    }
+  }
+
+  printf("\n%u pixels, ns/pixel:  Wheel()  ColorHSV()  fillRainbow()\n", n);
+  for (uint8_t g = 0; g < 2; g++)
+  {
+    Adafruit_NeoPixel strip(n, -1, NEO_GRB + NEO_KHZ800);
+    double ns[3];
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int j = 0; j < repeat; j++)
+      for (uint16_t i = 0; i < n; i++)
+      {
+        uint32_t c = Wheel(((i * 256 / n) + j) & 255);
+        strip.setPixelColor(i, g ? Adafruit_NeoPixel::gamma32(c) : c);
+      }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns[0] = elapsed(t0, t1) / repeat / n;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int j = 0; j < repeat; j++)
+      for (uint16_t i = 0; i < n; i++)
+      {
+        uint32_t c = Adafruit_NeoPixel::ColorHSV((j << 8) + i * step);
+        strip.setPixelColor(i, g ? Adafruit_NeoPixel::gamma32(c) : c);
+      }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns[1] = elapsed(t0, t1) / repeat / n;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int j = 0; j < repeat; j++)
+      strip.fillRainbow(0, 0, j << 8, step, 255, 255, g);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns[2] = elapsed(t0, t1) / repeat / n;
+    printf("rainbowCycle%-8s %7.2f  %10.2f  %13.2f\n", g ? ", gamma" : "", ns[0], ns[1],
+           ns[2]);
+  }
+
+  printf("%s\n", failed ? "FAILED" : "fillRainbow() matches ColorHSV()");
+  return failed ? 1 : 0;
+}
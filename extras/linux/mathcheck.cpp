@@ -0,0 +1,207 @@
+/*-------------------------------------------------------------------------
+  mathcheck: tests NeoPixelMath against exact reference arithmetic.
+  div255(), scale8(), qadd8(), qsub8() and lerp8() are checked for
+  every input; the packed qadd8x4(), qsub8x4() and blend() for every
+  byte pair in every lane (other lanes random), and lerp16() at its
+  end points plus random inputs.  Strips of each color order must
+  store the same bytes from setPixelColor(n, scaleColor(c), true) as
+  from setPixelColor(n, c), at every brightness.  The AVR and ARM DSP
+  versions compute the same functions, so running this with
+  -DNEO_MATH_PORTABLE on a target (or as is) should give the same
+  (empty) list of failures.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o mathcheck \
+        extras/linux/mathcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelMath.h"
+
+#include <stdio.h>
+
+typedef NeoPixelMath M;
+
+static uint32_t failures;
+
+static void report(const char *name, uint32_t errors)
+{
+  printf("%-9s %s", name, errors ? "FAILED" : "ok");
+  if (errors)
+    printf(" (%u errors)", errors);
+  printf("\n");
+  if (errors)
+    failures++;
+}
+
+// x / d rounded to nearest (no ties: d is odd)
+static uint64_t rdiv(uint64_t x, uint64_t d)
+{
+  return (2 * x + d) / (2 * d);
+}
+
+static uint32_t xorshift(void)
+{
+  static uint32_t s = 2463534242u;
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+int main(void)
+{
+  uint32_t e;
+
+  e = 0;
+  for (uint32_t x = 0; x <= 255 * 255; x++)
+    if (M::div255(x) != rdiv(x, 255))
+      e++;
+  report("div255", e);
+
+  uint32_t es = 0, ea = 0, eb = 0;
+  for (uint32_t i = 0; i < 256; i++)
+  {
+    for (uint32_t j = 0; j < 256; j++)
+    {
+      if (M::scale8(i, j) != rdiv(i * j, 255))
+        es++;
+      if (M::qadd8(i, j) != ((i + j > 255) ? 255 : i + j))
+        ea++;
+      if (M::qsub8(i, j) != ((i > j) ? i - j : 0))
+        eb++;
+    }
+  }
+  report("scale8", es);
+  report("qadd8", ea);
+  report("qsub8", eb);
+
+  e = 0;
+  for (uint32_t a = 0; a < 256; a++)
+    for (uint32_t b = 0; b < 256; b++)
+      for (uint32_t f = 0; f < 256; f++)
+        if (M::lerp8(a, b, f) != rdiv(a * (255 - f) + b * f, 255))
+          e++;
+  report("lerp8", e);
+
+  // Packed: each byte pair in each lane, random bytes elsewhere
+  ea = eb = 0;
+  uint32_t ec = 0, ed = 0, ee = 0, ef = 0;
+  for (uint32_t a = 0; a < 256; a++)
+  {
+    for (uint32_t b = 0; b < 256; b++)
+    {
+      for (uint8_t lane = 0; lane < 4; lane++)
+      {
+        uint32_t x = xorshift(), y = xorshift(), sh = lane * 8;
+        uint8_t alpha = xorshift();
+        uint16_t scale = xorshift() % 257;
+        x = (x & ~(0xFFu << sh)) | (a << sh);
+        y = (y & ~(0xFFu << sh)) | (b << sh);
+        uint32_t qa = M::qadd8x4(x, y), qs = M::qsub8x4(x, y), bl = M::blend(x, y, alpha),
+                 sc = M::scale8x4(x, alpha), mu = M::mul8x4(x, scale), av = M::avg8x4(x, y);
+        for (uint8_t k = 0; k < 32; k += 8)
+        {
+          uint8_t p = x >> k, q = y >> k;
+          if ((uint8_t)(qa >> k) != M::qadd8(p, q))
+            ea++;
+          if ((uint8_t)(qs >> k) != M::qsub8(p, q))
+            eb++;
+          if ((uint8_t)(bl >> k) != M::lerp8(p, q, alpha))
+            ec++;
+          if ((uint8_t)(sc >> k) != M::scale8(p, alpha))
+            ed++;
+          if ((uint8_t)(mu >> k) != ((p * scale) >> 8))
+            ee++;
+          if ((uint8_t)(av >> k) != ((p + q) >> 1))
+            ef++;
+        }
+      }
+    }
+  }
+  report("qadd8x4", ea);
+  report("qsub8x4", eb);
+  report("blend", ec);
+  report("scale8x4", ed);
+  report("mul8x4", ee);
+  report("avg8x4", ef);
+
+  e = 0;
+  static const uint16_t edges[] = {0, 1, 2, 255, 256, 32767, 32768, 65534, 65535};
+  for (uint8_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    for (uint8_t j = 0; j < sizeof(edges) / sizeof(edges[0]); j++)
+      for (uint8_t k = 0; k < sizeof(edges) / sizeof(edges[0]); k++)
+      {
+        uint64_t a = edges[i], b = edges[j], f = edges[k];
+        if (M::lerp16(a, b, f) != rdiv(a * (65535 - f) + b * f, 65535))
+          e++;
+      }
+  for (uint32_t n = 0; n < 50000000; n++)
+  {
+    uint64_t a = xorshift() & 0xFFFF, b = xorshift() & 0xFFFF, f = xorshift() & 0xFFFF;
+    if (M::lerp16(a, b, f) != rdiv(a * (65535 - f) + b * f, 65535))
+      e++;
+  }
+  report("lerp16", e);
+
+  // Pre-scaled packed colors
+  static const neoPixelType types[] = {NEO_RGB, NEO_GRB, NEO_BGR, NEO_WRGB, NEO_GRBW, NEO_RGBW,
+                                       NEO_BGRW
+#ifdef NEO_16BIT
+                                       ,
+                                       NEO_GRB + NEO_16BIT, NEO_RGBW + NEO_16BIT
+#endif
+  };
+  e = 0;
+  for (uint8_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+  {
+    for (uint16_t b = 0; b < 256; b++)
+    {
+      Adafruit_NeoPixel a(64, -1, types[t]), s(64, -1, types[t]);
+#ifdef NEO_16BIT
+      if ((types[t] & NEO_16BIT) && (b > 0))
+        break; // Brightness applies to 16-bit values there
+#endif
+      if (b)
+      {
+        a.setBrightness(b);
+        s.setBrightness(b);
+      }
+      for (uint16_t i = 0; i < 64; i++)
+      {
+        uint32_t c = xorshift();
+        a.setPixelColor(i, c);
+        s.setPixelColor(i, s.scaleColor(c), true);
+      }
+      uint16_t bytes = 64 * ((types[t] >> 6 & 3) == (types[t] >> 4 & 3) ? 3 : 4);
+#ifdef NEO_16BIT
+      if (types[t] & NEO_16BIT)
+        bytes *= 2;
+#endif
+      if (memcmp(a.getPixels(), s.getPixels(), bytes))
+        e++;
+    }
+  }
+  report("scaled", e);
+
+  printf("%s\n", failures ? "FAILED" : "all functions exact");
+  return failures ? 1 : 0;
+}
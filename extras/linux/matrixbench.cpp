@@ -0,0 +1,206 @@
+/*-------------------------------------------------------------------------
+  matrixbench: checks and times full-frame draws through NeoPixelMatrix
+  on 32x32 and 64x64 displays, each as one serpentine panel, as 8x8
+  serpentine panels tiled in rows, and as the panel rotated a quarter
+  turn.  The baseline is how our sketches drew before: XY() computed
+  with divisions for every pixel and passed to setPixelColor().  That
+  is timed against per-pixel drawPixel() (lookup table), a full-frame
+  RGB888 drawBitmap(), and fillRect() and fillScreen() of one color.
+
+  Every way of drawing must leave the same strip buffer: the table
+  must give the sketches' XY() for every layout, drawBitmap()
+  must match drawPixel() pixel for pixel, and fillRect() (whole frame
+  and assorted clipped rectangles) must match drawPixel() over the
+  same area.  Prints microseconds per frame.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o matrixbench \
+        extras/linux/matrixbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelMatrix.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelMatrix.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define SERPENTINE (NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG)
+#define TILED (SERPENTINE + NEO_TILE_TOP + NEO_TILE_LEFT + NEO_TILE_ROWS + NEO_TILE_PROGRESSIVE)
+#define PANEL 8          // Tile size for the tiled layout
+#define PIXELS_TIMED 4e6 // Pixels drawn per measurement
+
+static uint32_t failures;
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// XY() as our sketches computed it, for serpentine 'pw' x 'ph' panels
+// tiled in rows 'tw' panels across, optionally turned a quarter turn
+// clockwise (volatile so the compiler can't turn the divisions into
+// shifts, as it couldn't in a sketch either)
+static volatile uint16_t pw, ph, tw;
+static volatile uint8_t rot;
+
+static uint16_t sketchXY(uint16_t x, uint16_t y)
+{
+  if (rot)
+  {
+    uint16_t t = x;
+    x = pw * tw - 1 - y;
+    y = t;
+  }
+  uint16_t tile = (y / ph) * tw + x / pw, lx = x % pw, ly = y % ph;
+  if (ly & 1)
+    lx = pw - 1 - lx;
+  return tile * (pw * ph) + ly * pw + lx;
+}
+
+static uint32_t pattern(uint16_t x, uint16_t y)
+{
+  return ((uint32_t)(x * 7) << 16) | ((uint32_t)(y * 5) << 8) | (uint8_t)(x ^ y);
+}
+
+static void fail(const char *layout, uint16_t size, const char *what)
+{
+  printf("%s %ux%u: %s\n", layout, size, size, what);
+  failures++;
+}
+
+static void run(const char *layout, uint16_t size, bool tiled, uint8_t rotation)
+{
+  uint16_t n = size * size;
+  Adafruit_NeoPixel strip(n, -1, NEO_GRB), ref(n, -1, NEO_GRB);
+  NeoPixelMatrix *mp = tiled ? new NeoPixelMatrix(strip, PANEL, PANEL, size / PANEL,
+                                                  size / PANEL, TILED)
+                             : new NeoPixelMatrix(strip, size, size, SERPENTINE);
+  NeoPixelMatrix &m = *mp;
+  uint8_t *rgb = (uint8_t *)malloc(n * 3);
+  neoBitmap bmp = {rgb, NULL, size, size, NEO_BITMAP_RGB888};
+  int repeat = PIXELS_TIMED / n;
+  struct timespec t0, t1;
+  double us[5];
+  uint16_t x, y;
+
+  pw = tiled ? PANEL : size;
+  ph = tiled ? PANEL : size;
+  tw = size / pw;
+  rot = rotation;
+  m.setRotation(rotation);
+  for (y = 0; y < size; y++)
+  {
+    for (x = 0; x < size; x++)
+    {
+      uint32_t c = pattern(x, y);
+      uint8_t *p = &rgb[(y * size + x) * 3];
+      p[0] = c >> 16;
+      p[1] = c >> 8;
+      p[2] = c;
+    }
+  }
+
+  // Checks
+  for (y = 0; y < size; y++)
+    for (x = 0; x < size; x++)
+      if (m.XY(x, y) != sketchXY(x, y))
+        fail(layout, size, "XY() differs from the sketches'");
+  for (y = 0; y < size; y++)
+    for (x = 0; x < size; x++)
+      m.drawPixel(x, y, pattern(x, y));
+  memcpy(ref.getPixels(), strip.getPixels(), n * 3);
+  strip.clear();
+  m.drawBitmap(0, 0, bmp);
+  if (memcmp(ref.getPixels(), strip.getPixels(), n * 3))
+    fail(layout, size, "drawBitmap() differs from drawPixel()");
+  static const int16_t rects[][4] = {{0, 0, 9999, 9999}, {-3, -3, 7, 7}, {5, 3, 1, 20},
+                                     {4, 6, 20, 1},      {7, 1, 19, 13}, {20, 25, 50, 50}};
+  for (uint8_t r = 0; r < sizeof(rects) / sizeof(rects[0]); r++)
+  {
+    const int16_t *q = rects[r];
+    strip.clear();
+    ref.clear();
+    m.fillRect(q[0], q[1], q[2], q[3], 0x123456);
+    for (y = 0; y < size; y++)
+      for (x = 0; x < size; x++)
+        if ((x >= q[0]) && (x < q[0] + q[2]) && (y >= q[1]) && (y < q[1] + q[3]))
+          ref.setPixelColor(m.XY(x, y), 0x123456);
+    if (memcmp(ref.getPixels(), strip.getPixels(), n * 3))
+      fail(layout, size, "fillRect() differs from drawPixel()");
+  }
+  strip.clear();
+  m.fillScreen(0x123456);
+  ref.fill(0x123456);
+  if (memcmp(ref.getPixels(), strip.getPixels(), n * 3))
+    fail(layout, size, "fillScreen() doesn't fill every pixel");
+
+  // Timings
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < repeat; r++)
+    for (y = 0; y < size; y++)
+      for (x = 0; x < size; x++)
+        strip.setPixelColor(sketchXY(x, y), pattern(x, y + r));
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  us[0] = elapsed(t0, t1) / repeat / 1000;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < repeat; r++)
+    for (y = 0; y < size; y++)
+      for (x = 0; x < size; x++)
+        m.drawPixel(x, y, pattern(x, y + r));
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  us[1] = elapsed(t0, t1) / repeat / 1000;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < repeat; r++)
+  {
+    rgb[r % (n * 3)]++;
+    m.drawBitmap(0, 0, bmp);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  us[2] = elapsed(t0, t1) / repeat / 1000;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < repeat; r++)
+    m.fillRect(0, 0, size, size, r);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  us[3] = elapsed(t0, t1) / repeat / 1000;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int r = 0; r < repeat; r++)
+    m.fillScreen(r);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  us[4] = elapsed(t0, t1) / repeat / 1000;
+
+  printf("%-11s %ux%u  %9.1f  %9.1f  %10.1f  %8.1f  %10.1f\n", layout, size, size, us[0], us[1],
+         us[2], us[3], us[4]);
+  free(rgb);
+  delete mp;
+}
+
+int main(void)
+{
+  printf("us/frame:          sketch XY  drawPixel  drawBitmap  fillRect  fillScreen\n");
+  for (uint16_t size = 32; size <= 64; size *= 2)
+  {
+    run("serpentine", size, false, 0);
+    run("tiled 8x8", size, true, 0);
+    run("rotated", size, false, 1);
+  }
+  printf("%s\n", failures ? "FAILED" : "all draws match");
+  return failures ? 1 : 0;
+}
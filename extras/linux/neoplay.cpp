@@ -0,0 +1,288 @@
+/*-------------------------------------------------------------------------
+  neoplay: plays a file of raw frames (pixels * bpp bytes each, device
+  color order, e.g. a recording made with NeoPixelFileOutput) on a Linux
+  host.  The file is memory-mapped and the strip is pointed at each
+  frame in turn with setExternalBuffer(), so frame data is never copied
+  before the output backend reads it.  Files of any size are mapped a
+  window at a time, which also bounds resident memory.  Frames are paced
+  against absolute deadlines; a summary of achieved rate, late frames
+  and page faults is printed each second and at exit, so with -b
+  (unpaced) it doubles as a throughput benchmark.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o neoplay \
+        extras/linux/neoplay.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  Usage: neoplay [-4] [-b] [-l] [-r fps] [-s spidev | -o file] pixels show.raw
+
+  -4          4 bytes per pixel (RGBW); default is 3
+  -b          benchmark: no pacing
+  -l          loop the show
+  -r fps      frame rate (default 60)
+  -s spidev   output WS2812 data on an SPI device, e.g. /dev/spidev0.0
+  -o file     write frames to a file or FIFO (default /dev/null)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#define _FILE_OFFSET_BITS 64 // Multi-GB shows on 32-bit hosts
+
+#include "NeoPixelLinux.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAP_WINDOW (64UL << 20) // Bytes of show mapped at once
+
+static volatile sig_atomic_t stop = 0;
+
+static void onSignal(int)
+{
+  stop = 1;
+}
+
+static uint64_t nowNanos(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+typedef struct
+{
+  uint64_t frames, late, maxNanos;
+  long minflt, majflt;
+} stats;
+
+static void report(const char *label, const stats &s, uint64_t nanos, long minflt, long majflt)
+{
+  double secs = nanos / 1e9;
+  printf("%s: %llu frames in %.2f s = %.1f fps, %llu late, max frame %.3f ms, "
+         "page faults %ld minor / %ld major\n",
+         label, (unsigned long long)s.frames, secs, secs > 0 ? s.frames / secs : 0.0,
+         (unsigned long long)s.late, s.maxNanos / 1e6,
+         minflt - s.minflt, majflt - s.majflt);
+  fflush(stdout);
+}
+
+static void faults(long &minflt, long &majflt)
+{
+  struct rusage r;
+  getrusage(RUSAGE_SELF, &r);
+  minflt = r.ru_minflt;
+  majflt = r.ru_majflt;
+}
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: neoplay [-4] [-b] [-l] [-r fps] [-s spidev | -o file] pixels show.raw\n");
+  return 2;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned bpp = 3, fps = 60;
+  bool bench = false, loop = false;
+  const char *spidev = NULL, *outFile = "/dev/null";
+  int opt;
+
+  while ((opt = getopt(argc, argv, "4blr:s:o:")) != -1)
+  {
+    switch (opt)
+    {
+    case '4':
+      bpp = 4;
+      break;
+    case 'b':
+      bench = true;
+      break;
+    case 'l':
+      loop = true;
+      break;
+    case 'r':
+      fps = strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      spidev = optarg;
+      break;
+    case 'o':
+      outFile = optarg;
+      break;
+    default:
+      return usage();
+    }
+  }
+  if (((argc - optind) != 2) || !fps)
+    return usage();
+  unsigned long pixels = strtoul(argv[optind], NULL, 0);
+  size_t frameBytes = pixels * bpp;
+  if (!pixels || (frameBytes > 0xFFFF))
+  {
+    fprintf(stderr, "neoplay: frame must be 1-65535 bytes\n");
+    return 2;
+  }
+
+  int fd = open(argv[optind + 1], O_RDONLY);
+  struct stat st;
+  if ((fd < 0) || fstat(fd, &st))
+  {
+    perror(argv[optind + 1]);
+    return 1;
+  }
+  uint64_t numFrames = (uint64_t)st.st_size / frameBytes;
+  if (!numFrames)
+  {
+    fprintf(stderr, "neoplay: no complete frames\n");
+    return 1;
+  }
+
+  Adafruit_NeoPixel strip;
+  strip.updateType((bpp == 4) ? NEO_GRBW : NEO_GRB);
+  strip.updateLength(pixels);
+
+  NeoPixelSpiOutput spi(spidev ? spidev : "");
+  NeoPixelFileOutput *file = NULL;
+  int outFd = -1;
+  if (spidev)
+  {
+    strip.setOutput(&spi);
+  }
+  else
+  {
+    if ((outFd = open(outFile, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+      perror(outFile);
+      return 1;
+    }
+    file = new NeoPixelFileOutput(outFd);
+    strip.setOutput(file);
+  }
+  strip.begin();
+  if (spidev && !spi.isOpen())
+  {
+    perror(spidev);
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  // MAP_PRIVATE + PROT_WRITE: frames are read in place, but anything
+  // drawn onto the strip lands in a private copy, never in the file.
+  const size_t page = sysconf(_SC_PAGESIZE);
+  uint8_t *map = NULL;
+  off_t mapStart = 0;
+  size_t mapLen = 0;
+
+  const uint64_t period = bench ? 0 : 1000000000ULL / fps;
+  stats total = {0, 0, 0, 0, 0}, second;
+  long minflt, majflt;
+  faults(total.minflt, total.majflt);
+  second = total;
+  uint64_t start = nowNanos(), secStart = start, deadline = start;
+
+  for (uint64_t f = 0; !stop;)
+  {
+    off_t off = (off_t)(f * frameBytes);
+    if (!map || (off < mapStart) || ((off + (off_t)frameBytes) > (mapStart + (off_t)mapLen)))
+    { // Slide the window so it starts at this frame's page
+      if (map)
+        munmap(map, mapLen);
+      mapStart = off & ~(off_t)(page - 1);
+      mapLen = MAP_WINDOW;
+      if ((uint64_t)(mapStart + mapLen) > (uint64_t)st.st_size)
+        mapLen = st.st_size - mapStart;
+      map = (uint8_t *)mmap(NULL, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, mapStart);
+      if (map == MAP_FAILED)
+      {
+        perror("mmap");
+        return 1;
+      }
+      madvise(map, mapLen, MADV_SEQUENTIAL);
+      madvise(map, (mapLen < (4UL << 20)) ? mapLen : (4UL << 20), MADV_WILLNEED);
+    }
+
+    uint64_t t0 = nowNanos();
+    strip.setExternalBuffer(&map[off - mapStart]); // No copy
+    strip.show();
+    uint64_t t1 = nowNanos(), took = t1 - t0;
+    if (took > total.maxNanos)
+      total.maxNanos = took;
+    if (took > second.maxNanos)
+      second.maxNanos = took;
+    total.frames++;
+    second.frames++;
+
+    if (period)
+    {
+      deadline += period;
+      if (t1 > deadline)
+      { // Missed this deadline; resync rather than bursting to catch up
+        total.late++;
+        second.late++;
+        deadline = t1;
+      }
+      else
+      {
+        struct timespec ts = {(time_t)(deadline / 1000000000ULL),
+                              (long)(deadline % 1000000000ULL)};
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+      }
+    }
+
+    if ((t1 - secStart) >= 1000000000ULL)
+    {
+      faults(minflt, majflt);
+      report("1s", second, t1 - secStart, minflt, majflt);
+      second.frames = second.late = second.maxNanos = 0;
+      second.minflt = minflt;
+      second.majflt = majflt;
+      secStart = t1;
+    }
+
+    if (++f >= numFrames)
+    {
+      if (!loop)
+        break;
+      f = 0;
+    }
+  }
+
+  faults(minflt, majflt);
+  report("total", total, nowNanos() - start, minflt, majflt);
+  strip.setExternalBuffer(NULL); // Before the mapping goes away
+  if (map)
+    munmap(map, mapLen);
+  close(fd);
+  if (file)
+  {
+    if (file->getErrors())
+      fprintf(stderr, "neoplay: %u frames failed to write\n", file->getErrors());
+    delete file;
+    close(outFd);
+  }
+  if (spi.getErrors())
+    fprintf(stderr, "neoplay: %u frames failed to transfer\n", spi.getErrors());
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*-------------------------------------------------------------------------
+  readcheck: differential test of reading colors back from a strip.
+  getPixelColor() scales back with a multiply and shift (by a
+  reciprocal setBrightness() computes) where it used to divide each
+  channel by the brightness; getPixels() reads a run of pixels the
+  same way.  Both must return exactly what the division did, for every
+  stored byte value (including ones no brightness-scaled color could
+  leave there) at every brightness, for RGB, RGBW, RGBWW and NEO_16BIT
+  strips.  Then times reading a 1000-pixel strip all three ways.
+
+  The division was the costly part on AVR (no hardware divide: four
+  32-bit divisions per call); the timings here are only a host figure.
+
+  Build (from the library directory):
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o readcheck \
+        extras/linux/readcheck.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define PIXELS 256  // Pixels per checked strip: every byte value
+#define TIMED 1000  // Pixels per timed strip
+#define REPEAT 2000 // Reads of the timed strip per measurement
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// getPixelColor() as it was, dividing by the stored brightness 'b'
+// (setBrightness() value + 1, 0 = none)
+static uint32_t reference(const uint8_t *buf, const neoPixelFormat &f, uint8_t b, uint16_t n)
+{
+  uint8_t o[4] = {f.b, f.g, f.r, f.w}, i;
+  uint32_t c = 0;
+
+  if (f.depth == 16)
+  {
+    const uint8_t *p = &buf[n * f.channels * 2];
+    for (i = 0; i < ((f.channels >= 4) ? 4 : 3); i++)
+    {
+      uint32_t v = ((uint16_t)p[o[i] * 2] << 8) | p[o[i] * 2 + 1];
+      if (b)
+        v = (v << 8) / b;
+      c |= (v >> 8) << (i * 8);
+    }
+    return c;
+  }
+  const uint8_t *p = &buf[n * f.channels];
+  for (i = 0; i < ((f.channels >= 4) ? 4 : 3); i++)
+    c |= (b ? ((uint32_t)(p[o[i]] << 8) / b) : p[o[i]]) << (i * 8);
+  return c;
+}
+
+static uint32_t check(const neoPixelFormat &f)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, f);
+  uint8_t bpp = neoFormatBytes(f);
+  static uint32_t got[PIXELS];
+  uint32_t errors = 0;
+
+  for (uint16_t b = 0; b < 256; b++)
+  {
+    strip.setBrightness(b);
+    // Every byte value in every channel, set after setBrightness() so
+    // it isn't rescaled
+    uint8_t *buf = strip.getPixels();
+    for (uint16_t i = 0; i < bpp * PIXELS; i++)
+      buf[i] = (uint8_t)((i / bpp) * 151 + (i % bpp) * 17);
+    uint8_t stored = b + 1;
+    strip.getPixels(0, 0, got);
+    for (uint16_t n = 0; n < PIXELS; n++)
+    {
+      uint32_t ref = reference(buf, f, stored, n);
+      if ((strip.getPixelColor(n) != ref) || (got[n] != ref))
+        errors++;
+    }
+    // Short runs
+    strip.getPixels(5, 3, got);
+    for (uint16_t n = 0; n < 3; n++)
+      if (got[n] != reference(buf, f, stored, n + 5))
+        errors++;
+  }
+  return errors;
+}
+
+int main(void)
+{
+  static const struct
+  {
+    const char *name;
+    neoPixelFormat format;
+  } formats[] = {{"GRB", NEO_FORMAT_GRB},
+                 {"BGR", NEO_FORMAT_BGR},
+                 {"GRBW", NEO_FORMAT_GRBW},
+                 {"WRGB", NEO_FORMAT_WRGB},
+                 {"RGBWW", NEO_FORMAT_RGBWW},
+#ifdef NEO_16BIT
+                 {"GRB 16-bit", neoFormat(NEO_GRB + NEO_16BIT)},
+                 {"RGBW 16-bit", neoFormat(NEO_RGBW + NEO_16BIT)},
+#endif
+                };
+  uint32_t failed = 0;
+
+  for (uint8_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+  {
+    uint32_t e = check(formats[i].format);
+    if (e)
+      failed++;
+    printf("%-12s %s\n", formats[i].name, e ? "MISMATCH" : "ok");
+  }
+
+  printf("\n%u pixels, ns/pixel:  division  getPixelColor()  getPixels()\n", TIMED);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    const neoPixelFormat &f = formats[(i == 0) ? 0 : 2].format;
+    Adafruit_NeoPixel strip(TIMED, -1, f);
+    static uint32_t out[TIMED];
+    struct timespec t0, t1;
+    volatile uint32_t sink = 0;
+    uint8_t b = (i == 2) ? 255 : 100;
+
+    strip.fillRainbow(0, 0, 0, 300);
+    strip.setBrightness(b);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < REPEAT; r++)
+      for (uint16_t n = 0; n < TIMED; n++)
+        sink += reference(strip.getPixels(), f, b + 1, n);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double slow = elapsed(t0, t1) / REPEAT / TIMED;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < REPEAT; r++)
+      for (uint16_t n = 0; n < TIMED; n++)
+        sink += strip.getPixelColor(n);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double each = elapsed(t0, t1) / REPEAT / TIMED;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < REPEAT; r++)
+    {
+      strip.getPixels(0, 0, out);
+      sink += out[r % TIMED];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double bulk = elapsed(t0, t1) / REPEAT / TIMED;
+    printf("%-4s brightness %-3u  %9.2f  %15.2f  %11.2f\n", (i == 0) ? "GRB" : "GRBW", b, slow,
+           each, bulk);
+  }
+
+  printf("%s\n", failed ? "FAILED" : "all reads match division");
+  return failed ? 1 : 0;
+}
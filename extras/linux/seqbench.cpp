@@ -0,0 +1,224 @@
+/*-------------------------------------------------------------------------
+  seqbench: round trip and decode benchmark for NeoPixelSequence.
+  Several 300-frame shows for a 1000-pixel strip are drawn with the
+  library and dumped raw: a moving rainbow (every pixel changes every
+  frame), a theater chase, a color wipe, a whole-strip fade and random
+  noise (incompressible), plus the rainbow on an RGBW strip.  Each dump
+  is encoded with neoseq_encode and played back from RAM with
+  nextFrame(); every decoded frame must match its dump, with and
+  without strip brightness.  Then prints each show's compression and
+  the decode time per frame (mean and worst) against the 16.7 ms a
+  frame gets at 60 fps.
+
+  Times are for this host only.  Decode time on an ESP8266 (or from
+  its flash, where begin_P() data lives) has to be measured there.
+
+  Build (from the library directory), encoder first:
+    cc -O2 -o neoseq_encode extras/neoseq_encode.c
+    g++ -O2 -DARDUINO=100 -Iextras/linux -I. -o seqbench \
+        extras/linux/seqbench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp NeoPixelSequence.cpp
+
+  Usage: seqbench [encoder]   (default ./neoseq_encode)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+#include "NeoPixelSequence.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PIXELS 1000
+#define FRAMES 300
+#define PASSES 20  // Timed plays of each show
+#define BUDGET 16667 // Microseconds per frame at 60 fps
+
+enum
+{
+  RAINBOW,
+  CHASE,
+  WIPE,
+  FADE,
+  NOISE
+};
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+static uint32_t xorshift(void)
+{
+  static uint32_t s = 2463534242u;
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+// Draw frame 'f' of 'show'
+static void draw(Adafruit_NeoPixel &strip, uint8_t show, uint16_t f)
+{
+  switch (show)
+  {
+  case RAINBOW:
+    strip.fillRainbow(0, 0, f * 256, 65536 / PIXELS);
+    break;
+  case CHASE:
+    strip.fill(0x000010);
+    for (uint16_t i = f % 3; i < PIXELS; i += 3)
+      strip.setPixelColor(i, 0xFF8000);
+    break;
+  case WIPE:
+    strip.clear();
+    strip.fill(0x00FF40, 0, (f * 4 < PIXELS) ? f * 4 + 4 : PIXELS);
+    break;
+  case FADE:
+    strip.fill(strip.Color(f * 255 / FRAMES, 0, 255 - f * 255 / FRAMES));
+    break;
+  default:
+    for (uint16_t i = 0; i < PIXELS; i++)
+      strip.setPixelColor(i, xorshift());
+    break;
+  }
+}
+
+// Dump 'show' raw, encode it and read the result into '*seq'; returns
+// its size, or 0 on failure
+static uint32_t encode(const char *encoder, uint8_t show, neoPixelType t, uint8_t **seq,
+                       uint8_t **raw)
+{
+  Adafruit_NeoPixel strip(PIXELS, -1, t);
+  uint8_t bpp = ((t >> 6 & 3) == (t >> 4 & 3)) ? 3 : 4;
+  char in[] = "/tmp/seqbenchXXXXXX", out[sizeof(in) + 4], cmd[256];
+  int fd = mkstemp(in);
+  uint32_t size = 0;
+
+  if (fd < 0)
+    return 0;
+  *raw = (uint8_t *)malloc((size_t)FRAMES * PIXELS * bpp);
+  for (uint16_t f = 0; f < FRAMES; f++)
+  {
+    draw(strip, show, f);
+    memcpy(&(*raw)[(size_t)f * PIXELS * bpp], strip.getPixels(), PIXELS * bpp);
+  }
+  if (write(fd, *raw, (size_t)FRAMES * PIXELS * bpp) == (ssize_t)FRAMES * PIXELS * bpp)
+  {
+    snprintf(out, sizeof(out), "%s.seq", in);
+    snprintf(cmd, sizeof(cmd), "%s %s %u %u %s %s 2>/dev/null", encoder,
+             (bpp == 4) ? "-4" : "", PIXELS, BUDGET, in, out);
+    FILE *f;
+    if (!system(cmd) && (f = fopen(out, "rb")))
+    {
+      fseek(f, 0, SEEK_END);
+      size = ftell(f);
+      rewind(f);
+      *seq = (uint8_t *)malloc(size);
+      if (fread(*seq, 1, size, f) != size)
+        size = 0;
+      fclose(f);
+    }
+    unlink(out);
+  }
+  close(fd);
+  unlink(in);
+  return size;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *encoder = (argc > 1) ? argv[1] : "./neoseq_encode";
+  static const struct
+  {
+    const char *name;
+    uint8_t show;
+    neoPixelType type;
+  } shows[] = {{"rainbow", RAINBOW, NEO_GRB}, {"chase", CHASE, NEO_GRB},
+               {"wipe", WIPE, NEO_GRB},       {"fade", FADE, NEO_GRB},
+               {"noise", NOISE, NEO_GRB},     {"rainbow RGBW", RAINBOW, NEO_GRBW}};
+  uint32_t failed = 0;
+
+  printf("%u pixels, %u frames:  encoded    ratio  us/frame: mean     worst  frames/s\n",
+         PIXELS, FRAMES);
+  for (uint8_t s = 0; s < sizeof(shows) / sizeof(shows[0]); s++)
+  {
+    neoPixelType t = shows[s].type;
+    uint8_t bpp = ((t >> 6 & 3) == (t >> 4 & 3)) ? 3 : 4, *seq = NULL, *raw = NULL;
+    uint32_t size = encode(encoder, shows[s].show, t, &seq, &raw);
+    if (!size)
+    {
+      fprintf(stderr, "Couldn't encode with %s (see the build lines)\n", encoder);
+      return 1;
+    }
+
+    for (uint8_t b = 0; b < 2; b++)
+    {
+      Adafruit_NeoPixel strip(PIXELS, -1, t);
+      NeoPixelSequence player(strip);
+      uint8_t brightness = b ? 100 : 0;
+      bool bad = false;
+      double total = 0, worst = 0;
+      struct timespec t0, t1;
+
+      if (brightness)
+        strip.setBrightness(brightness);
+      for (uint8_t p = 0; p < PASSES; p++)
+      {
+        if (!player.begin(seq, size))
+          bad = true;
+        for (uint16_t f = 0; (f < FRAMES) && !bad; f++)
+        {
+          clock_gettime(CLOCK_MONOTONIC, &t0);
+          if (!player.nextFrame())
+            bad = true;
+          clock_gettime(CLOCK_MONOTONIC, &t1);
+          double ns = elapsed(t0, t1);
+          total += ns;
+          if (ns > worst)
+            worst = ns;
+          if (!p)
+          { // Check every frame on the first pass
+            const uint8_t *want = &raw[(size_t)f * PIXELS * bpp], *got = strip.getPixels();
+            for (uint32_t i = 0; (i < PIXELS * bpp) && !bad; i++)
+              if (got[i] != (brightness ? ((want[i] * (brightness + 1)) >> 8) : want[i]))
+                bad = true;
+          }
+        }
+      }
+      if (bad)
+        failed++;
+      double mean = total / PASSES / FRAMES / 1000;
+      char name[32];
+      snprintf(name, sizeof(name), "%s%s", shows[s].name, brightness ? ", brightness" : "");
+      printf("%-24s %8u  %5.1f:1  %8.1f  %8.1f  %7.0fk%s\n", name, size,
+             (double)FRAMES * PIXELS * bpp / size, mean, worst / 1000, 1e3 / mean,
+             bad ? "  MISMATCH" : "");
+      if (worst / 1000 > BUDGET)
+        printf("  worst frame over the 60 fps budget\n");
+    }
+    free(seq);
+    free(raw);
+  }
+
+  printf("%s\n", failed ? "FAILED" : "all frames decoded exactly");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/*-------------------------------------------------------------------------
+  swizzlebench: checks and times Adafruit_NeoPixel::setPixels(), the
+  bulk copy from R,G,B(,W) arrays into a strip's buffer, for each of
+  the 30 NEO_* color orders.  For RGB and RGBW source arrays, with and
+  without brightness, the buffer must match the one setPixelColor()
+  builds pixel by pixel (also checked on short runs, so vector kernel
+  tails are covered).  RGB arrays into RGBW strips are also run with
+  NEO_WHITE_ACCURATE white extraction, neutral and warm.  Prints
+  nanoseconds per pixel for both, and the speedup.
+
+  setPixels() uses pshufb if built with SSSE3 (as below), a 32-bit
+  word kernel if not (drop -mssse3 to time that one instead), and NEON
+  on 64-bit ARM.
+
+  Build (from the library directory):
+    g++ -O2 -mssse3 -DARDUINO=100 -Iextras/linux -I. -o swizzlebench \
+        extras/linux/swizzlebench.cpp extras/linux/NeoPixelLinux.cpp \
+        Adafruit_NeoPixel.cpp
+
+  Usage: swizzlebench [pixels]   (default 1000)
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "NeoPixelLinux.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define REPEAT 2000 // Frames timed per measurement
+
+static const struct
+{
+  neoPixelType type;
+  const char *name;
+} orders[] = {
+    {NEO_RGB, "RGB"}, {NEO_RBG, "RBG"}, {NEO_GRB, "GRB"}, {NEO_GBR, "GBR"}, {NEO_BRG, "BRG"}, {NEO_BGR, "BGR"}, {NEO_WRGB, "WRGB"}, {NEO_WRBG, "WRBG"}, {NEO_WGRB, "WGRB"}, {NEO_WGBR, "WGBR"}, {NEO_WBRG, "WBRG"}, {NEO_WBGR, "WBGR"}, {NEO_RWGB, "RWGB"}, {NEO_RWBG, "RWBG"}, {NEO_RGWB, "RGWB"}, {NEO_RGBW, "RGBW"}, {NEO_RBWG, "RBWG"}, {NEO_RBGW, "RBGW"}, {NEO_GWRB, "GWRB"}, {NEO_GWBR, "GWBR"}, {NEO_GRWB, "GRWB"}, {NEO_GRBW, "GRBW"}, {NEO_GBWR, "GBWR"}, {NEO_GBRW, "GBRW"}, {NEO_BWRG, "BWRG"}, {NEO_BWGR, "BWGR"}, {NEO_BRWG, "BRWG"}, {NEO_BRGW, "BRGW"}, {NEO_BGWR, "BGWR"}, {NEO_BGRW, "BGRW"}};
+
+static double elapsed(const struct timespec &t0, const struct timespec &t1)
+{
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+static void perPixel(Adafruit_NeoPixel &strip, const uint8_t *src, uint8_t sb, uint16_t first, uint16_t n)
+{
+  for (uint16_t i = 0; i < n; i++, src += sb)
+  {
+    if (sb == 4)
+      strip.setPixelColor(first + i, src[0], src[1], src[2], src[3]);
+    else
+      strip.setPixelColor(first + i, src[0], src[1], src[2]);
+  }
+}
+
+// setPixels() must match setPixelColor() for every run in [0, n)
+// starting at a few offsets and lengths.
+static uint32_t check(neoPixelType t, uint8_t sb, uint8_t brightness, uint32_t white,
+                      const uint8_t *src, uint16_t n)
+{
+  Adafruit_NeoPixel a(n, -1, t), b(n, -1, t);
+  static const uint16_t firsts[] = {0, 1, 5, 17}, counts[] = {1, 5, 6, 7, 11, 33, 0};
+  uint32_t errors = 0;
+
+  if (brightness)
+  {
+    a.setBrightness(brightness);
+    b.setBrightness(brightness);
+  }
+  if (white)
+  {
+    a.setWhiteExtraction(NEO_WHITE_ACCURATE, white);
+    b.setWhiteExtraction(NEO_WHITE_ACCURATE, white);
+  }
+  for (uint8_t f = 0; f < sizeof(firsts) / sizeof(firsts[0]); f++)
+  {
+    for (uint8_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+      uint16_t first = firsts[f], count = counts[c];
+      if (first >= n)
+        continue;
+      if (!count || (count > (n - first)))
+        count = n - first;
+      a.fill(0x5A5A5A5A);
+      b.fill(0x5A5A5A5A);
+      a.setPixels(first, counts[c], src, sb);
+      perPixel(b, src, sb, first, count);
+      if (memcmp(a.getPixels(), b.getPixels(), n * ((t >> 6 & 3) == (t >> 4 & 3) ? 3 : 4)))
+        errors++;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char *argv[])
+{
+  uint16_t n = (argc > 1) ? atoi(argv[1]) : 1000;
+  uint8_t *src = (uint8_t *)malloc(n * 4);
+  uint32_t failed = 0;
+  struct timespec t0, t1;
+
+  if (!src || (n < 40))
+  {
+    fprintf(stderr, "Usage: %s [pixels]  (40-65535)\n", argv[0]);
+    return 1;
+  }
+  for (uint32_t i = 0; i < n * 4u; i++)
+    src[i] = (uint8_t)(i * 151 + (i >> 8));
+
+  printf("%u pixels, ns/pixel:            setPixelColor()  setPixels()  speedup\n", n);
+  for (uint8_t o = 0; o < sizeof(orders) / sizeof(orders[0]); o++)
+  {
+    bool rgbw = (orders[o].type >> 6 & 3) != (orders[o].type >> 4 & 3);
+    for (uint8_t sb = 3; sb <= 4; sb++)
+    {
+      for (uint8_t b = 0; b < ((rgbw && (sb == 3)) ? 4 : 2); b++)
+      {
+        static const uint32_t whites[] = {0, 0, 0xFFFFFF, 0xFFC48C};
+        static const char *names[] = {"", ", brightness", ", white", ", warm white"};
+        uint8_t brightness = (b == 1) ? 128 : 0;
+        uint32_t e = check(orders[o].type, sb, brightness, whites[b], src, n);
+        if (e)
+          failed++;
+
+        Adafruit_NeoPixel strip(n, -1, orders[o].type);
+        if (brightness)
+          strip.setBrightness(brightness);
+        if (whites[b])
+          strip.setWhiteExtraction(NEO_WHITE_ACCURATE, whites[b]);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int r = 0; r < REPEAT; r++)
+          perPixel(strip, src, sb, 0, n);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double slow = elapsed(t0, t1) / REPEAT / n;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int r = 0; r < REPEAT; r++)
+          strip.setPixels(0, n, src, sb);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double fast = elapsed(t0, t1) / REPEAT / n;
+        printf("%-4s from %s%-13s %8.2f  %11.2f  %6.1fx%s\n", orders[o].name,
+               (sb == 4) ? "RGBW" : "RGB ", names[b], slow, fast,
+               slow / fast, e ? "  MISMATCH" : "");
+      }
+    }
+  }
+  free(src);
+  printf("%s\n", failed ? "FAILED" : "all orders match setPixelColor()");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/*-------------------------------------------------------------------------
+  Host-side encoder for NeoPixelSequence.  Converts a file of raw frames
+  (each pixels * bpp bytes in device color order, e.g. dumps of
+  getPixels()) into the run-length / delta encoded format described in
+  NeoPixelSequence.h.
+
+  Build:  cc -O2 -o neoseq_encode neoseq_encode.c
+  Usage:  neoseq_encode [-4] [-c name] pixels interval_us in.raw out
+
+  -4       4 bytes per pixel (RGBW); default is 3
+  -c name  write a C header holding a PROGMEM array 'name' (for
+           NeoPixelSequence::begin_P()) instead of a binary file
+
+  -------------------------------------------------------------------------
+  This file is part of the Adafruit NeoPixel library.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Must match NeoPixelSequence.h
+#define NEOSEQ_VERSION 1
+#define NEOSEQ_SKIP 0x00
+#define NEOSEQ_RUN 0x40
+#define NEOSEQ_LITERAL 0x80
+#define NEOSEQ_END 0xC0
+
+static unsigned char *out;
+static size_t outLen, outCap;
+
+static void put(unsigned char c)
+{
+  if (outLen == outCap)
+  {
+    outCap = outCap ? outCap * 2 : 65536;
+    if (!(out = realloc(out, outCap)))
+    {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  out[outLen++] = c;
+}
+
+static void put32(uint32_t v)
+{
+  put(v);
+  put(v >> 8);
+  put(v >> 16);
+  put(v >> 24);
+}
+
+static void putOp(unsigned char op, unsigned n)
+{
+  if (n <= 0x3F)
+  {
+    put(op | n);
+  }
+  else
+  {
+    put(op);
+    put(n);
+    put(n >> 8);
+  }
+}
+
+// Encode frame 'cur' against 'prev', greedily: unchanged pixels become
+// SKIPs, two or more equal pixels become a RUN, anything else is
+// gathered into a LITERAL.  Trailing unchanged pixels need no op.
+static void encodeFrame(const unsigned char *prev, const unsigned char *cur,
+                        unsigned pixels, unsigned bpp)
+{
+  unsigned i = 0, j, last;
+
+  // Last changed pixel + 1
+  for (last = pixels; last && !memcmp(&prev[(last - 1) * bpp], &cur[(last - 1) * bpp], bpp); last--)
+    ;
+  while (i < last)
+  {
+    const unsigned char *p = &cur[i * bpp];
+    if (!memcmp(&prev[i * bpp], p, bpp))
+    {
+      for (j = i + 1; (j < last) && ((j - i) < 0xFFFF) &&
+                      !memcmp(&prev[j * bpp], &cur[j * bpp], bpp);
+           j++)
+        ;
+      putOp(NEOSEQ_SKIP, j - i);
+    }
+    else
+    {
+      for (j = i + 1; (j < last) && ((j - i) < 0xFFFF) && !memcmp(&cur[j * bpp], p, bpp); j++)
+        ;
+      if ((j - i) >= 2)
+      {
+        putOp(NEOSEQ_RUN, j - i);
+        for (unsigned k = 0; k < bpp; k++)
+          put(p[k]);
+      }
+      else
+      {
+        // Literal ends at an unchanged pixel or the start of a run
+        for (j = i + 1; (j < last) && ((j - i) < 0xFFFF); j++)
+        {
+          if (!memcmp(&prev[j * bpp], &cur[j * bpp], bpp))
+            break;
+          if (((j + 1) < last) && !memcmp(&cur[j * bpp], &cur[(j + 1) * bpp], bpp))
+            break;
+        }
+        putOp(NEOSEQ_LITERAL, j - i);
+        for (unsigned k = i * bpp; k < j * bpp; k++)
+          put(cur[k]);
+      }
+    }
+    i = j;
+  }
+  put(NEOSEQ_END);
+}
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: neoseq_encode [-4] [-c name] pixels interval_us in.raw out\n");
+  return 2;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned bpp = 3, pixels, interval;
+  const char *name = NULL;
+  int a = 1;
+
+  for (; (a < argc) && (argv[a][0] == '-'); a++)
+  {
+    if (!strcmp(argv[a], "-4"))
+      bpp = 4;
+    else if (!strcmp(argv[a], "-c") && ((a + 1) < argc))
+      name = argv[++a];
+    else
+      return usage();
+  }
+  if ((argc - a) != 4)
+    return usage();
+  pixels = strtoul(argv[a], NULL, 0);
+  interval = strtoul(argv[a + 1], NULL, 0);
+  if (!pixels || (pixels > 0xFFFF))
+  {
+    fprintf(stderr, "neoseq_encode: pixels must be 1-65535\n");
+    return 2;
+  }
+
+  FILE *in = fopen(argv[a + 2], "rb");
+  if (!in)
+  {
+    perror(argv[a + 2]);
+    return 1;
+  }
+  size_t frameBytes = (size_t)pixels * bpp;
+  unsigned char *prev = calloc(1, frameBytes), *cur = malloc(frameBytes);
+  if (!prev || !cur)
+  {
+    perror("malloc");
+    return 1;
+  }
+
+  put('N');
+  put('P');
+  put('S');
+  put('Q');
+  put(NEOSEQ_VERSION);
+  put(bpp);
+  put(pixels);
+  put(pixels >> 8);
+  put32(0); // Frame count, patched below
+  put32(interval);
+
+  uint32_t frames = 0;
+  size_t got;
+  while ((got = fread(cur, 1, frameBytes, in)) == frameBytes)
+  {
+    encodeFrame(prev, cur, pixels, bpp);
+    memcpy(prev, cur, frameBytes);
+    frames++;
+  }
+  if (got)
+    fprintf(stderr, "neoseq_encode: ignoring %zu trailing bytes\n", got);
+  fclose(in);
+  out[8] = frames;
+  out[9] = frames >> 8;
+  out[10] = frames >> 16;
+  out[11] = frames >> 24;
+
+  FILE *f = fopen(argv[a + 3], name ? "w" : "wb");
+  if (!f)
+  {
+    perror(argv[a + 3]);
+    return 1;
+  }
+  if (name)
+  {
+    fprintf(f, "// %u frames of %u pixels, generated by neoseq_encode\n", frames, pixels);
+    fprintf(f, "const uint8_t %s[] PROGMEM = {", name);
+    for (size_t i = 0; i < outLen; i++)
+      fprintf(f, "%s0x%02X,", (i % 16) ? " " : "\n  ", out[i]);
+    fprintf(f, "\n};\n");
+  }
+  else
+  {
+    fwrite(out, 1, outLen, f);
+  }
+  if (fclose(f))
+  {
+    perror(argv[a + 3]);
+    return 1;
+  }
+  fprintf(stderr, "%u frames, %zu bytes raw, %zu encoded\n",
+          frames, (size_t)frames * frameBytes, outLen);
+  return 0;
+}
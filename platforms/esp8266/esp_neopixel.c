@@ -15,8 +15,11 @@ static inline uint32_t _getCycleCount(void)
   return ccount;
 }
 
-void espShow(
-    uint8_t pin, uint8_t *pixels, uint32_t numBytes, boolean is800KHz)
+// Returns the number of times the frame was restarted because an
+// interrupt window overran (see Adafruit_NeoPixel__setInterruptWindow_b_g).
+uint8_t espShow(
+    uint8_t pin, uint8_t *pixels, uint32_t numBytes, boolean is800KHz,
+    uint16_t windowBytes, uint8_t windowGap)
 {
 
 #define CYCLES_800_T0H (F_CPU / 2500000) // 0.4us
@@ -25,9 +28,11 @@ void espShow(
 #define CYCLES_400_T0H (F_CPU / 2000000) // 0.5uS
 #define CYCLES_400_T1H (F_CPU / 833333)  // 1.2us
 #define CYCLES_400 (F_CPU / 400000)      // 2.5us per bit
+#define CYCLES_LATCH (F_CPU / 20000)     // 50us
 
-  uint8_t *p, *end, pix, mask;
-  uint32_t t, time0, time1, period, c, startTime, pinMask;
+  uint8_t *p, *end, pix, mask, restarts = 0;
+  uint16_t chunk = windowBytes;
+  uint32_t t, time0, time1, period, limit, c, startTime, pinMask;
 
   pinMask = _BV(pin);
   p = pixels;
@@ -52,6 +57,7 @@ void espShow(
     period = CYCLES_400;
   }
 #endif
+  limit = period + windowGap * (F_CPU / 1000000);
 
   for (t = time0;; t = time0)
   {
@@ -68,12 +74,31 @@ void espShow(
     { // Next bit/byte
       if (p >= end)
         break;
+      if (chunk && !--chunk)
+      { // Interrupt window
+        while ((_getCycleCount() - startTime) < period)
+          ; // Finish last bit
+        interrupts(); // Let pending ISRs run
+        noInterrupts();
+        if ((_getCycleCount() - startTime) > limit)
+        { // Overran the gap, strip latched a partial frame
+          interrupts();
+          while ((_getCycleCount() - startTime) < CYCLES_LATCH)
+            ;
+          noInterrupts();
+          p = pixels; // Resend frame
+          if (++restarts >= NEO_MAX_RESTARTS)
+            windowBytes = 0;
+        }
+        chunk = windowBytes;
+      }
       pix = *p++;
       mask = 0x80;
     }
   }
   while ((_getCycleCount() - startTime) < period)
     ; // Wait for last bit
+  return restarts;
 }
 
 void Adafruit_NeoPixel__show(Adafruit_NeoPixel *this)
@@ -113,7 +138,9 @@ void Adafruit_NeoPixel__show(Adafruit_NeoPixel *this)
 
   // ESP8266 show() is external to enforce ICACHE_RAM_ATTR execution
   this->showing = true;
-  espShow(this->pin, this->pixels, this->numBytes, this->is800KHz);
+  this->showRestarts += espShow(this->pin, this->pixels, this->numBytes,
+                                this->is800KHz, this->windowBytes,
+                                this->windowGap);
   this->showing = false;
 
   // END ARCHITECTURE SELECT ------------------------------------------------
@@ -121,6 +148,7 @@ void Adafruit_NeoPixel__show(Adafruit_NeoPixel *this)
   interrupts();
 
   this->endTime = micros(); // Save EOD time for latch on next call
+  this->showCount++;
 }
 
 inline bool Adafruit_NeoPixel____inline__canShow(Adafruit_NeoPixel *this)